@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include "structures\AtomicBitmask.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   struct RefCount : std::integral_constant<size_t, 20> {};
+   struct Generation : std::integral_constant<size_t, 12> {};
+   struct Flags : std::integral_constant<size_t, 32> {};
+
+   using State_t = mdv::NamedBitmask<RefCount, Generation, Flags>;
+
+   constexpr size_t OpsPerThread = 200000;
+
+   //! \brief Runs func(OpsPerThread) on the given number of threads and returns the wall clock time per operation
+   //!        over all threads
+   template<typename Func>
+   double MeasureThreads(size_t threadCount, Func func)
+   {
+      return MeasureNsPerOp(1, threadCount * OpsPerThread, [&]() {
+         std::vector<std::thread> threads;
+         for (size_t i = 0; i < threadCount; ++i)
+         {
+            threads.emplace_back(func);
+         }
+         for (auto& thread : threads)
+         {
+            thread.join();
+         }
+      });
+   }
+
+}
+
+//! \brief Increments the refcount of a shared state word from several threads at once, protected by a mutex and
+//!        with the atomic bitmask. RefCount is updated with a CAS loop, Flags is the top section and uses fetch_add
+BENCHMARK(AtomicBitmaskContention)
+{
+   const size_t maxThreads = (std::max)(2u, std::thread::hardware_concurrency());
+   for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+   {
+      const auto suffix = " (" + std::to_string(threads) + " threads)";
+
+      std::mutex mutex;
+      State_t locked;
+      Report("Mutex + NamedBitmask" + suffix, MeasureThreads(threads, [&]() {
+         for (size_t i = 0; i < OpsPerThread; ++i)
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.Set<RefCount>(locked.Get<RefCount>() + 1);
+         }
+      }));
+
+      mdv::AtomicNamedBitmask<RefCount, Generation, Flags> shared;
+      Report("FetchAdd<RefCount> (CAS loop)" + suffix, MeasureThreads(threads, [&]() {
+         for (size_t i = 0; i < OpsPerThread; ++i)
+         {
+            shared.FetchAdd<RefCount>(1);
+         }
+      }));
+      Report("FetchAdd<Flags> (fetch_add)" + suffix, MeasureThreads(threads, [&]() {
+         for (size_t i = 0; i < OpsPerThread; ++i)
+         {
+            shared.FetchAdd<Flags>(1);
+         }
+      }));
+      Report("Modify<RefCount, Generation>" + suffix, MeasureThreads(threads, [&]() {
+         for (size_t i = 0; i < OpsPerThread; ++i)
+         {
+            shared.Modify<RefCount, Generation>([](uint32_t& refCount, uint16_t& generation) {
+               ++refCount;
+               ++generation;
+            });
+         }
+      }));
+      DoNotOptimize(locked);
+      DoNotOptimize(shared.Load<RefCount>());
+   }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace mortanodevhelperbenchmark
+{
+
+   //! \brief A single benchmark that was registered using the BENCHMARK macro
+   struct BenchmarkEntry
+   {
+      const char* name;
+      void(*func)();
+   };
+
+   //! \brief All registered benchmarks in registration order
+   inline std::vector<BenchmarkEntry>& Registry()
+   {
+      static std::vector<BenchmarkEntry> registry;
+      return registry;
+   }
+
+   //! \brief Helper that registers a benchmark during static initialization
+   struct Registrar
+   {
+      Registrar(const char* name, void(*func)())
+      {
+         Registry().push_back({ name, func });
+      }
+   };
+
+   //! \brief Forces the compiler to materialize the given value, so that the computation that produced it can't be
+   //!        optimized away. The address of the value escapes into code the compiler can't see through, which
+   //!        may read and write any memory
+   template<typename T>
+   inline void DoNotOptimize(const T& value)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "g"(&value) : "memory");
+#else
+      static const volatile void* volatile sink;
+      sink = &value;
+      _ReadWriteBarrier();
+#endif
+   }
+
+   //! \brief Measures the average time of a single operation in nanoseconds. func is called 'iterations' times and
+   //!        is expected to perform 'opsPerIteration' operations per call. The measurement is repeated a couple of
+   //!        times and the best run is reported to filter out noise
+   template<typename Func>
+   double MeasureNsPerOp(size_t iterations, size_t opsPerIteration, Func&& func)
+   {
+      constexpr size_t Repetitions = 5;
+      using Clock_t = std::chrono::high_resolution_clock;
+
+      //Warmup
+      func();
+
+      auto best = std::numeric_limits<double>::max();
+      for (size_t rep = 0; rep < Repetitions; ++rep)
+      {
+         const auto start = Clock_t::now();
+         for (size_t iteration = 0; iteration < iterations; ++iteration)
+         {
+            func();
+         }
+         const auto end = Clock_t::now();
+         const auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+         best = (std::min)(best, ns / static_cast<double>(iterations * opsPerIteration));
+      }
+      return best;
+   }
+
+   //! \brief Prints a single result line
+   inline void Report(const std::string& name, double nsPerOp)
+   {
+      std::printf("  %-56s %10.3f ns/op\n", name.c_str(), nsPerOp);
+   }
+
+}
+
+//! \brief Defines and registers a benchmark function with the given name
+#define BENCHMARK(Name) \
+   static void Name(); \
+   static ::mortanodevhelperbenchmark::Registrar Name##_Registrar(#Name, &Name); \
+   static void Name()
@@ -0,0 +1,321 @@
+#include "Benchmark.h"
+
+#include "structures\BitmaskArithmetic.h"
+#include "structures\BitmaskArrayFile.h"
+#include "structures\BitmaskArrayColumns.h"
+#include "structures\BitmaskBulk.h"
+#include "structures\BitmaskSort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   using Mask_t = mdv::Bitmask<5, 10, 17>;
+
+   std::vector<Mask_t> MakeMasks(size_t count)
+   {
+      std::vector<Mask_t> masks(count);
+      uint32_t state = 1;
+      for (auto& mask : masks)
+      {
+         state = state * 1664525u + 1013904223u;
+         mask.Set<0>(static_cast<uint8_t>(state >> 3));
+         mask.Set<1>(static_cast<uint16_t>(state >> 8));
+         mask.Set<2>(state >> 15);
+      }
+      return masks;
+   }
+
+   const char* KernelName()
+   {
+      const auto& cpu = mdv::GetCpuFeatures();
+      return cpu.avx2 ? "AVX2" : cpu.sse2 ? "SSE2" : "scalar";
+   }
+
+   //! \brief Compares extracting and packing whole columns of bitmask sections with the scalar Get/Set loops
+   void MeasureBulk(size_t count, size_t iterations)
+   {
+      const auto masks = MakeMasks(count);
+      std::vector<uint32_t> column32(count);
+      std::vector<uint16_t> column16(count);
+
+      Report("Scalar Get<2> loop (uint32_t)", MeasureNsPerOp(iterations, count, [&]() {
+         for (size_t i = 0; i < count; ++i)
+         {
+            column32[i] = masks[i].Get<2>();
+         }
+         DoNotOptimize(column32.back());
+      }));
+      Report("ExtractSection<2> (uint32_t)", MeasureNsPerOp(iterations, count, [&]() {
+         mdv::ExtractSection<2>(masks.data(), count, column32.data());
+         DoNotOptimize(column32.back());
+      }));
+
+      Report("Scalar Get<1> loop (uint16_t)", MeasureNsPerOp(iterations, count, [&]() {
+         for (size_t i = 0; i < count; ++i)
+         {
+            column16[i] = masks[i].Get<1>();
+         }
+         DoNotOptimize(column16.back());
+      }));
+      Report("ExtractSection<1> (uint16_t)", MeasureNsPerOp(iterations, count, [&]() {
+         mdv::ExtractSection<1>(masks.data(), count, column16.data());
+         DoNotOptimize(column16.back());
+      }));
+
+      std::vector<uint8_t> first(count);
+      std::vector<uint16_t> second(count);
+      std::vector<uint32_t> third(count);
+      mdv::ExtractSection<0>(masks.data(), count, first.data());
+      mdv::ExtractSection<1>(masks.data(), count, second.data());
+      mdv::ExtractSection<2>(masks.data(), count, third.data());
+      std::vector<Mask_t> packed(count);
+
+      Report("Scalar Set loop", MeasureNsPerOp(iterations, count, [&]() {
+         for (size_t i = 0; i < count; ++i)
+         {
+            Mask_t mask;
+            mask.Set<0>(first[i]);
+            mask.Set<1>(second[i]);
+            mask.Set<2>(third[i]);
+            packed[i] = mask;
+         }
+         DoNotOptimize(packed.back());
+      }));
+      Report("PackSections", MeasureNsPerOp(iterations, count, [&]() {
+         mdv::PackSections(packed.data(), count, first.data(), second.data(), third.data());
+         DoNotOptimize(packed.back());
+      }));
+   }
+
+}
+
+BENCHMARK(BitmaskBulk)
+{
+   std::printf("  Using %s kernels\n", KernelName());
+   std::printf("  16K bitmasks (cache resident)\n");
+   MeasureBulk(1 << 14, 5000);
+   std::printf("  10M bitmasks (memory bound)\n");
+   MeasureBulk(10000000, 10);
+}
+
+//! \brief Compares scanning one section of a densely packed BitmaskArray with element-wise Get. The records take
+//!        13 bits, so four of them are read per chunk
+BENCHMARK(BitmaskArrayColumns)
+{
+   using Array_t = mdv::BitmaskArray<5, 8>;
+   using Layout_t = mdv::detail::columns::ArrayLayout<Array_t, 1>;
+   constexpr size_t count = 10000000;
+
+   Array_t records(count);
+   uint32_t state = 1;
+   for (size_t i = 0; i < count; ++i)
+   {
+      state = state * 1664525u + 1013904223u;
+      records.Set<0>(i, static_cast<uint8_t>(state >> 3));
+      records.Set<1>(i, static_cast<uint8_t>(state >> 24));
+   }
+   std::printf("  BMI2 %s\n", mdv::GetCpuFeatures().bmi2 ? "supported" : "not supported");
+
+   std::vector<uint8_t> column(count);
+   Report("Get<1> loop", MeasureNsPerOp(10, count, [&]() {
+      for (size_t i = 0; i < count; ++i)
+      {
+         column[i] = records.Get<1>(i);
+      }
+      DoNotOptimize(column.back());
+   }));
+   Report("GatherSection<1> (portable)", MeasureNsPerOp(10, count, [&]() {
+      mdv::detail::columns::GatherPortable<Layout_t>(records.Data(), count, column.data());
+      DoNotOptimize(column.back());
+   }));
+   Report("GatherSection<1>", MeasureNsPerOp(10, count, [&]() {
+      mdv::GatherSection<1>(records, column.data());
+      DoNotOptimize(column.back());
+   }));
+
+   std::vector<size_t> indices;
+   indices.reserve(count / 128);
+   Report("Get<1> == 5 loop", MeasureNsPerOp(10, count, [&]() {
+      indices.clear();
+      for (size_t i = 0; i < count; ++i)
+      {
+         if (records.Get<1>(i) == 5)
+            indices.push_back(i);
+      }
+      DoNotOptimize(indices.size());
+   }));
+   Report("FilterSection<1> (portable)", MeasureNsPerOp(10, count, [&]() {
+      indices.clear();
+      mdv::detail::columns::FilterPortable<Layout_t>(records.Data(), count, 5, indices);
+      DoNotOptimize(indices.size());
+   }));
+   Report("FilterSection<1>", MeasureNsPerOp(10, count, [&]() {
+      indices.clear();
+      mdv::FilterSection<1>(records, 5, indices);
+      DoNotOptimize(indices.size());
+   }));
+   Report("CountSection<1>", MeasureNsPerOp(10, count, [&]() {
+      DoNotOptimize(mdv::CountSection<1>(records, 5));
+   }));
+}
+
+//! \brief Saturating add and min over all sections of a vector of bitmasks, once section by section and once with
+//!        the SWAR functions from BitmaskArithmetic.h
+BENCHMARK(BitmaskArithmetic)
+{
+   using Mask_t = mdv::Bitmask<4, 6, 10, 12>;
+   constexpr size_t count = 1 << 16;
+
+   std::vector<Mask_t> left(count), right(count), result(count);
+   uint32_t state = 7;
+   for (size_t i = 0; i < count; ++i)
+   {
+      state = state * 1664525u + 1013904223u;
+      left[i] = Mask_t(state >> 4, state >> 8, state >> 14, state >> 20);
+      state = state * 1664525u + 1013904223u;
+      right[i] = Mask_t(state >> 4, state >> 8, state >> 14, state >> 20);
+   }
+
+   Report("Saturated add, per section", MeasureNsPerOp(200, count, [&]() {
+      for (size_t i = 0; i < count; ++i)
+      {
+         const auto l = left[i].GetAll();
+         const auto r = right[i].GetAll();
+         result[i] = Mask_t((std::min)(std::get<0>(l) + std::get<0>(r), 15),
+            (std::min)(std::get<1>(l) + std::get<1>(r), 63),
+            (std::min)(std::get<2>(l) + std::get<2>(r), 1023),
+            (std::min)(std::get<3>(l) + std::get<3>(r), 4095));
+      }
+      DoNotOptimize(result.back());
+   }));
+   Report("AddSectionsSaturated", MeasureNsPerOp(200, count, [&]() {
+      for (size_t i = 0; i < count; ++i)
+      {
+         result[i] = mdv::AddSectionsSaturated(left[i], right[i]);
+      }
+      DoNotOptimize(result.back());
+   }));
+
+   Report("Min, per section", MeasureNsPerOp(200, count, [&]() {
+      for (size_t i = 0; i < count; ++i)
+      {
+         const auto l = left[i].GetAll();
+         const auto r = right[i].GetAll();
+         result[i] = Mask_t((std::min)(std::get<0>(l), std::get<0>(r)), (std::min)(std::get<1>(l), std::get<1>(r)),
+            (std::min)(std::get<2>(l), std::get<2>(r)), (std::min)(std::get<3>(l), std::get<3>(r)));
+      }
+      DoNotOptimize(result.back());
+   }));
+   Report("MinSections", MeasureNsPerOp(200, count, [&]() {
+      for (size_t i = 0; i < count; ++i)
+      {
+         result[i] = mdv::MinSections(left[i], right[i]);
+      }
+      DoNotOptimize(result.back());
+   }));
+}
+
+//! \brief Sorts records by two separate sections and by two sections that form a single key, and inserts them into
+//!        a hash set
+BENCHMARK(BitmaskSort)
+{
+   using Mask_t = mdv::Bitmask<12, 6, 20, 10, 16>;
+   constexpr size_t count = 1000000;
+
+   std::vector<Mask_t> records(count);
+   uint64_t state = 3;
+   for (size_t i = 0; i < count; ++i)
+   {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      records[i] = Mask_t(state >> 52, state >> 20, state >> 40, state >> 30, static_cast<uint16_t>(i));
+   }
+
+   std::vector<Mask_t> sorted;
+   const auto measureSort = [&](const char* name, auto sort) {
+      Report(name, MeasureNsPerOp(5, count, [&]() {
+         sorted = records;
+         sort();
+         DoNotOptimize(sorted.front());
+      }));
+   };
+
+   measureSort("std::sort by <1, 3>", [&]() {
+      std::sort(sorted.begin(), sorted.end(), [](const Mask_t& l, const Mask_t& r) {
+         return l.Get<1>() != r.Get<1>() ? l.Get<1>() < r.Get<1>() : l.Get<3>() < r.Get<3>();
+      });
+   });
+   measureSort("SortBySections<1, 3>", [&]() {
+      mdv::SortBySections<1, 3>(sorted.begin(), sorted.end());
+   });
+   measureSort("std::sort by <2, 1>", [&]() {
+      std::sort(sorted.begin(), sorted.end(), [](const Mask_t& l, const Mask_t& r) {
+         return l.Get<2>() != r.Get<2>() ? l.Get<2>() < r.Get<2>() : l.Get<1>() < r.Get<1>();
+      });
+   });
+   measureSort("SortBySections<2, 1> (single key)", [&]() {
+      mdv::SortBySections<2, 1>(sorted.begin(), sorted.end());
+   });
+
+   Report("std::hash<Bitmask>", MeasureNsPerOp(20, count, [&]() {
+      size_t combined = 0;
+      for (const auto& record : records)
+      {
+         combined += std::hash<Mask_t>()(record);
+      }
+      DoNotOptimize(combined);
+   }));
+   Report("unordered_set<Bitmask> insert", MeasureNsPerOp(2, count, [&]() {
+      std::unordered_set<Mask_t> set(count);
+      set.insert(records.begin(), records.end());
+      DoNotOptimize(set.size());
+   }));
+}
+
+//! \brief Startup cost of an index of 10M records: rebuilding the array from its records vs. opening a view over the
+//!        serialized array (the memory stands in for a memory mapped file)
+BENCHMARK(BitmaskArrayFile)
+{
+   using Array_t = mdv::BitmaskArray<5, 8>;
+   constexpr size_t count = 10000000;
+
+   Array_t records;
+   Report("Rebuild BitmaskArray", MeasureNsPerOp(3, count, [&]() {
+      records = Array_t(count);
+      uint32_t state = 1;
+      for (size_t i = 0; i < count; ++i)
+      {
+         state = state * 1664525u + 1013904223u;
+         records.Set<0>(i, static_cast<uint8_t>(state >> 3));
+         records.Set<1>(i, static_cast<uint8_t>(state >> 24));
+      }
+      DoNotOptimize(records.Data()[0]);
+   }));
+
+   std::ostringstream stream;
+   mdv::WriteBitmaskArray(records, stream);
+   const auto bytes = stream.str();
+   std::vector<uint64_t> file((bytes.size() + 7) / 8);
+   std::memcpy(file.data(), bytes.data(), bytes.size());
+
+   Report("Open BitmaskArrayView (ns per open, not per record)", MeasureNsPerOp(1000, 1, [&]() {
+      mdv::BitmaskArrayView<5, 8> view(file.data(), bytes.size());
+      DoNotOptimize(view.Size());
+   }));
+
+   const mdv::BitmaskArrayView<5, 8> view(file.data(), bytes.size());
+   Report("CountSection<1> on BitmaskArray", MeasureNsPerOp(10, count, [&]() {
+      DoNotOptimize(mdv::CountSection<1>(records, 5));
+   }));
+   Report("CountSection<1> on BitmaskArrayView", MeasureNsPerOp(10, count, [&]() {
+      DoNotOptimize(mdv::CountSection<1>(view, 5));
+   }));
+}
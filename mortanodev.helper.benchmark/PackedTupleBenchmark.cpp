@@ -0,0 +1,65 @@
+#include "Benchmark.h"
+
+#include "structures\PackedTuple.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   constexpr size_t RecordCount = 1 << 20;
+
+   //! \brief A record struct with its members in declaration order, 32 bytes because of padding
+   struct Record
+   {
+      uint8_t kind;
+      uint64_t payload;
+      uint8_t flags;
+      uint32_t id;
+      uint8_t owner;
+      uint16_t count;
+   };
+
+   //! \brief The same members in a PackedTuple, 24 bytes
+   using PackedRecord_t = mdv::PackedTuple<uint8_t, uint64_t, uint8_t, uint32_t, uint8_t, uint16_t>;
+
+   uint32_t& Id(Record& record) { return record.id; }
+   uint16_t& Count(Record& record) { return record.count; }
+   uint32_t& Id(PackedRecord_t& record) { return record.Get<3>(); }
+   uint16_t& Count(PackedRecord_t& record) { return record.Get<5>(); }
+
+   //! \brief Sums up two members of every record. The records are too large for the cache, so the time mostly
+   //!        depends on the number of bytes that have to be read from memory
+   template<typename Record_t>
+   double MeasureScan()
+   {
+      std::vector<Record_t> records(RecordCount);
+      for (size_t i = 0; i < RecordCount; ++i)
+      {
+         Id(records[i]) = static_cast<uint32_t>(i);
+         Count(records[i]) = static_cast<uint16_t>(i);
+      }
+
+      return MeasureNsPerOp(20, RecordCount, [&]() {
+         uint64_t sum = 0;
+         for (auto& record : records)
+         {
+            sum += Id(record) + Count(record);
+         }
+         DoNotOptimize(sum);
+      });
+   }
+
+}
+
+//! \brief Scans a vector of records with the members uint8_t, uint64_t, uint8_t, uint32_t, uint8_t, uint16_t, once
+//!        as struct with the members in declaration order and once as PackedTuple
+BENCHMARK(PackedTuple)
+{
+   Report("Struct scan (" + std::to_string(sizeof(Record)) + " bytes)", MeasureScan<Record>());
+   Report("PackedTuple scan (" + std::to_string(sizeof(PackedRecord_t)) + " bytes)", MeasureScan<PackedRecord_t>());
+}
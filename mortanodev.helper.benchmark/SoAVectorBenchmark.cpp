@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+
+#include "structures\SoAVector.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   constexpr size_t RecordCount = 1 << 20;
+
+   //! \brief A record with 12 fields, of which the kernel below only reads two
+   struct Record
+   {
+      uint64_t id;
+      double price;
+      double quantity;
+      double discount;
+      double tax;
+      uint64_t customer;
+      uint64_t product;
+      uint32_t region;
+      uint32_t channel;
+      uint64_t timestamp;
+      double cost;
+      uint64_t flags;
+   };
+
+   using Records_t = mdv::SoAVector<mdv::meta::Typelist<uint64_t, double, double, double, double, uint64_t, uint64_t,
+      uint32_t, uint32_t, uint64_t, double, uint64_t>>;
+
+}
+
+//! \brief Revenue over all records, sum(price * quantity), which reads 2 of the 12 fields of every record
+BENCHMARK(SoAVector)
+{
+   std::vector<Record> aos(RecordCount);
+   Records_t soa;
+   soa.Resize(RecordCount);
+   auto prices = soa.Column<1>();
+   auto quantities = soa.Column<2>();
+   for (size_t i = 0; i < RecordCount; ++i)
+   {
+      aos[i].price = prices[i] = static_cast<double>(i % 100);
+      aos[i].quantity = quantities[i] = static_cast<double>(i % 7);
+   }
+
+   Report("AoS revenue (std::vector<Record>)", MeasureNsPerOp(20, RecordCount, [&]() {
+      double revenue = 0;
+      for (const auto& record : aos)
+      {
+         revenue += record.price * record.quantity;
+      }
+      DoNotOptimize(revenue);
+   }));
+
+   Report("SoA revenue (Column spans)", MeasureNsPerOp(20, RecordCount, [&]() {
+      const auto price = soa.Column<1>().Data();
+      const auto quantity = soa.Column<2>().Data();
+      double revenue = 0;
+      for (size_t i = 0; i < RecordCount; ++i)
+      {
+         revenue += price[i] * quantity[i];
+      }
+      DoNotOptimize(revenue);
+   }));
+
+   Report("SoA revenue (row proxies)", MeasureNsPerOp(20, RecordCount, [&]() {
+      double revenue = 0;
+      for (size_t i = 0; i < RecordCount; ++i)
+      {
+         const auto row = soa[i];
+         revenue += row.Get<1>() * row.Get<2>();
+      }
+      DoNotOptimize(revenue);
+   }));
+}
@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+
+#include "meta\TypeRegistry.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   struct Component0 {};
+   struct Component1 {};
+   struct Component2 {};
+   struct Component3 {};
+   struct Component4 {};
+   struct Component5 {};
+   struct Component6 {};
+   struct Component7 {};
+   struct Component8 {};
+   struct Component9 {};
+   struct Component10 {};
+   struct Component11 {};
+   struct Component12 {};
+   struct Component13 {};
+   struct Component14 {};
+   struct Component15 {};
+   struct Component16 {};
+   struct Component17 {};
+   struct Component18 {};
+   struct Component19 {};
+   struct Component20 {};
+   struct Component21 {};
+   struct Component22 {};
+   struct Component23 {};
+   struct Component24 {};
+   struct Component25 {};
+   struct Component26 {};
+   struct Component27 {};
+   struct Component28 {};
+   struct Component29 {};
+   struct Component30 {};
+   struct Component31 {};
+
+}
+
+MDV_TYPE_NAME(Component0, "bench::Component0")
+MDV_TYPE_NAME(Component1, "bench::Component1")
+MDV_TYPE_NAME(Component2, "bench::Component2")
+MDV_TYPE_NAME(Component3, "bench::Component3")
+MDV_TYPE_NAME(Component4, "bench::Component4")
+MDV_TYPE_NAME(Component5, "bench::Component5")
+MDV_TYPE_NAME(Component6, "bench::Component6")
+MDV_TYPE_NAME(Component7, "bench::Component7")
+MDV_TYPE_NAME(Component8, "bench::Component8")
+MDV_TYPE_NAME(Component9, "bench::Component9")
+MDV_TYPE_NAME(Component10, "bench::Component10")
+MDV_TYPE_NAME(Component11, "bench::Component11")
+MDV_TYPE_NAME(Component12, "bench::Component12")
+MDV_TYPE_NAME(Component13, "bench::Component13")
+MDV_TYPE_NAME(Component14, "bench::Component14")
+MDV_TYPE_NAME(Component15, "bench::Component15")
+MDV_TYPE_NAME(Component16, "bench::Component16")
+MDV_TYPE_NAME(Component17, "bench::Component17")
+MDV_TYPE_NAME(Component18, "bench::Component18")
+MDV_TYPE_NAME(Component19, "bench::Component19")
+MDV_TYPE_NAME(Component20, "bench::Component20")
+MDV_TYPE_NAME(Component21, "bench::Component21")
+MDV_TYPE_NAME(Component22, "bench::Component22")
+MDV_TYPE_NAME(Component23, "bench::Component23")
+MDV_TYPE_NAME(Component24, "bench::Component24")
+MDV_TYPE_NAME(Component25, "bench::Component25")
+MDV_TYPE_NAME(Component26, "bench::Component26")
+MDV_TYPE_NAME(Component27, "bench::Component27")
+MDV_TYPE_NAME(Component28, "bench::Component28")
+MDV_TYPE_NAME(Component29, "bench::Component29")
+MDV_TYPE_NAME(Component30, "bench::Component30")
+MDV_TYPE_NAME(Component31, "bench::Component31")
+
+namespace
+{
+
+   constexpr size_t LookupCount = 1 << 16;
+
+   using Components_t = mdv::meta::Typelist<
+   Component0, Component1, Component2, Component3, Component4, Component5, Component6, Component7,
+   Component8, Component9, Component10, Component11, Component12, Component13, Component14, Component15,
+   Component16, Component17, Component18, Component19, Component20, Component21, Component22, Component23,
+   Component24, Component25, Component26, Component27, Component28, Component29, Component30, Component31>;
+   using Registry_t = mdv::TypeRegistry<Components_t>;
+
+   //! \brief The lookup without the registry: compare the ID with the ID of every type until it matches
+   size_t LinearIndexOf(uint64_t typeId)
+   {
+      for (size_t idx = 0; idx < Registry_t::TypeCount; ++idx)
+      {
+         if (Registry_t::IdAt(idx) == typeId) return idx;
+      }
+      return Registry_t::NotFound;
+   }
+
+   //! \brief Maps random type tags, as they would come out of a serialized stream, to type indices
+   template<typename Lookup>
+   double MeasureLookup(Lookup lookup)
+   {
+      std::vector<uint64_t> tags(LookupCount);
+      uint32_t state = 12345;
+      for (auto& tag : tags)
+      {
+         state = state * 1664525u + 1013904223u;
+         tag = Registry_t::IdAt((state >> 16) % Registry_t::TypeCount);
+      }
+
+      return MeasureNsPerOp(50, LookupCount, [&]() {
+         size_t sum = 0;
+         for (auto tag : tags)
+         {
+            sum += lookup(tag);
+         }
+         DoNotOptimize(sum);
+      });
+   }
+
+}
+
+//! \brief Maps type IDs of 32 types to their index, once with a linear search and once with TypeRegistry
+BENCHMARK(TypeRegistry)
+{
+   Report("Linear search (32 types)", MeasureLookup(&LinearIndexOf));
+   Report("TypeRegistry (32 types)", MeasureLookup(&Registry_t::IndexOf));
+}
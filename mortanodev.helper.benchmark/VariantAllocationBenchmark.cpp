@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include "structures\Variant.h"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+   size_t AllocationCount = 0;
+}
+
+//Global allocation hook that counts all allocations of the benchmark executable
+
+void* operator new(size_t size)
+{
+   ++AllocationCount;
+   if (auto mem = std::malloc(size ? size : 1))
+      return mem;
+   throw std::bad_alloc();
+}
+
+void operator delete(void* mem) noexcept
+{
+   std::free(mem);
+}
+
+void operator delete(void* mem, size_t) noexcept
+{
+   std::free(mem);
+}
+
+namespace
+{
+
+   constexpr size_t Iterations = 100000;
+
+   //! \brief Measures an operation and reports its time and the number of allocations it performs
+   template<typename Func>
+   void MeasureWithAllocations(const std::string& name, Func&& func)
+   {
+      const auto allocationsBefore = AllocationCount;
+      func();
+      const auto allocations = AllocationCount - allocationsBefore;
+
+      const auto ns = MeasureNsPerOp(Iterations, 1, func);
+      std::printf("  %-56s %10.3f ns/op %6zu allocations/op\n", name.c_str(), ns, allocations);
+   }
+
+   const std::string LongString(128, 'x');
+
+}
+
+//! \brief Compares construct/copy/move/destroy of a Variant holding a heap allocating string with the same
+//!        operations on the plain string. Both should perform the same number of allocations
+BENCHMARK(VariantAllocations)
+{
+   using Var_t = mdv::Variant<int, std::string>;
+
+   const Var_t var(LongString);
+
+   MeasureWithAllocations("std::string copy + destroy", []() {
+      std::string copy(LongString);
+      DoNotOptimize(copy);
+   });
+   MeasureWithAllocations("Variant copy from value + destroy", []() {
+      Var_t copy(LongString);
+      DoNotOptimize(copy);
+   });
+   MeasureWithAllocations("Variant copy + destroy", [&var]() {
+      Var_t copy(var);
+      DoNotOptimize(copy);
+   });
+   MeasureWithAllocations("Variant copy + move + destroy", [&var]() {
+      Var_t copy(var);
+      Var_t moved(std::move(copy));
+      DoNotOptimize(moved);
+   });
+   MeasureWithAllocations("Variant copy + assign int", [&var]() {
+      Var_t copy(var);
+      copy = 42;
+      DoNotOptimize(copy);
+   });
+}
@@ -0,0 +1,285 @@
+#include "Benchmark.h"
+
+#include "structures\Variant.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   //! \brief Distinct payload type for each index. The special members are user-provided so that the compiler
+   //!        can't replace copies with a plain memcpy and the variant really has to dispatch on the type
+   template<size_t Idx>
+   struct Payload
+   {
+      Payload() : value(Idx) {}
+      Payload(const Payload& other) : value(other.value) {}
+      Payload(Payload&& other) : value(other.value) {}
+      Payload& operator=(const Payload& other) { value = other.value; return *this; }
+      ~Payload() {}
+
+      size_t value;
+   };
+
+   template<typename> struct MakeVariant;
+
+   template<size_t... Is>
+   struct MakeVariant<std::index_sequence<Is...>>
+   {
+      using type = mdv::Variant<Payload<Is>...>;
+   };
+
+   //! \brief Variant with N distinct alternatives
+   template<size_t N>
+   using Variant_t = typename MakeVariant<std::make_index_sequence<N>>::type;
+
+   //! \brief Layout the variant had before the storage was aligned and the discriminator shrunk: an unaligned
+   //!        char buffer followed by a size_t index
+   template<typename... Args>
+   struct LegacyLayout
+   {
+      char data[mdv::meta::Sizeof<mdv::meta::MaxOf_t<mdv::detail::BiggerType, mdv::meta::Typelist<Args...>>>::value];
+      size_t index;
+   };
+
+   struct alignas(16) Vec4
+   {
+      float values[4];
+   };
+
+   struct TelemetryRecord
+   {
+      uint64_t timestamp;
+      uint32_t source;
+      uint16_t flags;
+   };
+
+   template<typename... Args>
+   void ReportLayout(const char* name)
+   {
+      using Variant_t = mdv::Variant<Args...>;
+      std::printf("  %-40s sizeof %4zu (was %4zu)  alignof %3zu (was %3zu)\n",
+         name,
+         sizeof(Variant_t), sizeof(LegacyLayout<Args...>),
+         alignof(Variant_t), alignof(LegacyLayout<Args...>));
+   }
+
+   //! \brief A float with a user-provided copy constructor, which prevents the trivial fast path of Variant
+   struct NonTrivialFloat
+   {
+      NonTrivialFloat() : value(0) {}
+      NonTrivialFloat(const NonTrivialFloat& other) : value(other.value) {}
+
+      float value;
+   };
+
+   //! \brief Copies a large vector of variants. For trivially copyable variants this is a single memmove
+   template<typename Variant_t>
+   void CopyVector(const char* name)
+   {
+      constexpr size_t Count = 1 << 20;
+      const std::vector<Variant_t> src(Count, Variant_t(42));
+
+      const auto ns = MeasureNsPerOp(10, Count, [&]() {
+         std::vector<Variant_t> copy(src);
+         DoNotOptimize(copy.back());
+      });
+      Report(name, ns);
+   }
+
+   //! \brief Large record (4 KB) that is expensive to copy or move
+   struct LargeRecord
+   {
+      explicit LargeRecord(uint64_t timestamp)
+      {
+         for (size_t i = 0; i < 512; ++i)
+         {
+            values[i] = timestamp + i;
+         }
+      }
+
+      uint64_t values[512];
+   };
+
+   constexpr size_t ElementCount = 1024;
+   constexpr size_t Iterations = 2000;
+
+   //! \brief Copy assigns variants that hold the last alternative (the worst case for a linear search over the
+   //!        types). Each assignment destroys the old value and copy constructs the new one
+   template<size_t N>
+   void CopyAssign()
+   {
+      std::vector<Variant_t<N>> src;
+      src.reserve(ElementCount);
+      for (size_t i = 0; i < ElementCount; ++i)
+      {
+         src.emplace_back(Payload<N - 1>());
+      }
+      std::vector<Variant_t<N>> dst(src);
+
+      const auto ns = MeasureNsPerOp(Iterations, ElementCount, [&]() {
+         for (size_t i = 0; i < ElementCount; ++i)
+         {
+            dst[i] = src[i];
+         }
+         DoNotOptimize(dst[ElementCount - 1]);
+      });
+      Report("CopyAssign<" + std::to_string(N) + ">", ns);
+   }
+
+   //! \brief Move constructs and destroys variants that hold the last alternative
+   template<size_t N>
+   void MoveConstructAndDestroy()
+   {
+      std::vector<Variant_t<N>> src;
+      src.reserve(ElementCount);
+      for (size_t i = 0; i < ElementCount; ++i)
+      {
+         src.emplace_back(Payload<N - 1>());
+      }
+
+      const auto ns = MeasureNsPerOp(Iterations, ElementCount, [&]() {
+         for (size_t i = 0; i < ElementCount; ++i)
+         {
+            Variant_t<N> moved{ std::move(src[i]) };
+            DoNotOptimize(moved);
+         }
+      });
+      Report("MoveConstructAndDestroy<" + std::to_string(N) + ">", ns);
+   }
+
+}
+
+//! \brief Shows that copy/move/destroy dispatch of Variant takes constant time independent of the number of
+//!        alternatives
+BENCHMARK(VariantDispatch)
+{
+   CopyAssign<2>();
+   CopyAssign<4>();
+   CopyAssign<8>();
+   CopyAssign<16>();
+   CopyAssign<32>();
+   CopyAssign<64>();
+
+   MoveConstructAndDestroy<2>();
+   MoveConstructAndDestroy<4>();
+   MoveConstructAndDestroy<8>();
+   MoveConstructAndDestroy<16>();
+   MoveConstructAndDestroy<32>();
+   MoveConstructAndDestroy<64>();
+}
+
+//! \brief Prints the size and alignment of a couple of Variant instantiations compared to the previous layout
+BENCHMARK(VariantLayout)
+{
+   ReportLayout<bool, char>("Variant<bool, char>");
+   ReportLayout<int, float>("Variant<int, float>");
+   ReportLayout<uint16_t, uint32_t>("Variant<uint16_t, uint32_t>");
+   ReportLayout<char, double>("Variant<char, double>");
+   ReportLayout<int, double, TelemetryRecord>("Variant<int, double, TelemetryRecord>");
+   ReportLayout<float, Vec4>("Variant<float, Vec4>");
+   ReportLayout<int, std::string>("Variant<int, std::string>");
+}
+
+//! \brief Compares copying variants of trivially copyable types with variants that need dispatching
+BENCHMARK(VariantTrivialCopy)
+{
+   CopyVector<mdv::Variant<int, float, double>>("CopyVector<int, float, double>");
+   CopyVector<mdv::Variant<int, float, NonTrivialFloat>>("CopyVector<int, float, NonTrivialFloat>");
+}
+
+//! \brief Compares assigning a large record through a temporary with constructing it in place
+BENCHMARK(VariantEmplace)
+{
+   using Var_t = mdv::Variant<int, LargeRecord>;
+
+   Var_t v(42);
+   uint64_t timestamp = 0;
+
+   Report("Assign temporary LargeRecord", MeasureNsPerOp(Iterations * 100, 1, [&]() {
+      v = LargeRecord(++timestamp);
+      DoNotOptimize(v);
+   }));
+   Report("Emplace LargeRecord", MeasureNsPerOp(Iterations * 100, 1, [&]() {
+      v.Emplace<LargeRecord>(++timestamp);
+      DoNotOptimize(v);
+   }));
+}
+
+//! \brief Sums up a vector of variants that all hold an int using the different accessors. A Variant<int, float>
+//!        takes 8 bytes, so the reference is a plain struct of an int and a tag with the same layout; a plain
+//!        vector of ints only shows the cost of the bigger elements. With UncheckedGet in release builds, the loop
+//!        should be as fast as the plain struct. The checked accessors branch on the index of every element, which
+//!        keeps the compiler from vectorizing the loop
+BENCHMARK(VariantAccessors)
+{
+   using Var_t = mdv::Variant<int, float>;
+   constexpr size_t Count = 1 << 16;
+
+   struct TaggedInt
+   {
+      int value;
+      uint8_t tag;
+   };
+   static_assert(sizeof(TaggedInt) == sizeof(Var_t), "The reference must have the layout of the variant!");
+
+   const std::vector<int> ints(Count, 42);
+   const std::vector<TaggedInt> tagged(Count, TaggedInt{ 42, 0 });
+   const std::vector<Var_t> variants(Count, Var_t(42));
+
+   Report("Plain int (4 bytes)", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto val : ints)
+      {
+         sum += val;
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("Plain struct (8 bytes)", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto& val : tagged)
+      {
+         sum += val.value;
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("Get", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto& var : variants)
+      {
+         sum += var.Get<int>();
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("GetIf", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto& var : variants)
+      {
+         if (auto val = var.GetIf<int>())
+            sum += *val;
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("GetIfLikely", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto& var : variants)
+      {
+         if (auto val = var.GetIfLikely<int>())
+            sum += *val;
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("UncheckedGet", MeasureNsPerOp(Iterations, Count, [&]() {
+      int sum = 0;
+      for (auto& var : variants)
+      {
+         sum += var.UncheckedGet<int>();
+      }
+      DoNotOptimize(sum);
+   }));
+}
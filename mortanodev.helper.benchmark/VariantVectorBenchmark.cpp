@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+
+#include "structures\VariantVector.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace mortanodevhelperbenchmark;
+
+namespace
+{
+
+   //! \brief Big alternative that makes every element of a std::vector<Variant> large
+   struct Matrix
+   {
+      float values[16];
+   };
+
+   using Vec_t = mdv::VariantVector<int, double, Matrix>;
+   using Var_t = Vec_t::Variant_t;
+
+   constexpr size_t ElementCount = 1 << 20;
+
+   //! \brief Mostly ints with a few doubles and matrices in between
+   template<typename Func>
+   void Fill(Func&& pushBack)
+   {
+      for (size_t i = 0; i < ElementCount; ++i)
+      {
+         if (i % 16 == 0)
+            pushBack(Var_t(Matrix{}));
+         else if (i % 4 == 0)
+            pushBack(Var_t(static_cast<double>(i)));
+         else
+            pushBack(Var_t(static_cast<int>(i)));
+      }
+   }
+
+}
+
+//! \brief Compares the memory footprint and the time to sum up all ints of a std::vector<Variant> and a
+//!        VariantVector
+BENCHMARK(VariantVector)
+{
+   std::vector<Var_t> variants;
+   variants.reserve(ElementCount);
+   Fill([&variants](const Var_t& var) { variants.push_back(var); });
+
+   Vec_t vec;
+   Fill([&vec](const Var_t& var) { vec.PushBack(var); });
+
+   std::printf("  %-56s %10zu KB\n", "std::vector<Variant> memory", ElementCount * sizeof(Var_t) / 1024);
+   std::printf("  %-56s %10zu KB\n", "VariantVector memory", vec.MemoryFootprint() / 1024);
+
+   Report("std::vector<Variant> sum ints", MeasureNsPerOp(20, ElementCount, [&]() {
+      int64_t sum = 0;
+      for (auto& var : variants)
+      {
+         if (var.Is<int>())
+            sum += var.Get<int>();
+      }
+      DoNotOptimize(sum);
+   }));
+   Report("VariantVector ForEach<int> sum ints", MeasureNsPerOp(20, ElementCount, [&]() {
+      int64_t sum = 0;
+      vec.ForEach<int>([&sum](int val) { sum += val; });
+      DoNotOptimize(sum);
+   }));
+   Report("VariantVector random access Visit", MeasureNsPerOp(20, ElementCount / 16, [&]() {
+      int64_t sum = 0;
+      for (size_t i = 0; i < ElementCount; i += 16)
+      {
+         sum += vec.Visit(i + 1, [](const auto& val) { return static_cast<int64_t>(sizeof(val)); });
+      }
+      DoNotOptimize(sum);
+   }));
+}
@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""Compile-time and template-bloat report for Variant, Bitmask and NamedBitmask.
+
+For every scenario, a translation unit with many distinct instantiations of the structure is generated and compiled
+into an object file. Reported are:
+
+- the wall time and peak memory of the compiler process (peak memory only on POSIX systems)
+- the bytes of code and data in the object file, summed up per template (requires nm)
+- with Clang, the time spent instantiating each template, taken from -ftime-trace. The times are inclusive, so a
+  template that instantiates other templates also contains their time
+
+Template arguments are stripped from the names, so e.g. all mdv::detail::MaskAndOffset<...>::Get<...> functions are
+summed up into one row. At -O0, every instantiated function is emitted on its own and the sizes show which templates
+cause them. With optimizations, most of them are inlined into their callers.
+
+Usage:
+    bloat_report.py [--compiler clang++] [--count 50] [--opt -O0] [--top 15] [--save report.json]
+                    [--compare baseline.json]
+
+--save writes the totals of each scenario to a JSON file, and --compare prints the change against such a file, so that
+regressions in compile cost show up like regressions in the runtime benchmarks.
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import tempfile
+
+from meta_benchmark import run
+
+DEFAULT_INCLUDE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'mortanodev.helper', 'include')
+
+PRELUDE = r'''
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "structures/Variant.h"
+#include "structures/Bitmask.h"
+
+using swallow = int[];
+
+//Distinct types with non-trivial copy and destruction, so that a Variant needs its ConstructHelper
+template<size_t I> struct T
+{
+   T() : value() {}
+   T(const T& other) : value(other.value) {}
+   ~T() { value = 0; }
+   uint32_t value;
+};
+
+template<size_t I> struct Section : std::integral_constant<size_t, 1 + I % 13> {};
+'''
+
+SCENARIOS = {
+    'Variant': r'''
+template<size_t I, size_t... Ks>
+size_t UseVariant(std::index_sequence<Ks...>)
+{
+   mdv::Variant<T<I * 4 + Ks>...> variant{ T<I * 4>() };
+   auto copy = variant;
+   copy = T<I * 4 + 1>();
+   return copy.template Is<T<I * 4 + 1>>() ? copy.template Get<T<I * 4 + 1>>().value : 0;
+}
+
+template<size_t... Is>
+size_t Run(std::index_sequence<Is...>)
+{
+   size_t sum = 0;
+   (void)swallow{ 0, (sum += UseVariant<Is>(std::make_index_sequence<4>()), 0)... };
+   return sum;
+}
+''',
+    'Bitmask': r'''
+template<size_t I>
+size_t UseBitmask()
+{
+   mdv::Bitmask<1 + I % 16, 2 + I / 16 % 16, 3 + I / 256, 5> mask;
+   mask.template Set<0>(1);
+   mask.template Set<3>(2);
+   return mask.template Get<0>() + mask.template Get<1>() + mask.template Get<3>();
+}
+
+template<size_t... Is>
+size_t Run(std::index_sequence<Is...>)
+{
+   size_t sum = 0;
+   (void)swallow{ 0, (sum += UseBitmask<Is>(), 0)... };
+   return sum;
+}
+''',
+    'NamedBitmask': r'''
+template<size_t I>
+size_t UseNamedBitmask()
+{
+   mdv::NamedBitmask<Section<I * 3>, Section<I * 3 + 1>, Section<I * 3 + 2>> mask;
+   mask.template Set<Section<I * 3 + 1>>(1);
+   return mask.template Get<Section<I * 3>>() + mask.template Get<Section<I * 3 + 1>>();
+}
+
+template<size_t... Is>
+size_t Run(std::index_sequence<Is...>)
+{
+   size_t sum = 0;
+   (void)swallow{ 0, (sum += UseNamedBitmask<Is>(), 0)... };
+   return sum;
+}
+''',
+}
+
+EPILOGUE = r'''
+size_t RunAll()
+{
+   return Run(std::make_index_sequence<COUNT>());
+}
+'''
+
+
+def compiler_family(compiler):
+    name = os.path.basename(compiler).lower()
+    if name.startswith('cl') and not name.startswith('clang'):
+        return 'msvc'
+    return 'clang' if 'clang' in name else 'gcc'
+
+
+def copy_includes(include, directory):
+    """The library includes its own headers with backslashes, which only MSVC understands. The headers are copied
+    with forward slashes instead"""
+    target = os.path.join(directory, 'include')
+    shutil.copytree(include, target)
+    if os.name == 'nt':
+        return target
+    pattern = re.compile(r'^(\s*#\s*include\s*")([^"]*)(")', re.MULTILINE)
+    for root, _, files in os.walk(target):
+        for file in files:
+            path = os.path.join(root, file)
+            with open(path) as header:
+                content = header.read()
+            with open(path, 'w') as header:
+                header.write(pattern.sub(lambda m: m.group(1) + m.group(2).replace('\\', '/') + m.group(3), content))
+    return target
+
+
+def compile_command(compiler, include, source, obj, count, opt):
+    family = compiler_family(compiler)
+    if family == 'msvc':
+        return [compiler, '/nologo', '/std:c++14', '/c', '/EHsc', '/DNDEBUG', '/DCOUNT=%d' % count,
+                '/Od' if opt == '-O0' else '/O2', '/I', include, '/Fo' + obj, source]
+    #Meta.h uses std::bool_constant, which MSVC already provides in C++14 mode, but GCC and Clang only in C++17 mode
+    command = [compiler, '-std=c++17', '-c', opt, '-DNDEBUG', '-DCOUNT=%d' % count, '-I', include, '-o', obj, source]
+    if family == 'clang':
+        command.append('-ftime-trace')
+    return command
+
+
+OPERATOR = re.compile(r'operator\s*(\(\)|\[\]|<<=|>>=|->\*|<<|>>|<=|>=|==|!=|&&|\|\||\+\+|--|[-+*/%&|^]=|->|'
+                      r'[-+*/%&|^~!=<>,]|new|delete|\w[\w:]*)')
+
+
+def template_name(name):
+    """The name of a template instantiation without return type, template arguments and function parameters, e.g.
+    'unsigned long mdv::Bitmask<3ul, 5ul>::Get<0ul>() const' becomes 'mdv::Bitmask::Get'"""
+    result = []
+    depth = 0
+    i = 0
+    while i < len(name):
+        if depth == 0 and name.startswith('operator', i):
+            #Keep operator names like operator< or operator() intact
+            match = OPERATOR.match(name, i)
+            result.append(match.group(0).replace(' ', ''))
+            i = match.end()
+            continue
+        c = name[i]
+        if c in '<{(':
+            depth += 1
+        elif c in '>})':
+            depth -= 1
+        elif depth == 0:
+            result.append(c)
+        i += 1
+    #What remains are the return type, the qualified name and the qualifiers of the function
+    words = [word for word in ''.join(result).split() if word not in ('const', 'volatile', '&', '&&', 'noexcept')]
+    return words[-1] if words else name
+
+
+def symbol_sizes(obj):
+    """Bytes of code and data per template in the object file, as { name: (bytes, symbols) }"""
+    nm = shutil.which('nm') or shutil.which('llvm-nm')
+    if not nm:
+        return None
+    output = subprocess.run([nm, '-C', '-S', '--defined-only', obj], stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    sizes = {}
+    #Address, size, type and name. Symbols without a size (e.g. sections) are skipped
+    pattern = re.compile(r'^[0-9a-fA-F]+\s+([0-9a-fA-F]+)\s+\S\s+(.*)$')
+    for line in output.splitlines():
+        match = pattern.match(line)
+        if not match:
+            continue
+        name = template_name(match.group(2))
+        size, symbols = sizes.get(name, (0, 0))
+        sizes[name] = (size + int(match.group(1), 16), symbols + 1)
+    return sizes
+
+
+def instantiation_times(trace):
+    """Inclusive instantiation time in ms per template from a Clang time trace, as { name: (ms, instantiations) }"""
+    if not os.path.exists(trace):
+        return None
+    with open(trace) as file:
+        events = json.load(file)['traceEvents']
+    times = {}
+    for event in events:
+        if event.get('name') not in ('InstantiateClass', 'InstantiateFunction'):
+            continue
+        name = template_name(event['args']['detail'])
+        ms, count = times.get(name, (0.0, 0))
+        times[name] = (ms + event['dur'] / 1000.0, count + 1)
+    return times
+
+
+def print_top(title, unit, number_format, values, top):
+    if not values:
+        return
+    print('  %-60s %12s %8s' % (title, unit, 'Count'))
+    for name, (value, count) in sorted(values.items(), key=lambda item: -item[1][0])[:top]:
+        print('  %-60s %12s %8d' % (name[:60], number_format % value, count))
+
+
+def print_comparison(totals, baseline):
+    print('\n%-14s %18s %18s %18s' % ('Change', 'Time [ms]', 'Mem [MiB]', 'Object [bytes]'))
+    for name, current in totals.items():
+        if name not in baseline:
+            continue
+        cells = []
+        for key in ('time_ms', 'mem_mib', 'object_bytes'):
+            old, new = baseline[name].get(key), current.get(key)
+            cells.append('-' if not old or new is None else '%+.1f%%' % ((new - old) * 100.0 / old))
+        print('%-14s %18s %18s %18s' % (name, cells[0], cells[1], cells[2]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile-time and template-bloat report')
+    parser.add_argument('--compiler', default=shutil.which('clang++') or 'g++')
+    parser.add_argument('--include', default=DEFAULT_INCLUDE)
+    parser.add_argument('--count', type=int, default=50, help='Number of distinct instantiations per scenario')
+    parser.add_argument('--opt', default='-O0')
+    parser.add_argument('--top', type=int, default=15, help='Number of templates listed per scenario')
+    parser.add_argument('--repeat', type=int, default=3, help='The fastest of this many compilations is reported')
+    parser.add_argument('--save', help='Write the totals of each scenario to this JSON file')
+    parser.add_argument('--compare', help='Compare the totals against a file written by --save')
+    args = parser.parse_args()
+
+    totals = {}
+    with tempfile.TemporaryDirectory() as directory:
+        include = copy_includes(args.include, directory)
+        for name, body in SCENARIOS.items():
+            source = os.path.join(directory, name + '.cpp')
+            obj = os.path.join(directory, name + '.o')
+            with open(source, 'w') as file:
+                file.write(PRELUDE + body + EPILOGUE)
+
+            command = compile_command(args.compiler, include, source, obj, args.count, args.opt)
+            results = [run(command) for _ in range(args.repeat)]
+            success = all(result[0] for result in results)
+            _, seconds, memory = min(results, key=lambda result: result[1])
+            if not success:
+                print('%s: compilation failed' % name)
+                continue
+            sizes = symbol_sizes(obj)
+            times = instantiation_times(os.path.splitext(obj)[0] + '.json')
+            totals[name] = {
+                'time_ms': seconds * 1000,
+                'mem_mib': memory,
+                'object_bytes': sum(size for size, _ in sizes.values()) if sizes else None,
+            }
+
+            print('\n%s, %d instantiations: %.0f ms, %s MiB, %s bytes of code and data' % (
+                name, args.count, seconds * 1000, '-' if memory is None else '%.0f' % memory,
+                '-' if sizes is None else totals[name]['object_bytes']))
+            print_top('Template', 'Bytes', '%d', sizes, args.top)
+            print_top('Template (instantiation, inclusive)', 'Time [ms]', '%.1f', times, args.top)
+
+    if args.compare:
+        with open(args.compare) as file:
+            print_comparison(totals, json.load(file))
+    if args.save:
+        with open(args.save, 'w') as file:
+            json.dump(totals, file, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Compile-time benchmark for the Typelist/Numberlist algorithms in meta/Meta.h.
+
+For every algorithm and list size, a small translation unit is generated that instantiates the algorithm on a list of
+that many distinct types. Each translation unit is compiled on its own with syntax checking only, so the numbers only
+contain the work of the compiler frontend. Reported are the wall time and, on POSIX systems, the peak memory of the
+compiler process.
+
+Usage:
+    meta_benchmark.py [--compiler g++] [--include ../../mortanodev.helper/include] [--sizes 10,100,250,500,1000]
+
+Pass --include with a different include directory (e.g. an older checkout of the library) to compare two versions of
+Meta.h on the same machine.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+DEFAULT_INCLUDE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'mortanodev.helper', 'include')
+DEFAULT_SIZES = [10, 100, 250, 500, 1000]
+
+PRELUDE = r'''
+#include <stddef.h>
+#include <utility>
+#include "meta/Meta.h"
+
+template<size_t Idx> struct T {};
+template<typename U> struct AddPointer { using type = U*; };
+
+template<typename Indices> struct MakeList;
+template<size_t... Is> struct MakeList<std::index_sequence<Is...>> { using type = mdv::meta::Typelist<T<Is>...>; };
+template<typename Indices> struct MakeNumbers;
+template<size_t... Is> struct MakeNumbers<std::index_sequence<Is...>> { using type = mdv::meta::Numberlist<Is...>; };
+
+using List = MakeList<std::make_index_sequence<N>>::type;
+using Numbers = MakeNumbers<std::make_index_sequence<N>>::type;
+'''
+
+#Each benchmark touches the last element where it matters, which is the worst case for a recursive implementation
+ALGORITHMS = {
+    'Baseline': 'static_assert(mdv::meta::Size<List>::value == N, "");',
+    'At': 'static_assert(std::is_same<T<N - 1>, mdv::meta::At_t<N - 1, List>>::value, "");',
+    'IndexOf': 'static_assert(mdv::meta::IndexOf<T<N - 1>, List>::value == N - 1, "");',
+    'Contains': 'static_assert(mdv::meta::Contains<T<N - 1>, List>::value, "");',
+    'Take': 'static_assert(mdv::meta::Size<mdv::meta::Take_t<N - 1, List>>::value == N - 1, "");',
+    'Reverse': 'static_assert(mdv::meta::Size<mdv::meta::Reverse_t<List>>::value == N, "");',
+    'Transform': 'static_assert(mdv::meta::Size<mdv::meta::Transform_t<AddPointer, List>>::value == N, "");',
+    'Numberlist At': 'static_assert(mdv::meta::At<N - 1, Numbers>::value == N - 1, "");',
+    'Numberlist Sum': 'static_assert(mdv::meta::Sum<Numbers>::value == N * (N - 1) / 2, "");',
+}
+
+
+def compile_command(compiler, include, source, size):
+    if os.path.basename(compiler).lower().startswith('cl'):
+        return [compiler, '/nologo', '/std:c++14', '/Zs', '/EHsc', '/I', include, '/DN=%d' % size, source]
+    #Meta.h uses std::bool_constant, which MSVC already provides in C++14 mode, but GCC and Clang only in C++17 mode.
+    #The recursive implementations need one instantiation level per element
+    return [compiler, '-std=c++17', '-fsyntax-only', '-ftemplate-depth=%d' % (size * 4 + 1024), '-I', include,
+            '-DN=%d' % size, source]
+
+
+def run(command):
+    """Runs the command, returns (success, seconds, peak memory in MiB or None)"""
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    if hasattr(os, 'wait4'):
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        #ru_maxrss is in KiB on Linux and in bytes on macOS
+        scale = 1024 * 1024 if sys.platform == 'darwin' else 1024
+        return os.waitstatus_to_exitcode(status) == 0, elapsed, usage.ru_maxrss / scale
+    returncode = process.wait()
+    return returncode == 0, time.perf_counter() - start, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile-time benchmark for meta/Meta.h')
+    parser.add_argument('--compiler', default='g++')
+    parser.add_argument('--include', default=DEFAULT_INCLUDE)
+    parser.add_argument('--sizes', default=','.join(str(size) for size in DEFAULT_SIZES))
+    parser.add_argument('--repeat', type=int, default=3, help='The fastest of this many runs is reported')
+    args = parser.parse_args()
+    sizes = [int(size) for size in args.sizes.split(',')]
+
+    print('%-16s %6s %10s %10s' % ('Algorithm', 'Types', 'Time [ms]', 'Mem [MiB]'))
+    with tempfile.TemporaryDirectory() as directory:
+        for name, body in ALGORITHMS.items():
+            source = os.path.join(directory, name.replace(' ', '_') + '.cpp')
+            with open(source, 'w') as file:
+                file.write(PRELUDE + body + '\n')
+            for size in sizes:
+                results = [run(compile_command(args.compiler, args.include, source, size)) for _ in range(args.repeat)]
+                if not all(success for success, _, _ in results):
+                    print('%-16s %6d %10s %10s' % (name, size, 'failed', '-'))
+                    continue
+                elapsed = min(seconds for _, seconds, _ in results) * 1000
+                memory = min(results, key=lambda result: result[1])[2]
+                print('%-16s %6d %10.0f %10s' % (name, size, elapsed, '-' if memory is None else '%.0f' % memory))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,23 @@
+#include "Benchmark.h"
+
+#include <cstring>
+
+using namespace mortanodevhelperbenchmark;
+
+//! \brief Runs all registered benchmarks. If an argument is given, only the benchmarks whose name contains the
+//!        argument are run
+int main(int argc, char** argv)
+{
+   const char* filter = argc > 1 ? argv[1] : nullptr;
+
+   for (auto& entry : Registry())
+   {
+      if (filter && !std::strstr(entry.name, filter))
+         continue;
+
+      std::printf("%s\n", entry.name);
+      entry.func();
+   }
+
+   return 0;
+}
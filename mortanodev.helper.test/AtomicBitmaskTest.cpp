@@ -0,0 +1,220 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\AtomicBitmask.h"
+
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _RefCount : std::integral_constant<size_t, 20> {};
+   struct _Generation : std::integral_constant<size_t, 12> {};
+   struct _StateFlags : std::integral_constant<size_t, 32> {};
+
+   //! Runs func on the given number of threads at once
+   template<typename Func>
+   void RunOnThreads(size_t threadCount, Func func)
+   {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < threadCount; ++i)
+      {
+         threads.emplace_back(func);
+      }
+      for (auto& thread : threads)
+      {
+         thread.join();
+      }
+   }
+
+   TEST_CLASS(AtomicBitmaskTest)
+   {
+   public:
+      TEST_METHOD(Test_DefaultCtor)
+      {
+         AtomicBitmask<5, 10, 17> mask;
+         Assert::AreEqual(static_cast<uint8_t>(0), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint16_t>(0), mask.Load<1>());
+         Assert::AreEqual(0U, mask.Load<2>());
+         Assert::IsTrue(mask.IsLockFree());
+      }
+
+      TEST_METHOD(Test_LoadAndStore)
+      {
+         AtomicBitmask<5, 10, 17> mask{ Bitmask<5, 10, 17>(3, 1000, 100000) };
+         mask.Store<1>(0xffff);
+         Assert::AreEqual(static_cast<uint8_t>(3), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint16_t>(0x3ff), mask.Load<1>());
+         Assert::AreEqual(100000U, mask.Load<2>());
+
+         mask.StoreMany<2, 0>(7, 1);
+         const auto values = mask.LoadMany<0, 1, 2>();
+         Assert::IsTrue(std::make_tuple(static_cast<uint8_t>(1), static_cast<uint16_t>(0x3ff), 7U) == values);
+
+         mask.StoreMany<0, 1>(2, 5, std::memory_order_release);
+         Assert::AreEqual(static_cast<uint8_t>(2), mask.Load<0>(std::memory_order_acquire));
+         Assert::AreEqual(static_cast<uint16_t>(5), mask.Load<1>(std::memory_order_acquire));
+
+         mask.Store(Bitmask<5, 10, 17>(1, 2, 3));
+         Assert::AreEqual(3U, mask.Load().Get<2>());
+      }
+
+      TEST_METHOD(Test_CompareExchange)
+      {
+         AtomicBitmask<4, 4> mask{ Bitmask<4, 4>(1, 2) };
+
+         uint8_t expected = 5;
+         Assert::IsFalse(mask.CompareExchange<0>(expected, 9));
+         Assert::AreEqual(static_cast<uint8_t>(1), expected);
+
+         Assert::IsTrue(mask.CompareExchange<0>(expected, 9));
+         Assert::AreEqual(static_cast<uint8_t>(9), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint8_t>(2), mask.Load<1>());
+
+         auto whole = Bitmask<4, 4>(9, 3);
+         Assert::IsFalse(mask.CompareExchange(whole, Bitmask<4, 4>(0, 0)));
+         Assert::AreEqual(static_cast<uint8_t>(2), whole.Get<1>());
+         Assert::IsTrue(mask.CompareExchange(whole, Bitmask<4, 4>(0, 0)));
+         Assert::AreEqual(static_cast<uint8_t>(0), mask.Load<0>());
+      }
+
+      TEST_METHOD(Test_FailureOrder)
+      {
+         //A failed section compare-exchange only loads, with the failure ordering of std::atomic::compare_exchange
+         static_assert(detail::FailureOrder(std::memory_order_seq_cst) == std::memory_order_seq_cst, "");
+         static_assert(detail::FailureOrder(std::memory_order_acq_rel) == std::memory_order_acquire, "");
+         static_assert(detail::FailureOrder(std::memory_order_acquire) == std::memory_order_acquire, "");
+         static_assert(detail::FailureOrder(std::memory_order_release) == std::memory_order_relaxed, "");
+         static_assert(detail::FailureOrder(std::memory_order_relaxed) == std::memory_order_relaxed, "");
+
+         AtomicBitmask<4, 4> mask{ Bitmask<4, 4>(1, 2) };
+         uint8_t expected = 5;
+         Assert::IsFalse(mask.CompareExchange<1>(expected, 9, std::memory_order_acq_rel));
+         Assert::AreEqual(static_cast<uint8_t>(2), expected);
+         Assert::IsTrue(mask.CompareExchange<1>(expected, 9, std::memory_order_release));
+         Assert::AreEqual(static_cast<uint8_t>(9), mask.Load<1>());
+      }
+
+      TEST_METHOD(Test_FetchAdd_Wraps)
+      {
+         //The first section uses the CAS loop, the last section ends at the top of the word and uses fetch_add
+         AtomicBitmask<3, 5> mask{ Bitmask<3, 5>(6, 30) };
+
+         Assert::AreEqual(static_cast<uint8_t>(6), mask.FetchAdd<0>(3));
+         Assert::AreEqual(static_cast<uint8_t>(1), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint8_t>(30), mask.Load<1>());
+
+         Assert::AreEqual(static_cast<uint8_t>(30), mask.FetchAdd<1>(4));
+         Assert::AreEqual(static_cast<uint8_t>(2), mask.Load<1>());
+         Assert::AreEqual(static_cast<uint8_t>(1), mask.Load<0>());
+
+         Assert::AreEqual(static_cast<uint8_t>(1), mask.FetchSub<0>(2));
+         Assert::AreEqual(static_cast<uint8_t>(7), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint8_t>(2), mask.Load<1>());
+      }
+
+      TEST_METHOD(Test_Modify)
+      {
+         AtomicBitmask<5, 10, 17> mask{ Bitmask<5, 10, 17>(3, 1000, 100000) };
+         const auto previous = mask.Modify<0, 2>([](uint8_t& first, uint32_t& third) {
+            first = 4;
+            third += 1;
+         });
+         Assert::AreEqual(static_cast<uint8_t>(3), previous.Get<0>());
+         Assert::AreEqual(static_cast<uint8_t>(4), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint16_t>(1000), mask.Load<1>());
+         Assert::AreEqual(100001U, mask.Load<2>());
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         using Mask_t = NamedBitmask<_RefCount, _Generation, _StateFlags>;
+         AtomicNamedBitmask<_RefCount, _Generation, _StateFlags> mask{ Mask_t(1, 7, 0xff) };
+
+         Assert::AreEqual(1U, mask.FetchAdd<_RefCount>(1));
+         Assert::AreEqual(2U, mask.FetchSub<_RefCount>(1));
+         mask.Store<_StateFlags>(0x10);
+
+         uint16_t generation = 7;
+         Assert::IsTrue(mask.CompareExchange<_Generation>(generation, 8));
+         mask.Modify<_Generation, _StateFlags>([](uint16_t& gen, uint32_t& flags) {
+            ++gen;
+            flags |= 1;
+         });
+
+         uint32_t refCount, flags;
+         std::tie(refCount, generation, flags) = mask.LoadMany<_RefCount, _Generation, _StateFlags>();
+         Assert::AreEqual(1U, refCount);
+         Assert::AreEqual(static_cast<uint16_t>(9), generation);
+         Assert::AreEqual(0x11U, flags);
+
+         mask.StoreMany<_StateFlags, _RefCount>(0x20, 3, std::memory_order_release);
+         Assert::AreEqual(3U, mask.Load<_RefCount>(std::memory_order_acquire));
+         Assert::AreEqual(0x20U, mask.Load<_StateFlags>(std::memory_order_acquire));
+      }
+
+      TEST_METHOD(Test_ConcurrentFetchAdd)
+      {
+         constexpr size_t Threads = 4;
+         constexpr size_t Increments = 20000;
+
+         AtomicNamedBitmask<_RefCount, _Generation, _StateFlags> mask;
+         RunOnThreads(Threads, [&]() {
+            for (size_t i = 0; i < Increments; ++i)
+            {
+               mask.FetchAdd<_RefCount>(1);
+               mask.FetchAdd<_StateFlags>(2);
+               mask.Modify<_Generation>([](uint16_t& gen) { ++gen; });
+            }
+         });
+
+         Assert::AreEqual(static_cast<uint32_t>(Threads * Increments), mask.Load<_RefCount>());
+         Assert::AreEqual(static_cast<uint16_t>((Threads * Increments) & 0xfff), mask.Load<_Generation>());
+         Assert::AreEqual(static_cast<uint32_t>(2 * Threads * Increments), mask.Load<_StateFlags>());
+      }
+
+      TEST_METHOD(Test_ConcurrentCompareExchange)
+      {
+         //Every thread claims slots by incrementing the section with a CAS, each value must be claimed once
+         constexpr size_t Threads = 4;
+         constexpr uint32_t Slots = 10000;
+
+         AtomicBitmask<16, 16> mask;
+         std::vector<std::vector<uint16_t>> claimed(Threads);
+         std::atomic<size_t> nextThread(0);
+         RunOnThreads(Threads, [&]() {
+            auto& mine = claimed[nextThread++];
+            auto current = mask.Load<0>();
+            while (current < Slots)
+            {
+               if (mask.CompareExchange<0>(current, static_cast<uint16_t>(current + 1)))
+               {
+                  mine.push_back(current);
+                  //Unrelated updates of the other section must not make the CAS on the first section fail
+                  mask.FetchAdd<1>(1);
+                  ++current;
+               }
+            }
+         });
+
+         std::vector<bool> seen(Slots, false);
+         for (auto& values : claimed)
+         {
+            for (auto value : values)
+            {
+               Assert::IsFalse(seen[value]);
+               seen[value] = true;
+            }
+         }
+         Assert::AreEqual(static_cast<uint16_t>(Slots), mask.Load<0>());
+         Assert::AreEqual(static_cast<uint16_t>(Slots), mask.Load<1>());
+      }
+
+   };
+
+}
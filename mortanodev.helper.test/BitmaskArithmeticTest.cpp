@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskArithmetic.h"
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _Hops : std::integral_constant<size_t, 4> {};
+   struct _Ttl : std::integral_constant<size_t, 8> {};
+   struct _Window : std::integral_constant<size_t, 13> {};
+
+   //! Compares all SWAR operations with the obvious per-section computation on random bitmasks, including the
+   //! extreme values of each section
+   template<size_t... Bits>
+   struct SwarCheck
+   {
+      using Mask_t = Bitmask<Bits...>;
+      using Indices_t = std::make_index_sequence<sizeof...(Bits)>;
+
+      static void Run(size_t count)
+      {
+         uint64_t state = 12345;
+         for (size_t i = 0; i < count; ++i)
+         {
+            const auto l = Random(state, i % 4, Indices_t());
+            const auto r = Random(state, (i / 4) % 4, Indices_t());
+            CheckAll(l, r, Indices_t());
+         }
+      }
+
+   private:
+      //! mode 0 is random, 1 is all zero, 2 is all maximum, 3 is random values near zero
+      template<size_t... Is>
+      static Mask_t Random(uint64_t& state, size_t mode, std::index_sequence<Is...>)
+      {
+         Mask_t mask;
+         using swallow = int[];
+         (void)swallow { 0, ((void)(state = state * 6364136223846793005ULL + 1442695040888963407ULL,
+            mask.template Set<Is>(mode == 0 ? state >> 7 : mode == 1 ? 0 : mode == 2 ? ~uint64_t(0) : (state >> 60) % 3)), 0)... };
+         return mask;
+      }
+
+      template<size_t Index>
+      static void CheckSection(const Mask_t& l, const Mask_t& r)
+      {
+         const uint64_t max = detail::Mask<meta::At_t<Index, typename Mask_t::Numbers>::value>::value;
+         const uint64_t a = l.template Get<Index>();
+         const uint64_t b = r.template Get<Index>();
+
+         Assert::AreEqual((a + b) & max, static_cast<uint64_t>(AddSections(l, r).template Get<Index>()));
+         Assert::AreEqual((a - b) & max, static_cast<uint64_t>(SubSections(l, r).template Get<Index>()));
+         Assert::AreEqual(b > max - a ? max : a + b, static_cast<uint64_t>(AddSectionsSaturated(l, r).template Get<Index>()));
+         Assert::AreEqual(a < b ? 0 : a - b, static_cast<uint64_t>(SubSectionsSaturated(l, r).template Get<Index>()));
+         Assert::AreEqual(a < b ? a : b, static_cast<uint64_t>(MinSections(l, r).template Get<Index>()));
+         Assert::AreEqual(a < b ? b : a, static_cast<uint64_t>(MaxSections(l, r).template Get<Index>()));
+         Assert::AreEqual(a == b ? max : 0, static_cast<uint64_t>(EqualSections(l, r).template Get<Index>()));
+         Assert::AreEqual(a < b ? max : 0, static_cast<uint64_t>(LessSections(l, r).template Get<Index>()));
+      }
+
+      template<size_t... Is>
+      static void CheckAll(const Mask_t& l, const Mask_t& r, std::index_sequence<Is...>)
+      {
+         using swallow = int[];
+         (void)swallow { 0, ((void)CheckSection<Is>(l, r), 0)... };
+
+         const bool anyLess[] = { (l.template Get<Is>() < r.template Get<Is>())... };
+         const bool allEqual[] = { (l.template Get<Is>() == r.template Get<Is>())... };
+         bool expectedAnyLess = false, expectedAllEqual = true;
+         for (size_t i = 0; i < sizeof...(Is); ++i)
+         {
+            expectedAnyLess |= anyLess[i];
+            expectedAllEqual &= allEqual[i];
+         }
+         Assert::AreEqual(expectedAnyLess, AnySectionLess(l, r));
+         Assert::AreEqual(expectedAllEqual, AllSectionsEqual(l, r));
+      }
+   };
+
+   TEST_CLASS(BitmaskArithmeticTest)
+   {
+   public:
+      TEST_METHOD(Test_SmallSections)
+      {
+         SwarCheck<3, 5, 8>::Run(500);
+         SwarCheck<1, 1, 2, 1, 3>::Run(200);
+      }
+
+      TEST_METHOD(Test_UnusedStorageBits)
+      {
+         //13 bits in a uint16_t, the upper bits of the word have to stay zero
+         SwarCheck<13>::Run(200);
+         SwarCheck<6, 7>::Run(200);
+      }
+
+      TEST_METHOD(Test_FullWord)
+      {
+         //The carry out of the highest section leaves the word
+         SwarCheck<1, 7, 13, 11, 32>::Run(500);
+         SwarCheck<64>::Run(100);
+         SwarCheck<32, 32>::Run(100);
+      }
+
+      TEST_METHOD(Test_IncrementOneSection)
+      {
+         using Mask_t = Bitmask<4, 8, 4>;
+         Mask_t counters{ 15, 255, 15 };
+         const Mask_t increment{ 0, 1, 0 };
+
+         counters = AddSections(counters, increment);
+         Assert::AreEqual(static_cast<uint8_t>(15), counters.Get<0>());
+         Assert::AreEqual(static_cast<uint8_t>(0), counters.Get<1>());
+         Assert::AreEqual(static_cast<uint8_t>(15), counters.Get<2>());
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         using Mask_t = NamedBitmask<_Hops, _Ttl, _Window>;
+         const Mask_t limits{ 10, 64, 4000 };
+         const Mask_t current{ 12, 3, 4000 };
+
+         Assert::IsTrue(AnySectionLess(limits, current));
+         const auto clamped = MinSections(current, limits);
+         Assert::AreEqual(static_cast<uint8_t>(10), clamped.Get<_Hops>());
+         Assert::AreEqual(static_cast<uint8_t>(3), clamped.Get<_Ttl>());
+         Assert::AreEqual(static_cast<uint16_t>(4000), clamped.Get<_Window>());
+         Assert::IsFalse(AnySectionLess(limits, clamped));
+
+         const auto remaining = SubSectionsSaturated(limits, current);
+         Assert::AreEqual(static_cast<uint8_t>(0), remaining.Get<_Hops>());
+         Assert::AreEqual(static_cast<uint8_t>(61), remaining.Get<_Ttl>());
+         Assert::AreEqual(static_cast<uint16_t>(0), remaining.Get<_Window>());
+      }
+
+   };
+
+}
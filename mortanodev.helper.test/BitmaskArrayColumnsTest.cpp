@@ -0,0 +1,188 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskArrayColumns.h"
+
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _ColumnKind : std::integral_constant<size_t, 3> {};
+   struct _ColumnId : std::integral_constant<size_t, 9> {};
+
+   //! Fills an array with values that repeat often enough for the filter to find many matches, then compares
+   //! GatherSection, FilterSection and CountSection with the element-wise Get
+   template<size_t... Bits>
+   struct ColumnCheck
+   {
+      using Array_t = BitmaskArray<Bits...>;
+
+      static void Run(size_t count)
+      {
+         Array_t arr(count);
+         uint64_t state = count + 1;
+         for (size_t i = 0; i < count; ++i)
+         {
+            Fill(arr, i, state, std::make_index_sequence<sizeof...(Bits)>());
+         }
+         Check(arr, std::make_index_sequence<sizeof...(Bits)>());
+      }
+
+   private:
+      template<size_t... Is>
+      static void Fill(Array_t& arr, size_t index, uint64_t& state, std::index_sequence<Is...>)
+      {
+         using swallow = int[];
+         (void)swallow { 0, ((void)(state = state * 6364136223846793005ULL + 1442695040888963407ULL,
+            arr.template Set<Is>(index, (state >> 40) % 5)), 0)... };
+      }
+
+      template<size_t Index>
+      static void CheckSection(const Array_t& arr)
+      {
+         using Value_t = decltype(arr.template Get<Index>(0));
+         std::vector<Value_t> exact(arr.Size());
+         GatherSection<Index>(arr, exact.data());
+         std::vector<uint64_t> wide(arr.Size());
+         GatherSection<Index>(arr, wide.data());
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint64_t>(arr.template Get<Index>(i)), static_cast<uint64_t>(exact[i]));
+            Assert::AreEqual(static_cast<uint64_t>(arr.template Get<Index>(i)), wide[i]);
+         }
+
+         for (uint64_t value = 0; value < 6; ++value)
+         {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < arr.Size(); ++i)
+            {
+               if (arr.template Get<Index>(i) == value)
+                  expected.push_back(i);
+            }
+            std::vector<size_t> indices;
+            FilterSection<Index>(arr, value, indices);
+            Assert::IsTrue(expected == indices);
+            Assert::AreEqual(expected.size(), CountSection<Index>(arr, value));
+         }
+      }
+
+      template<size_t... Is>
+      static void Check(const Array_t& arr, std::index_sequence<Is...>)
+      {
+         using swallow = int[];
+         (void)swallow { 0, ((void)CheckSection<Is>(arr), 0)... };
+      }
+   };
+
+   TEST_CLASS(BitmaskArrayColumnsTest)
+   {
+   public:
+      TEST_METHOD(Test_ByteRecords)
+      {
+         ColumnCheck<3, 4, 1>::Run(1000);
+      }
+
+      TEST_METHOD(Test_StraddlingRecords)
+      {
+         //13 bits per record, so chunks start in the middle of words
+         ColumnCheck<5, 8>::Run(1001);
+         ColumnCheck<5, 8>::Run(3);
+      }
+
+      TEST_METHOD(Test_TinyRecords)
+      {
+         ColumnCheck<3>::Run(500);
+         ColumnCheck<1, 2>::Run(77);
+      }
+
+      TEST_METHOD(Test_LargeRecords)
+      {
+         //More than 32 bits per record, one record per chunk
+         ColumnCheck<1, 20, 12>::Run(300);
+         ColumnCheck<60, 40>::Run(100);
+      }
+
+      TEST_METHOD(Test_Empty)
+      {
+         ColumnCheck<5, 8>::Run(0);
+      }
+
+      TEST_METHOD(Test_ValueOutOfRange)
+      {
+         BitmaskArray<3, 4> arr(100);
+         std::vector<size_t> indices;
+         FilterSection<0>(arr, 8, indices);
+         Assert::IsTrue(indices.empty());
+         Assert::AreEqual<size_t>(0, CountSection<0>(arr, 8));
+         Assert::AreEqual<size_t>(100, CountSection<0>(arr, 0));
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         NamedBitmaskArray<_ColumnKind, _ColumnId> arr(200);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr.Set<_ColumnKind>(i, static_cast<uint8_t>(i % 7));
+            arr.Set<_ColumnId>(i, static_cast<uint16_t>(i));
+         }
+
+         std::vector<uint16_t> ids(arr.Size());
+         GatherSection<_ColumnId>(arr, ids.data());
+         for (size_t i = 0; i < ids.size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint16_t>(i), ids[i]);
+         }
+
+         std::vector<size_t> indices;
+         FilterSection<_ColumnKind>(arr, 3, indices);
+         Assert::AreEqual<size_t>(29, indices.size());
+         for (auto index : indices)
+         {
+            Assert::AreEqual<size_t>(3, index % 7);
+         }
+         Assert::AreEqual<size_t>(29, CountSection<_ColumnKind>(arr, 3));
+      }
+
+      //! The BMI2 kernels have to produce the same results as the portable ones, independent of which kernel the
+      //! dispatch picks on this machine
+      TEST_METHOD(Test_Kernels)
+      {
+#ifdef MDV_X64
+         if (!GetCpuFeatures().bmi2)
+            return;
+
+         using namespace detail::columns;
+         using Layout_t = Layout<meta::Numberlist<5, 8, 3>, 1>;
+
+         BitmaskArray<5, 8, 3> arr(333);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr.Set<1>(i, static_cast<uint8_t>(i % 11));
+            arr.Set<2>(i, static_cast<uint8_t>(i));
+         }
+
+         std::vector<uint8_t> expected(arr.Size()), out(arr.Size());
+         GatherPortable<Layout_t>(arr.Data(), arr.Size(), expected.data());
+         GatherBmi2<Layout_t>(arr.Data(), arr.Size(), out.data());
+         Assert::IsTrue(expected == out);
+
+         std::vector<uint32_t> expected32(arr.Size()), out32(arr.Size());
+         GatherPortable<Layout_t>(arr.Data(), arr.Size(), expected32.data());
+         GatherBmi2<Layout_t>(arr.Data(), arr.Size(), out32.data());
+         Assert::IsTrue(expected32 == out32);
+
+         std::vector<size_t> expectedIndices, indices;
+         FilterPortable<Layout_t>(arr.Data(), arr.Size(), 4, expectedIndices);
+         FilterBmi2<Layout_t>(arr.Data(), arr.Size(), 4, indices);
+         Assert::IsTrue(expectedIndices == indices);
+         Assert::AreEqual<size_t>(30, indices.size());
+#endif
+      }
+
+   };
+
+}
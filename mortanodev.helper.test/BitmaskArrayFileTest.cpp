@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskArrayFile.h"
+#include "util\MappedFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _Kind : std::integral_constant<size_t, 5> {};
+   struct _Owner : std::integral_constant<size_t, 8> {};
+
+   //! Serializes the array into 8 byte aligned memory, like a memory mapping would provide it
+   template<typename Array_t>
+   std::vector<uint64_t> Serialize(const Array_t& array)
+   {
+      std::ostringstream stream;
+      WriteBitmaskArray(array, stream);
+      const auto bytes = stream.str();
+      Assert::AreEqual(SerializedSize(array), bytes.size());
+
+      std::vector<uint64_t> memory((bytes.size() + 7) / 8);
+      std::memcpy(memory.data(), bytes.data(), bytes.size());
+      return memory;
+   }
+
+   BitmaskArray<5, 8> MakeArray(size_t count)
+   {
+      BitmaskArray<5, 8> array(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+         array.Set<0>(i, static_cast<uint8_t>(i * 7));
+         array.Set<1>(i, static_cast<uint8_t>(i % 13));
+      }
+      return array;
+   }
+
+   TEST_CLASS(BitmaskArrayFileTest)
+   {
+   public:
+      TEST_METHOD(Test_HeaderIsLittleEndian)
+      {
+         const auto memory = Serialize(MakeArray(300));
+         const auto bytes = reinterpret_cast<const unsigned char*>(memory.data());
+
+         Assert::AreEqual(0, std::memcmp(bytes, "MDVBMARR", 8));
+         Assert::AreEqual(1, static_cast<int>(bytes[8]));
+         Assert::AreEqual(13, static_cast<int>(bytes[24]));
+         Assert::AreEqual(2, static_cast<int>(bytes[28]));
+         //300 records
+         Assert::AreEqual(0x2c, static_cast<int>(bytes[32]));
+         Assert::AreEqual(0x01, static_cast<int>(bytes[33]));
+         Assert::AreEqual(64, static_cast<int>(bytes[48]));
+      }
+
+      TEST_METHOD(Test_ViewMatchesArray)
+      {
+         const auto array = MakeArray(1000);
+         const auto memory = Serialize(array);
+         const BitmaskArrayView<5, 8> view(memory.data(), memory.size() * sizeof(uint64_t));
+
+         Assert::AreEqual(array.Size(), view.Size());
+         Assert::AreEqual(array.WordCount(), view.WordCount());
+         for (size_t i = 0; i < array.Size(); ++i)
+         {
+            Assert::AreEqual(array.Get<0>(i), view.Get<0>(i));
+            Assert::AreEqual(array.Get<1>(i), view.Get<1>(i));
+         }
+         Assert::IsTrue(array[999] == view[999]);
+
+         std::vector<uint8_t> fromArray(array.Size()), fromView(view.Size());
+         GatherSection<1>(array, fromArray.data());
+         GatherSection<1>(view, fromView.data());
+         Assert::IsTrue(fromArray == fromView);
+
+         std::vector<size_t> expected, actual;
+         FilterSection<1>(array, 4, expected);
+         FilterSection<1>(view, 4, actual);
+         Assert::IsTrue(expected == actual);
+         Assert::AreEqual(expected.size(), CountSection<1>(view, 4));
+      }
+
+      TEST_METHOD(Test_NamedView)
+      {
+         NamedBitmaskArray<_Kind, _Owner> array(70);
+         array.Set<_Owner>(69, 200);
+         array.Set<_Kind>(3, 17);
+
+         const auto memory = Serialize(array);
+         const NamedBitmaskArrayView<_Kind, _Owner> view(memory.data(), memory.size() * sizeof(uint64_t));
+         Assert::AreEqual(static_cast<uint8_t>(200), view.Get<_Owner>(69));
+         Assert::AreEqual(static_cast<uint8_t>(17), view.Get<_Kind>(3));
+         Assert::AreEqual(size_t(1), CountSection<_Owner>(view, 200));
+
+         //Only the sizes of the sections matter, so the same records can be viewed without names
+         const BitmaskArrayView<5, 8> unnamed(memory.data(), memory.size() * sizeof(uint64_t));
+         Assert::AreEqual(static_cast<uint8_t>(200), unnamed.Get<1>(69));
+      }
+
+      TEST_METHOD(Test_EmptyArray)
+      {
+         const auto memory = Serialize(BitmaskArray<5, 8>());
+         const BitmaskArrayView<5, 8> view(memory.data(), memory.size() * sizeof(uint64_t));
+         Assert::IsTrue(view.Empty());
+         Assert::AreEqual(size_t(0), CountSection<0>(view, 0));
+      }
+
+      TEST_METHOD(Test_InvalidData)
+      {
+         const auto memory = Serialize(MakeArray(100));
+         const auto size = memory.size() * sizeof(uint64_t);
+
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<5, 8>(memory.data(), 32); });
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<5, 8>(memory.data(), size - 8); });
+         //Same number of bits per record, but different sections
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<8, 5>(memory.data(), size); });
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<5, 8, 1>(memory.data(), size); });
+
+         auto damaged = memory;
+         reinterpret_cast<unsigned char*>(damaged.data())[0] = 'X';
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<5, 8>(damaged.data(), size); });
+
+         damaged = memory;
+         reinterpret_cast<unsigned char*>(damaged.data())[33] += 1;
+         Assert::ExpectException<BadBitmaskArrayFile>([&]() { BitmaskArrayView<5, 8>(damaged.data(), size); });
+      }
+
+      TEST_METHOD(Test_MappedFile)
+      {
+         const char* path = "BitmaskArrayFileTest.bin";
+         const auto array = MakeArray(5000);
+         {
+            std::ofstream out(path, std::ios::binary);
+            WriteBitmaskArray(array, out);
+         }
+
+         {
+            MappedFile file(path);
+            Assert::AreEqual(SerializedSize(array), file.Size());
+            const BitmaskArrayView<5, 8> view(file.Data(), file.Size());
+            Assert::AreEqual(array.Get<0>(4321), view.Get<0>(4321));
+            Assert::AreEqual(CountSection<1>(array, 12), CountSection<1>(view, 12));
+         }
+         std::remove(path);
+
+         Assert::ExpectException<std::system_error>([&]() { MappedFile missing("does_not_exist.bin"); });
+      }
+
+   };
+
+}
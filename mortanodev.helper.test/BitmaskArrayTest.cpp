@@ -0,0 +1,204 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskArray.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _Id : std::integral_constant<size_t, 20> {};
+   struct _Kind : std::integral_constant<size_t, 3> {};
+   struct _Payload : std::integral_constant<size_t, 10> {};
+
+   TEST_CLASS(BitmaskArrayTest)
+   {
+   public:
+      TEST_METHOD(Test_DefaultCtor)
+      {
+         BitmaskArray<5, 8> arr;
+         Assert::IsTrue(arr.Empty());
+         Assert::AreEqual<size_t>(0, arr.Size());
+         Assert::IsTrue(arr.begin() == arr.end());
+      }
+
+      TEST_METHOD(Test_CountCtor_IsZeroed)
+      {
+         BitmaskArray<5, 8> arr(100);
+         Assert::AreEqual<size_t>(100, arr.Size());
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint8_t>(0), arr.Get<0>(i));
+            Assert::AreEqual(static_cast<uint8_t>(0), arr.Get<1>(i));
+         }
+      }
+
+      TEST_METHOD(Test_IsDenselyPacked)
+      {
+         //13 bits per record, 64 records take 13 words plus the padding word
+         BitmaskArray<5, 8> arr(64);
+         Assert::AreEqual<size_t>(14, arr.WordCount());
+      }
+
+      TEST_METHOD(Test_SetAndGet)
+      {
+         //33 bits per record, so most records straddle word boundaries
+         BitmaskArray<1, 20, 12> arr(1000);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr.Set<0>(i, static_cast<uint8_t>(i & 1));
+            arr.Set<1>(i, static_cast<uint32_t>(i * 997));
+            arr.Set<2>(i, static_cast<uint16_t>(0xfff - i));
+         }
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint8_t>(i & 1), arr.Get<0>(i));
+            Assert::AreEqual(static_cast<uint32_t>((i * 997) & 0xfffff), arr.Get<1>(i));
+            Assert::AreEqual(static_cast<uint16_t>((0xfff - i) & 0xfff), arr.Get<2>(i));
+         }
+      }
+
+      TEST_METHOD(Test_Set_DoesNotTouchNeighbours)
+      {
+         BitmaskArray<7, 6> arr(20);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr[i] = Bitmask<7, 6>(0x7f, 0x3f);
+         }
+         arr.Set<0>(10, 0);
+         arr.Set<1>(10, 0);
+
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            const auto expected0 = static_cast<uint8_t>(i == 10 ? 0 : 0x7f);
+            const auto expected1 = static_cast<uint8_t>(i == 10 ? 0 : 0x3f);
+            Assert::AreEqual(expected0, arr.Get<0>(i));
+            Assert::AreEqual(expected1, arr.Get<1>(i));
+         }
+      }
+
+      TEST_METHOD(Test_MultiWordRecords)
+      {
+         BitmaskArray<64, 37> arr(10);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr.Set<0>(i, 0xfedcba9876543210ULL + i);
+            arr.Set<1>(i, 0x1234567890ULL + i);
+         }
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(0xfedcba9876543210ULL + i, arr.Get<0>(i));
+            Assert::AreEqual(0x1234567890ULL + i, arr.Get<1>(i));
+         }
+      }
+
+      TEST_METHOD(Test_ProxyReference)
+      {
+         using Mask = Bitmask<3, 10>;
+         BitmaskArray<3, 10> arr(3);
+
+         arr[1] = Mask(5, 1000);
+         const Mask m = arr[1];
+         Assert::AreEqual(static_cast<uint8_t>(5), m.Get<0>());
+         Assert::AreEqual(static_cast<uint16_t>(1000), m.Get<1>());
+
+         arr[2] = arr[1];
+         Assert::AreEqual(static_cast<uint16_t>(1000), arr.Get<1>(2));
+         Assert::AreEqual(static_cast<uint16_t>(0), arr.Get<1>(0));
+      }
+
+      TEST_METHOD(Test_PushBackAndResize)
+      {
+         using Mask = Bitmask<3, 10>;
+         BitmaskArray<3, 10> arr;
+
+         for (uint16_t i = 0; i < 100; ++i)
+         {
+            arr.PushBack(Mask(static_cast<uint8_t>(i % 8), i));
+         }
+         Assert::AreEqual<size_t>(100, arr.Size());
+         Assert::AreEqual(static_cast<uint16_t>(99), arr.Get<1>(99));
+
+         //Shrinking and growing again must yield zeroed records
+         arr.Resize(10);
+         arr.Resize(100);
+         Assert::AreEqual(static_cast<uint16_t>(9), arr.Get<1>(9));
+         for (size_t i = 10; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint16_t>(0), arr.Get<1>(i));
+            Assert::AreEqual(static_cast<uint8_t>(0), arr.Get<0>(i));
+         }
+      }
+
+      TEST_METHOD(Test_Iterators)
+      {
+         using Mask = Bitmask<4, 9>;
+         BitmaskArray<4, 9> arr(50);
+         uint16_t counter = 0;
+         for (auto ref : arr)
+         {
+            ref = Mask(0, counter++);
+         }
+
+         const auto& carr = arr;
+         uint16_t expected = 0;
+         for (auto it = carr.begin(); it != carr.end(); ++it)
+         {
+            Assert::AreEqual(expected++, (*it).Get<1>());
+         }
+
+         Assert::AreEqual<std::ptrdiff_t>(50, arr.end() - arr.begin());
+         Assert::AreEqual(static_cast<uint16_t>(20), static_cast<Mask>(arr.begin()[20]).Get<1>());
+         BitmaskArray<4, 9>::const_iterator converted = arr.begin() + 5;
+         Assert::AreEqual(static_cast<uint16_t>(5), (*converted).Get<1>());
+      }
+
+      TEST_METHOD(Test_Sort)
+      {
+         using Mask = Bitmask<4, 9>;
+         BitmaskArray<4, 9> arr(64);
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr[i] = Mask(1, static_cast<uint16_t>((i * 37) % 64));
+         }
+
+         std::sort(arr.begin(), arr.end(), [](const Mask& l, const Mask& r) { return l.Get<1>() < r.Get<1>(); });
+
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint16_t>(i), arr.Get<1>(i));
+            Assert::AreEqual(static_cast<uint8_t>(1), arr.Get<0>(i));
+         }
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         using Mask = NamedBitmask<_Id, _Kind, _Payload>;
+         NamedBitmaskArray<_Id, _Kind, _Payload> arr(100);
+
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            arr.Set<_Id>(i, static_cast<uint32_t>(i * 1000));
+            arr.Set<_Kind>(i, static_cast<uint8_t>(i % 8));
+            arr.Set<_Payload>(i, static_cast<uint16_t>(i));
+         }
+
+         for (size_t i = 0; i < arr.Size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint32_t>(i * 1000), arr.Get<_Id>(i));
+            Assert::AreEqual(static_cast<uint8_t>(i % 8), arr.Get<_Kind>(i));
+            Assert::AreEqual(static_cast<uint16_t>(i), arr.Get<_Payload>(i));
+         }
+
+         const Mask m = arr[42];
+         Assert::AreEqual(static_cast<uint32_t>(42000), m.Get<_Id>());
+      }
+
+   };
+
+}
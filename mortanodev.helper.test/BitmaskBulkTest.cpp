@@ -0,0 +1,280 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskBulk.h"
+
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _BulkKind : std::integral_constant<size_t, 3> {};
+   struct _BulkId : std::integral_constant<size_t, 21> {};
+
+   //! Deterministic pseudo random numbers
+   inline uint64_t NextRandom(uint64_t& state)
+   {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      return state >> 11;
+   }
+
+   //! Fills 'count' random bitmasks and checks that ExtractSection and PackSections produce the same results as
+   //! the scalar accessors. Odd counts make sure that the scalar tail of the kernels is covered too
+   template<size_t... Bits>
+   struct BulkRoundtrip
+   {
+      using Mask_t = Bitmask<Bits...>;
+
+      static void Run(size_t count)
+      {
+         uint64_t state = count;
+         std::vector<Mask_t> masks(count);
+         for (auto& mask : masks)
+         {
+            SetRandom(mask, state, std::make_index_sequence<sizeof...(Bits)>());
+         }
+         Check(masks, std::make_index_sequence<sizeof...(Bits)>());
+      }
+
+   private:
+      template<size_t... Is>
+      static void SetRandom(Mask_t& mask, uint64_t& state, std::index_sequence<Is...>)
+      {
+         using swallow = int[];
+         (void)swallow { 0, ((void)mask.template Set<Is>(NextRandom(state)), 0)... };
+      }
+
+      template<size_t Index>
+      using Value_t = decltype(std::declval<Mask_t>().template Get<Index>());
+
+      template<size_t Index>
+      static std::vector<Value_t<Index>> ExtractAndCompare(const std::vector<Mask_t>& masks)
+      {
+         std::vector<Value_t<Index>> exact(masks.size());
+         ExtractSection<Index>(masks.data(), masks.size(), exact.data());
+
+         std::vector<uint64_t> wide(masks.size());
+         ExtractSection<Index>(masks.data(), masks.size(), wide.data());
+
+         std::vector<uint8_t> truncated(masks.size());
+         ExtractSection<Index>(masks.data(), masks.size(), truncated.data());
+
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            const auto expected = masks[i].template Get<Index>();
+            Assert::AreEqual(static_cast<uint64_t>(expected), static_cast<uint64_t>(exact[i]));
+            Assert::AreEqual(static_cast<uint64_t>(expected), wide[i]);
+            Assert::AreEqual(static_cast<uint8_t>(expected), truncated[i]);
+         }
+         return exact;
+      }
+
+      template<typename... Columns>
+      static void PackAndCompare(const std::vector<Mask_t>& masks, const Columns*... columns)
+      {
+         std::vector<Mask_t> packed(masks.size());
+         PackSections(packed.data(), packed.size(), columns...);
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            Assert::AreEqual(0, std::memcmp(&masks[i], &packed[i], sizeof(Mask_t)));
+         }
+      }
+
+      template<size_t... Is>
+      static void Check(const std::vector<Mask_t>& masks, std::index_sequence<Is...>)
+      {
+         const auto columns = std::make_tuple(ExtractAndCompare<Is>(masks)...);
+         PackAndCompare(masks, std::get<Is>(columns).data()...);
+
+         const std::vector<uint64_t> wide[] = { std::vector<uint64_t>(std::get<Is>(columns).begin(), std::get<Is>(columns).end())... };
+         PackAndCompare(masks, wide[Is].data()...);
+      }
+   };
+
+   //! Runs one extraction kernel against the scalar loop for all output types that the kernels support
+   template<typename Word_t, typename Section_t>
+   struct KernelCheck
+   {
+      template<typename Out_t>
+      using Kernel_t = void(*)(const Word_t*, size_t, Out_t*);
+
+      template<typename Out_t>
+      static void Run(const std::vector<Word_t>& in, Kernel_t<Out_t> kernel)
+      {
+         std::vector<Out_t> expected(in.size());
+         detail::bulk::ExtractScalar<Word_t, Section_t>(in.data(), in.size(), expected.data());
+         std::vector<Out_t> out(in.size());
+         kernel(in.data(), in.size(), out.data());
+         Assert::IsTrue(expected == out);
+      }
+   };
+
+   TEST_CLASS(BitmaskBulkTest)
+   {
+   public:
+      TEST_METHOD(Test_8Bit)
+      {
+         BulkRoundtrip<3, 4, 1>::Run(1000);
+         BulkRoundtrip<3, 4, 1>::Run(77);
+      }
+
+      TEST_METHOD(Test_16Bit)
+      {
+         BulkRoundtrip<5, 10>::Run(1000);
+         BulkRoundtrip<5, 10>::Run(13);
+      }
+
+      TEST_METHOD(Test_32Bit)
+      {
+         BulkRoundtrip<5, 10, 17>::Run(1000);
+         BulkRoundtrip<1, 31>::Run(3);
+      }
+
+      TEST_METHOD(Test_64Bit)
+      {
+         BulkRoundtrip<13, 40, 11>::Run(1001);
+         BulkRoundtrip<64>::Run(5);
+      }
+
+      TEST_METHOD(Test_MultiWord)
+      {
+         BulkRoundtrip<60, 40, 28>::Run(100);
+      }
+
+      TEST_METHOD(Test_Empty)
+      {
+         BulkRoundtrip<5, 10, 17>::Run(0);
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         using Mask_t = NamedBitmask<_BulkKind, _BulkId>;
+         std::vector<uint8_t> kinds(100);
+         std::vector<uint32_t> ids(100);
+         for (size_t i = 0; i < kinds.size(); ++i)
+         {
+            kinds[i] = static_cast<uint8_t>(i % 8);
+            ids[i] = static_cast<uint32_t>(i * 12345);
+         }
+
+         std::vector<Mask_t> masks(100);
+         PackSections(masks.data(), masks.size(), kinds.data(), ids.data());
+
+         std::vector<uint32_t> extracted(100);
+         ExtractSection<_BulkId>(masks.data(), masks.size(), extracted.data());
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint8_t>(i % 8), masks[i].Get<_BulkKind>());
+            Assert::AreEqual(static_cast<uint32_t>((i * 12345) & 0x1fffff), extracted[i]);
+         }
+      }
+
+      //! Signed columns that are narrower than their section are zero extended by every kernel
+      TEST_METHOD(Test_SignedColumns)
+      {
+         using Mask_t = Bitmask<13, 40, 11>;
+         std::vector<int8_t> kinds(101);
+         std::vector<int64_t> ids(kinds.size());
+         std::vector<int16_t> flags(kinds.size());
+         for (size_t i = 0; i < kinds.size(); ++i)
+         {
+            kinds[i] = static_cast<int8_t>(-static_cast<int>(i));
+            ids[i] = static_cast<int64_t>(i) * 1000;
+            flags[i] = static_cast<int16_t>(-static_cast<int>(i) * 7);
+         }
+
+         std::vector<Mask_t> masks(kinds.size());
+         PackSections(masks.data(), masks.size(), kinds.data(), ids.data(), flags.data());
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            Assert::AreEqual(static_cast<uint64_t>(static_cast<uint8_t>(kinds[i])), masks[i].Get<0>());
+            Assert::AreEqual(static_cast<uint64_t>(ids[i]), masks[i].Get<1>());
+            Assert::AreEqual(static_cast<uint64_t>(static_cast<uint16_t>(flags[i]) & 0x7ff), masks[i].Get<2>());
+         }
+      }
+
+      //! bool is extracted by the scalar loop, so every section value that is not 0 becomes true
+      TEST_METHOD(Test_BoolColumn)
+      {
+         using Mask_t = Bitmask<4, 60>;
+         static_assert(!detail::bulk::SupportsExtractKernels<Mask_t, bool>::value, "bool must not use the kernels!");
+
+         std::vector<Mask_t> masks(100);
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            masks[i].Set<0>(i % 16);
+            masks[i].Set<1>(i);
+         }
+
+         std::unique_ptr<bool[]> extracted(new bool[masks.size()]);
+         ExtractSection<0>(masks.data(), masks.size(), extracted.get());
+         for (size_t i = 0; i < masks.size(); ++i)
+         {
+            Assert::AreEqual(i % 16 != 0, extracted[i]);
+         }
+      }
+
+      //! All kernels that the CPU supports have to produce the same results as the scalar loops, independent of
+      //! which kernel the dispatch picks on this machine
+      TEST_METHOD(Test_Kernels)
+      {
+         using namespace detail::bulk;
+         using Word_t = uint64_t;
+         using Mask_t = Bitmask<13, 40, 11>;
+         using Section_t = detail::Section<Word_t, Mask_t::Numbers, 1>;
+         using Check_t = KernelCheck<Word_t, Section_t>;
+
+         uint64_t state = 42;
+         std::vector<Word_t> in(123);
+         for (auto& value : in)
+         {
+            value = NextRandom(state) ^ (NextRandom(state) << 32);
+         }
+
+         std::vector<uint8_t> kinds(in.size());
+         std::vector<uint64_t> ids(in.size());
+         std::vector<uint16_t> flags(in.size());
+         for (size_t i = 0; i < in.size(); ++i)
+         {
+            kinds[i] = static_cast<uint8_t>(in[i]);
+            ids[i] = in[i] >> 13;
+            flags[i] = static_cast<uint16_t>(in[i] >> 48);
+         }
+         std::vector<Word_t> expected(in.size());
+         PackScalar<Mask_t>(expected.data(), in.size(), std::make_index_sequence<3>(), kinds.data(), ids.data(), flags.data());
+
+#ifdef MDV_X86
+         if (GetCpuFeatures().sse2)
+         {
+            Check_t::Run<uint8_t>(in, &ExtractSse2<Section_t, Word_t, uint8_t>);
+            Check_t::Run<uint16_t>(in, &ExtractSse2<Section_t, Word_t, uint16_t>);
+            Check_t::Run<uint32_t>(in, &ExtractSse2<Section_t, Word_t, uint32_t>);
+            Check_t::Run<uint64_t>(in, &ExtractSse2<Section_t, Word_t, uint64_t>);
+
+            std::vector<Word_t> out(in.size());
+            PackSse2<Mask_t>(out.data(), in.size(), std::make_index_sequence<3>(), kinds.data(), ids.data(), flags.data());
+            Assert::IsTrue(expected == out);
+         }
+         if (GetCpuFeatures().avx2)
+         {
+            Check_t::Run<uint8_t>(in, &ExtractAvx2<Section_t, Word_t, uint8_t>);
+            Check_t::Run<uint16_t>(in, &ExtractAvx2<Section_t, Word_t, uint16_t>);
+            Check_t::Run<uint32_t>(in, &ExtractAvx2<Section_t, Word_t, uint32_t>);
+            Check_t::Run<uint64_t>(in, &ExtractAvx2<Section_t, Word_t, uint64_t>);
+
+            std::vector<Word_t> out(in.size());
+            PackAvx2<Mask_t>(out.data(), in.size(), std::make_index_sequence<3>(), kinds.data(), ids.data(), flags.data());
+            Assert::IsTrue(expected == out);
+         }
+#endif
+      }
+
+   };
+
+}
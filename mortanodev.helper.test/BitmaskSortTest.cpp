@@ -0,0 +1,202 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\BitmaskSort.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _Material : std::integral_constant<size_t, 6> {};
+   struct _Depth : std::integral_constant<size_t, 24> {};
+   struct _Layer : std::integral_constant<size_t, 3> {};
+
+   //! Random bitmasks where the last section holds the original position, to check that the sort is stable
+   template<typename Mask_t, typename Func>
+   std::vector<Mask_t> MakeRecords(size_t count, Func setRandom)
+   {
+      std::vector<Mask_t> records(count);
+      uint64_t state = 42;
+      for (size_t i = 0; i < count; ++i)
+      {
+         state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+         setRandom(records[i], state, i);
+      }
+      return records;
+   }
+
+   TEST_CLASS(BitmaskSortTest)
+   {
+   public:
+      TEST_METHOD(Test_SingleSection)
+      {
+         using Mask_t = Bitmask<5, 7, 20>;
+         auto records = MakeRecords<Mask_t>(5000, [](Mask_t& mask, uint64_t random, size_t i) {
+            mask.Set<0>(static_cast<uint8_t>(random >> 40));
+            mask.Set<1>(static_cast<uint8_t>(random >> 50));
+            mask.Set<2>(static_cast<uint32_t>(i));
+         });
+         auto expected = records;
+         std::stable_sort(expected.begin(), expected.end(), [](const Mask_t& l, const Mask_t& r) {
+            return l.Get<1>() < r.Get<1>();
+         });
+
+         SortBySections<1>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_SeparateSections)
+      {
+         //Section 1 and then section 3, the key consists of two ranges. The 22 bits of section 3 need two passes
+         using Mask_t = Bitmask<4, 5, 3, 22, 16>;
+         auto records = MakeRecords<Mask_t>(5000, [](Mask_t& mask, uint64_t random, size_t i) {
+            mask.Set<0>(static_cast<uint8_t>(random >> 60));
+            mask.Set<1>(static_cast<uint8_t>(random >> 10));
+            mask.Set<3>(static_cast<uint32_t>(random >> 52));
+            mask.Set<4>(static_cast<uint16_t>(i));
+         });
+         auto expected = records;
+         std::stable_sort(expected.begin(), expected.end(), [](const Mask_t& l, const Mask_t& r) {
+            return l.Get<1>() != r.Get<1>() ? l.Get<1>() < r.Get<1>() : l.Get<3>() < r.Get<3>();
+         });
+
+         SortBySections<1, 3>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_ContiguousSectionsAreOneKey)
+      {
+         using Numbers = meta::Numberlist<4, 5, 3, 22>;
+         using Merged_t = detail::radix::KeyRanges<Numbers, 3, 2, 1>::type;
+         Assert::AreEqual(size_t(1), meta::Size<Merged_t>::value);
+         Assert::AreEqual(size_t(4), static_cast<size_t>(meta::At_t<0, Merged_t>::Offset));
+         Assert::AreEqual(size_t(30), static_cast<size_t>(meta::At_t<0, Merged_t>::Bits));
+         Assert::AreEqual(size_t(3), meta::Size<detail::radix::Digits<Merged_t>::type>::value);
+
+         using Separate_t = detail::radix::KeyRanges<Numbers, 1, 2>::type;
+         Assert::AreEqual(size_t(2), meta::Size<Separate_t>::value);
+
+         using Mask_t = Bitmask<4, 5, 3, 22>;
+         auto records = MakeRecords<Mask_t>(3000, [](Mask_t& mask, uint64_t random, size_t i) {
+            mask.Set<0>(static_cast<uint8_t>(i));
+            mask.Set<1>(static_cast<uint8_t>(random >> 59));
+            mask.Set<2>(static_cast<uint8_t>(random >> 20));
+            mask.Set<3>(static_cast<uint32_t>(random >> 50));
+         });
+         auto expected = records;
+         std::stable_sort(expected.begin(), expected.end(), [](const Mask_t& l, const Mask_t& r) {
+            return std::make_tuple(l.Get<3>(), l.Get<2>(), l.Get<1>()) <
+               std::make_tuple(r.Get<3>(), r.Get<2>(), r.Get<1>());
+         });
+
+         SortBySections<3, 2, 1>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_MultiWordBitmask)
+      {
+         //Section 1 straddles the first two words
+         using Mask_t = Bitmask<40, 40, 30>;
+         auto records = MakeRecords<Mask_t>(2000, [](Mask_t& mask, uint64_t random, size_t i) {
+            mask.Set<0>(i);
+            mask.Set<1>(random >> 30);
+            mask.Set<2>(static_cast<uint32_t>(random));
+         });
+         auto expected = records;
+         std::stable_sort(expected.begin(), expected.end(), [](const Mask_t& l, const Mask_t& r) {
+            return l.Get<1>() < r.Get<1>();
+         });
+
+         SortBySections<1>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_Named)
+      {
+         using Mask_t = NamedBitmask<_Material, _Depth, _Layer>;
+         auto records = MakeRecords<Mask_t>(2000, [](Mask_t& mask, uint64_t random, size_t) {
+            mask.Set<_Material>(static_cast<uint8_t>(random >> 58));
+            mask.Set<_Depth>(static_cast<uint32_t>(random >> 20));
+            mask.Set<_Layer>(static_cast<uint8_t>(random >> 61));
+         });
+         auto expected = records;
+         std::stable_sort(expected.begin(), expected.end(), [](const Mask_t& l, const Mask_t& r) {
+            return std::make_tuple(l.Get<_Layer>(), l.Get<_Material>(), l.Get<_Depth>()) <
+               std::make_tuple(r.Get<_Layer>(), r.Get<_Material>(), r.Get<_Depth>());
+         });
+
+         SortBySections<_Layer, _Material, _Depth>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_SmallAndUniformRanges)
+      {
+         std::vector<Bitmask<4, 4>> records;
+         SortBySections<0>(records.begin(), records.end());
+
+         records.push_back(Bitmask<4, 4>(3, 1));
+         SortBySections<0>(records.begin(), records.end());
+         Assert::AreEqual(static_cast<uint8_t>(3), records[0].Get<0>());
+
+         //All keys are equal, every pass is skipped and the order stays the same
+         for (uint8_t i = 0; i < 10; ++i)
+         {
+            records.push_back(Bitmask<4, 4>(3, i));
+         }
+         const auto expected = records;
+         SortBySections<0>(records.begin(), records.end());
+         Assert::IsTrue(expected == records);
+      }
+
+      TEST_METHOD(Test_Equality)
+      {
+         Assert::IsTrue(Bitmask<5, 10>(3, 700) == Bitmask<5, 10>(3, 700));
+         Assert::IsTrue(Bitmask<5, 10>(3, 700) != Bitmask<5, 10>(3, 701));
+         Assert::IsTrue(Bitmask<64, 64>(1, 2) != Bitmask<64, 64>(1, 3));
+         using Named_t = NamedBitmask<_Material, _Layer>;
+         Assert::IsTrue(Named_t(1, 2) == Named_t(1, 2));
+         Assert::IsFalse(Named_t(1, 2) == Named_t(2, 1));
+      }
+
+      TEST_METHOD(Test_Hash)
+      {
+         using Mask_t = Bitmask<4, 20, 40>;
+         std::hash<Mask_t> hash;
+         Assert::AreEqual(hash(Mask_t(1, 2, 3)), hash(Mask_t(1, 2, 3)));
+
+         //Masks that only differ in their highest section must still spread over the low bits of the hash
+         std::vector<size_t> buckets(64, 0);
+         for (uint64_t i = 0; i < 6400; ++i)
+         {
+            ++buckets[hash(Mask_t(0, 0, i << 20)) % 64];
+         }
+         for (auto size : buckets)
+         {
+            Assert::IsTrue(size > 50 && size < 150);
+         }
+
+         std::unordered_map<Mask_t, int> map;
+         map[Mask_t(1, 2, 3)] = 1;
+         map[Mask_t(3, 2, 1)] = 2;
+         map[Mask_t(1, 2, 3)] += 10;
+         Assert::AreEqual(size_t(2), map.size());
+         Assert::AreEqual(11, map[Mask_t(1, 2, 3)]);
+
+         using Named_t = NamedBitmask<_Material, _Depth, _Layer>;
+         std::unordered_set<Named_t> set{ Named_t(1, 2, 3), Named_t(1, 2, 3), Named_t(1, 2, 4) };
+         Assert::AreEqual(size_t(2), set.size());
+
+         std::unordered_set<Bitmask<64, 64, 3>> wide{ Bitmask<64, 64, 3>(1, 2, 3), Bitmask<64, 64, 3>(1, 2, 4) };
+         Assert::AreEqual(size_t(2), wide.size());
+      }
+
+   };
+
+}
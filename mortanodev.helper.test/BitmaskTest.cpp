@@ -3,6 +3,7 @@
 
 #include "structures\Bitmask.h"
 
+#include <tuple>
 #include <vector>
 
 using namespace mdv;
@@ -81,6 +82,25 @@ namespace mortanodevhelpertest
          Assert::AreEqual(static_cast<uint8_t>(3), m.Get<1>());
       }
 
+      TEST_METHOD(Test_ArgsCtor_IsConstexpr)
+      {
+         using Mask = Bitmask<3, 9, 4>;
+
+         constexpr Mask m{ 5, 0x1ff, 0xa };
+         static_assert(m.Get<0>() == 5, "Wrong value!");
+         static_assert(m.Get<1>() == 0x1ff, "Wrong value!");
+         static_assert(m.Get<2>() == 0xa, "Wrong value!");
+
+         //Values that are too large for their section must not overwrite the neighbouring sections
+         constexpr Mask overflow{ 0xff, 0, 0 };
+         static_assert(overflow.Get<0>() == 7, "Wrong value!");
+         static_assert(overflow.Get<1>() == 0, "Wrong value!");
+
+         constexpr Bitmask<60, 40, 28> multiWord{ 1, 0xfffffffffeULL, 3 };
+         static_assert(multiWord.Get<1>() == 0xfffffffffeULL, "Wrong value!");
+         static_assert(multiWord.Get<2>() == 3, "Wrong value!");
+      }
+
       TEST_METHOD(Test_TwoFields_CopyCtor)
       {
          using Mask = Bitmask<3, 3>;
@@ -210,6 +230,156 @@ namespace mortanodevhelpertest
          //Assert::AreEqual(static_cast<uint8_t>(l3), m.Get<Section4()>());
       }
 
+      TEST_METHOD(Test_MultiWord_Set)
+      {
+         //96 bits, the second section lies completely in the second word
+         using Mask = Bitmask<64, 32>;
+         Mask m;
+
+         m.Set<0>(0x0123456789abcdefULL);
+         m.Set<1>(0xfedcba98U);
+
+         Assert::AreEqual(0x0123456789abcdefULL, m.Get<0>());
+         Assert::AreEqual(0xfedcba98U, m.Get<1>());
+      }
+
+      TEST_METHOD(Test_MultiWord_StraddlingSection)
+      {
+         //The second section covers bits 60 to 99 and thus straddles the first two words
+         using Mask = Bitmask<60, 40, 28>;
+         Mask m;
+
+         const auto l0 = 0x0fffffffffffffffULL;
+         const auto l1 = 0xa5a5a5a5a5ULL;
+         const auto l2 = 0x0abcdefU;
+
+         m.Set<0>(l0);
+         m.Set<1>(l1);
+         m.Set<2>(l2);
+
+         Assert::AreEqual(l0, m.Get<0>());
+         Assert::AreEqual(l1, m.Get<1>());
+         Assert::AreEqual(l2, m.Get<2>());
+
+         //Overwriting the straddling section must not touch its neighbours
+         m.Set<1>(0);
+         Assert::AreEqual(l0, m.Get<0>());
+         Assert::AreEqual(0ULL, m.Get<1>());
+         Assert::AreEqual(l2, m.Get<2>());
+
+         m.Set<1>(l1);
+         m.Set<0>(0);
+         m.Set<2>(0);
+         Assert::AreEqual(l1, m.Get<1>());
+      }
+
+      TEST_METHOD(Test_MultiWord_ArgsCtor)
+      {
+         using Mask = Bitmask<7, 64, 64, 50>;
+
+         Mask m{ 0x55, 0xffffffffffffffffULL, 0x8000000000000001ULL, 0x123456789ULL };
+
+         Assert::AreEqual(static_cast<uint8_t>(0x55), m.Get<0>());
+         Assert::AreEqual(0xffffffffffffffffULL, m.Get<1>());
+         Assert::AreEqual(0x8000000000000001ULL, m.Get<2>());
+         Assert::AreEqual(0x123456789ULL, m.Get<3>());
+
+         Mask copy{ m };
+         Assert::AreEqual(0x8000000000000001ULL, copy.Get<2>());
+      }
+
+      TEST_METHOD(Test_MultiWord_ManySections)
+      {
+         //256 bits made of odd sized sections, many of them straddle word boundaries
+         using Mask = Bitmask<13, 29, 31, 37, 41, 43, 47, 15>;
+         Mask m;
+
+         const uint64_t values[] = { 0x1abc, 0x1abcdef0, 0x7abcdef0, 0x1abcdef012ULL, 0x1abcdef0123ULL,
+            0x7abcdef0123ULL, 0x7abcdef01234ULL, 0x7abc };
+
+         m.Set<0>(static_cast<uint16_t>(values[0]));
+         m.Set<1>(static_cast<uint32_t>(values[1]));
+         m.Set<2>(static_cast<uint32_t>(values[2]));
+         m.Set<3>(values[3]);
+         m.Set<4>(values[4]);
+         m.Set<5>(values[5]);
+         m.Set<6>(values[6]);
+         m.Set<7>(static_cast<uint16_t>(values[7]));
+
+         Assert::AreEqual(values[0], static_cast<uint64_t>(m.Get<0>()));
+         Assert::AreEqual(values[1], static_cast<uint64_t>(m.Get<1>()));
+         Assert::AreEqual(values[2], static_cast<uint64_t>(m.Get<2>()));
+         Assert::AreEqual(values[3], static_cast<uint64_t>(m.Get<3>()));
+         Assert::AreEqual(values[4], static_cast<uint64_t>(m.Get<4>()));
+         Assert::AreEqual(values[5], static_cast<uint64_t>(m.Get<5>()));
+         Assert::AreEqual(values[6], static_cast<uint64_t>(m.Get<6>()));
+         Assert::AreEqual(values[7], static_cast<uint64_t>(m.Get<7>()));
+      }
+
+      TEST_METHOD(Test_SetMany)
+      {
+         using Mask = Bitmask<2, 4, 7, 3>;
+
+         Mask m{ 1, 2, 3, 4 };
+         m.SetMany<0, 2, 3>(2, 100, 5);
+
+         Assert::AreEqual(static_cast<uint8_t>(2), m.Get<0>());
+         Assert::AreEqual(static_cast<uint8_t>(2), m.Get<1>());
+         Assert::AreEqual(static_cast<uint8_t>(100), m.Get<2>());
+         Assert::AreEqual(static_cast<uint8_t>(5), m.Get<3>());
+
+         //Values that are too large must not overwrite the neighbouring sections
+         m.SetMany<1>(0xff);
+         Assert::AreEqual(static_cast<uint8_t>(2), m.Get<0>());
+         Assert::AreEqual(static_cast<uint8_t>(15), m.Get<1>());
+         Assert::AreEqual(static_cast<uint8_t>(100), m.Get<2>());
+      }
+
+      TEST_METHOD(Test_SetMany_MultiWord)
+      {
+         //The second and third section straddle word boundaries
+         using Mask = Bitmask<13, 60, 60, 20>;
+
+         Mask m{ 0x1fff, 0xfffffffffffffffULL, 0xfffffffffffffffULL, 0xfffff };
+         m.SetMany<2, 1>(0x123456789abcdefULL, 0xfedcba987654321ULL);
+
+         Assert::AreEqual(static_cast<uint16_t>(0x1fff), m.Get<0>());
+         Assert::AreEqual(0xfedcba987654321ULL, m.Get<1>());
+         Assert::AreEqual(0x123456789abcdefULL, m.Get<2>());
+         Assert::AreEqual(0xfffffU, m.Get<3>());
+      }
+
+      TEST_METHOD(Test_GetAll)
+      {
+         using Mask = Bitmask<3, 9, 4>;
+
+         const Mask m{ 5, 0x1ff, 0xa };
+         uint8_t first, third;
+         uint16_t second;
+         std::tie(first, second, third) = m.GetAll();
+         Assert::AreEqual(static_cast<uint8_t>(5), first);
+         Assert::AreEqual(static_cast<uint16_t>(0x1ff), second);
+         Assert::AreEqual(static_cast<uint8_t>(0xa), third);
+
+         Assert::IsTrue(std::make_tuple(static_cast<uint8_t>(0xa), static_cast<uint8_t>(5)) == m.GetMany<2, 0>());
+      }
+
+      TEST_METHOD(Test_Modify)
+      {
+         using Mask = Bitmask<3, 9, 4>;
+
+         Mask m{ 5, 0x1ff, 0xa };
+         m.Modify<0, 2>([](uint8_t& first, uint8_t& third) {
+            --first;
+            third = 1;
+         });
+         m.Modify<1>([](uint16_t& second) { second >>= 1; });
+
+         Assert::AreEqual(static_cast<uint8_t>(4), m.Get<0>());
+         Assert::AreEqual(static_cast<uint16_t>(0xff), m.Get<1>());
+         Assert::AreEqual(static_cast<uint8_t>(1), m.Get<2>());
+      }
+
       //Some static asserts
       static_assert(sizeof(Bitmask<>) == 1, "Wrong size!"); //TIL: Empty classes in C++ must have a non-zero size :D 
       static_assert(sizeof(Bitmask<0>) == 1, "Wrong size!");
@@ -224,6 +394,11 @@ namespace mortanodevhelpertest
       static_assert(sizeof(Bitmask<8,1>) == 2, "Wrong size!");
       static_assert(sizeof(Bitmask<1,8>) == 2, "Wrong size!");
 
+      static_assert(sizeof(Bitmask<64>) == 8, "Wrong size!");
+      static_assert(sizeof(Bitmask<64,1>) == 16, "Wrong size!");
+      static_assert(sizeof(Bitmask<64,32>) == 16, "Wrong size!");
+      static_assert(sizeof(Bitmask<64,64,64,64>) == 32, "Wrong size!");
+
    };
 
 }
@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\ConstexprVariant.h"
+
+#include <cstring>
+#include <type_traits>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct Opcode
+   {
+      constexpr Opcode(int code, int operands) : code(code), operands(operands) {}
+
+      int code;
+      int operands;
+   };
+
+   using Entry_t = mdv::ConstexprVariant<int, double, const char*, Opcode>;
+
+   //! A table that is built completely at compile time
+   constexpr Entry_t Table[] = {
+      Entry_t(42),
+      Entry_t(2.5),
+      Entry_t("name"),
+      Entry_t(mdv::InPlaceType<Opcode>(), 3, 2),
+      Entry_t()
+   };
+
+   //! Returns a number for each type, can be evaluated at compile time
+   struct ConstexprVisitor
+   {
+      constexpr int operator()(int val) const { return val; }
+      constexpr int operator()(double) const { return -1; }
+      constexpr int operator()(const char*) const { return -2; }
+      constexpr int operator()(const Opcode& op) const { return op.code; }
+   };
+
+   static_assert(std::is_trivially_copyable<Entry_t>::value, "ConstexprVariant has to be trivially copyable!");
+
+   static_assert(Table[0].Is<int>(), "Wrong type!");
+   static_assert(Table[0].Get<int>() == 42, "Wrong value!");
+   static_assert(Table[1].Get<double>() == 2.5, "Wrong value!");
+   static_assert(Table[3].Get<Opcode>().operands == 2, "Wrong value!");
+   static_assert(!Table[4].HasValue(), "Default constructed variant must be empty!");
+   static_assert(Table[0].Visit(ConstexprVisitor()) == 42, "Wrong visitation result!");
+   static_assert(Table[3].Visit(ConstexprVisitor()) == 3, "Wrong visitation result!");
+
+   //! Copies have to be constant expressions as well, which requires ConstexprVariant to be a literal type
+   constexpr Entry_t CopiedEntry = Table[3];
+   static_assert(CopiedEntry.Is<Opcode>() && CopiedEntry.Get<Opcode>().code == 3, "Wrong value!");
+
+	TEST_CLASS(ConstexprVariantTest)
+	{
+	public:
+
+      TEST_METHOD(Test_Ctor_Default)
+      {
+         Entry_t var;
+         Assert::IsFalse(var.HasValue());
+      }
+
+      TEST_METHOD(Test_Ctor_Value)
+      {
+         Entry_t var(23.0);
+         Assert::IsTrue(var.HasValue());
+         Assert::IsTrue(var.Is<double>());
+         Assert::IsFalse(var.Is<int>());
+         Assert::AreEqual(23.0, var.Get<double>());
+      }
+
+      TEST_METHOD(Test_Table_Runtime)
+      {
+         Assert::AreEqual(42, Table[0].Get<int>());
+         Assert::AreEqual(0, std::strcmp("name", Table[2].Get<const char*>()));
+         Assert::AreEqual(3, Table[3].Get<Opcode>().code);
+      }
+
+      TEST_METHOD(Test_Get_WrongType)
+      {
+         Assert::ExpectException<mdv::BadVariantAccess>([]() { Table[0].Get<double>(); });
+      }
+
+      TEST_METHOD(Test_Get_Modify)
+      {
+         Entry_t var(42);
+         var.Get<int>() = 23;
+         Assert::AreEqual(23, var.Get<int>());
+      }
+
+      TEST_METHOD(Test_CopyAndAssign)
+      {
+         Entry_t var(Table[1]);
+         Assert::AreEqual(2.5, var.Get<double>());
+
+         var = Table[3];
+         Assert::IsTrue(var.Is<Opcode>());
+         Assert::AreEqual(2, var.Get<Opcode>().operands);
+      }
+
+      TEST_METHOD(Test_Visit_Runtime)
+      {
+         for (size_t i = 0; i < 4; ++i)
+         {
+            const int expected[] = { 42, -1, -2, 3 };
+            Assert::AreEqual(expected[i], Table[i].Visit(ConstexprVisitor()));
+         }
+      }
+
+	};
+
+}
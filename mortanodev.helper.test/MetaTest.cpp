@@ -0,0 +1,89 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "meta\Meta.h"
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   template<typename T>
+   struct AddPointer
+   {
+      using type = T*;
+   };
+
+   template<size_t Idx>
+   struct Element {};
+
+   template<typename Indices>
+   struct LongList;
+
+   template<size_t... Is>
+   struct LongList<std::index_sequence<Is...>>
+   {
+      using type = meta::Typelist<Element<Is>...>;
+   };
+
+   TEST_CLASS(MetaTest)
+   {
+   public:
+      TEST_METHOD(Test_At)
+      {
+         using List_t = meta::Typelist<int, char, int, float>;
+         Assert::IsTrue(std::is_same<int, meta::At_t<0, List_t>>::value);
+         Assert::IsTrue(std::is_same<int, meta::At_t<2, List_t>>::value);
+         Assert::IsTrue(std::is_same<float, meta::At_t<3, List_t>>::value);
+
+         Assert::AreEqual(size_t(7), meta::At<2, meta::Numberlist<3, 5, 7>>::value);
+      }
+
+      TEST_METHOD(Test_IndexOfAndContains)
+      {
+         using List_t = meta::Typelist<int, char, int, float>;
+         Assert::AreEqual(size_t(0), static_cast<size_t>(meta::IndexOf<int, List_t>::value));
+         Assert::AreEqual(size_t(3), static_cast<size_t>(meta::IndexOf<float, List_t>::value));
+         Assert::AreEqual(static_cast<size_t>(-1), static_cast<size_t>(meta::IndexOf<double, List_t>::value));
+         Assert::AreEqual(static_cast<size_t>(-1), static_cast<size_t>(meta::IndexOf<int, meta::Typelist<>>::value));
+
+         Assert::IsTrue(meta::Contains<char, List_t>::value);
+         Assert::IsFalse(meta::Contains<double, List_t>::value);
+         Assert::IsFalse(meta::Contains<int, meta::Typelist<>>::value);
+      }
+
+      TEST_METHOD(Test_TakeReverseTransform)
+      {
+         using List_t = meta::Typelist<int, char, float>;
+         Assert::IsTrue(std::is_same<meta::Typelist<int, char>, meta::Take_t<2, List_t>>::value);
+         Assert::IsTrue(std::is_same<List_t, meta::Take_t<5, List_t>>::value);
+         Assert::IsTrue(std::is_same<meta::Typelist<>, meta::Take_t<0, List_t>>::value);
+         Assert::IsTrue(std::is_same<meta::Numberlist<1, 2>, meta::Take_t<2, meta::Numberlist<1, 2, 3>>>::value);
+
+         Assert::IsTrue(std::is_same<meta::Typelist<float, char, int>, meta::Reverse_t<List_t>>::value);
+         Assert::IsTrue(std::is_same<meta::Typelist<>, meta::Reverse_t<meta::Typelist<>>>::value);
+
+         Assert::IsTrue(std::is_same<meta::Typelist<int*, char*, float*>,
+            meta::Transform_t<AddPointer, List_t>>::value);
+      }
+
+      TEST_METHOD(Test_Sum)
+      {
+         Assert::AreEqual(size_t(0), meta::Sum<meta::Numberlist<>>::value);
+         Assert::AreEqual(size_t(15), meta::Sum<meta::Numberlist<1, 2, 3, 4, 5>>::value);
+      }
+
+      TEST_METHOD(Test_LongLists)
+      {
+         //Far beyond the default instantiation depth of most compilers, which a recursive implementation would need
+         using List_t = LongList<std::make_index_sequence<2000>>::type;
+         Assert::IsTrue(std::is_same<Element<1234>, meta::At_t<1234, List_t>>::value);
+         Assert::AreEqual(size_t(1999), static_cast<size_t>(meta::IndexOf<Element<1999>, List_t>::value));
+         Assert::IsTrue(std::is_same<Element<1999>, meta::At_t<0, meta::Reverse_t<List_t>>>::value);
+         Assert::AreEqual(size_t(1500), meta::Size<meta::Take_t<1500, List_t>>::value);
+      }
+
+   };
+
+}
@@ -3,6 +3,7 @@
 
 #include "structures\Bitmask.h"
 
+#include <tuple>
 #include <vector>
 
 using namespace mdv;
@@ -32,6 +33,10 @@ namespace mortanodevhelpertest
 
    struct _LargeSection : std::integral_constant<size_t, 32> {};
 
+   struct _Timestamp : std::integral_constant<size_t, 48> {};
+   struct _Source : std::integral_constant<size_t, 40> {};
+   struct _Flags : std::integral_constant<size_t, 24> {};
+
    TEST_CLASS(NamedBitmaskTest)
    {
    public:
@@ -189,11 +194,91 @@ namespace mortanodevhelpertest
          Assert::AreEqual(static_cast<uint8_t>(l3), m.Get<_Section4>());
       }
 
+      TEST_METHOD(Test_MultiWord_Set)
+      {
+         //112 bits, _Source straddles the first two words
+         using Mask = NamedBitmask<_Timestamp, _Source, _Flags>;
+         Mask m;
+
+         const auto l0 = 0xfedcba987654ULL;
+         const auto l1 = 0x9876543210ULL;
+         const auto l2 = 0xabcdefU;
+
+         m.Set<_Timestamp>(l0);
+         m.Set<_Source>(l1);
+         m.Set<_Flags>(l2);
+
+         Assert::AreEqual(l0, m.Get<_Timestamp>());
+         Assert::AreEqual(l1, m.Get<_Source>());
+         Assert::AreEqual(l2, m.Get<_Flags>());
+      }
+
+      TEST_METHOD(Test_MultiWord_ArgsCtor)
+      {
+         using Mask = NamedBitmask<_Timestamp, _Source, _Flags>;
+
+         Mask m{ 0xfedcba987654ULL, 0x9876543210ULL, 0xabcdefU };
+
+         Assert::AreEqual(0xfedcba987654ULL, m.Get<_Timestamp>());
+         Assert::AreEqual(0x9876543210ULL, m.Get<_Source>());
+         Assert::AreEqual(0xabcdefU, m.Get<_Flags>());
+      }
+
+      TEST_METHOD(Test_SetMany)
+      {
+         using Mask = NamedBitmask<_Section1, _Section2, _Section3, _Section4>;
+
+         Mask m{ 1, 2, 3, 4 };
+         m.SetMany<_Section4, _Section2>(7, 15);
+
+         Assert::AreEqual(static_cast<uint8_t>(1), m.Get<_Section1>());
+         Assert::AreEqual(static_cast<uint8_t>(15), m.Get<_Section2>());
+         Assert::AreEqual(static_cast<uint8_t>(3), m.Get<_Section3>());
+         Assert::AreEqual(static_cast<uint8_t>(7), m.Get<_Section4>());
+      }
+
+      TEST_METHOD(Test_GetAll)
+      {
+         using Mask = NamedBitmask<_Timestamp, _Source, _Flags>;
+
+         const Mask m{ 0xfedcba987654ULL, 0x9876543210ULL, 0xabcdefU };
+
+         uint64_t timestamp, source;
+         uint32_t flags;
+         std::tie(timestamp, source, flags) = m.GetAll();
+         Assert::AreEqual(0xfedcba987654ULL, timestamp);
+         Assert::AreEqual(0x9876543210ULL, source);
+         Assert::AreEqual(0xabcdefU, flags);
+
+         const auto some = m.GetMany<_Flags, _Timestamp>();
+         Assert::AreEqual(0xabcdefU, std::get<0>(some));
+         Assert::AreEqual(0xfedcba987654ULL, std::get<1>(some));
+      }
+
+      TEST_METHOD(Test_Modify)
+      {
+         using Mask = NamedBitmask<_Timestamp, _Source, _Flags>;
+
+         Mask m{ 0xfedcba987654ULL, 0x9876543210ULL, 0xabcdefU };
+         m.Modify<_Source, _Flags>([](uint64_t& source, uint32_t& flags) {
+            ++source;
+            flags &= 0xff;
+         });
+         m.Modify<_Timestamp>([](uint64_t& timestamp) { timestamp = 0; });
+
+         Assert::AreEqual(0ULL, m.Get<_Timestamp>());
+         Assert::AreEqual(0x9876543211ULL, m.Get<_Source>());
+         Assert::AreEqual(0xefU, m.Get<_Flags>());
+      }
+
       //Some static asserts
       static_assert(sizeof(NamedBitmask<>) == 1, "Wrong size!"); 
       static_assert(sizeof(NamedBitmask<_SectionOneBit>) == 1, "Wrong size!");
       static_assert(sizeof(NamedBitmask<_SectionEightBit>) == 1, "Wrong size!");
       static_assert(sizeof(NamedBitmask<_LargeSection>) == 4, "Wrong size!");
+      static_assert(sizeof(NamedBitmask<_Timestamp, _Source, _Flags>) == 16, "Wrong size!");
+
+      static_assert(NamedBitmask<_Timestamp, _Source, _Flags>(1, 2, 3).Get<_Source>() == 2, "Wrong value!");
 
       static_assert(sizeof(NamedBitmask<_Section1, _Section2>) == 1, "Wrong size!");
       static_assert(sizeof(NamedBitmask<_Section3, _SectionOneBit>) == 1, "Wrong size!");
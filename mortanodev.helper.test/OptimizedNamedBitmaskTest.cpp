@@ -0,0 +1,108 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\OptimizedNamedBitmask.h"
+
+#include <unordered_set>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct _Small : std::integral_constant<size_t, 3> {};
+   struct _Medium : std::integral_constant<size_t, 12> {};
+   struct _Large : std::integral_constant<size_t, 20> {};
+   struct _Index : std::integral_constant<size_t, 7> {};
+
+   struct _Twenty : std::integral_constant<size_t, 20> {};
+   struct _Fifty : std::integral_constant<size_t, 50> {};
+   struct _Forty : std::integral_constant<size_t, 40> {};
+   struct _Ten : std::integral_constant<size_t, 10> {};
+   struct _Spare : std::integral_constant<size_t, 3> {};
+
+   template<typename L, typename R>
+   struct SmallerSize : std::integral_constant<bool, (sizeof(L) < sizeof(R))> {};
+
+   TEST_CLASS(OptimizedNamedBitmaskTest)
+   {
+   public:
+      TEST_METHOD(Test_MetaSortIsStable)
+      {
+         using Sorted_t = meta::Sort_t<SmallerSize, meta::Typelist<int64_t, uint8_t, int32_t, int8_t, uint32_t>>;
+         Assert::IsTrue(std::is_same<meta::Typelist<uint8_t, int8_t, int32_t, uint32_t, int64_t>, Sorted_t>::value);
+         Assert::IsTrue(std::is_same<meta::Typelist<>, meta::Sort_t<SmallerSize, meta::Typelist<>>>::value);
+
+         using Erased_t = meta::EraseAt_t<1, meta::Typelist<int, char, float>>;
+         Assert::IsTrue(std::is_same<meta::Typelist<int, float>, Erased_t>::value);
+      }
+
+      TEST_METHOD(Test_HotSectionAtOffsetZero)
+      {
+         using Mask_t = OptimizedNamedBitmask<_Small, _Medium, Hot<_Index>, _Large>;
+         Assert::IsTrue(std::is_same<meta::Typelist<_Index, _Large, _Medium, _Small>, Mask_t::Layout>::value);
+         Assert::AreEqual(sizeof(NamedBitmask<_Small, _Medium, _Index, _Large>), sizeof(Mask_t));
+
+         Mask_t mask{ 5, 1000, 99, 500000 };
+         Assert::AreEqual(static_cast<uint8_t>(5), mask.Get<_Small>());
+         Assert::AreEqual(static_cast<uint16_t>(1000), mask.Get<_Medium>());
+         Assert::AreEqual(static_cast<uint8_t>(99), mask.Get<_Index>());
+         Assert::AreEqual(500000U, mask.Get<_Large>());
+
+         //The hot section is stored in the lowest bits of the storage word
+         Assert::AreEqual(99ULL, static_cast<unsigned long long>(detail::SingleWord<Mask_t>::ToWord(mask) & 0x7f));
+      }
+
+      TEST_METHOD(Test_MultiWordAvoidsStraddling)
+      {
+         //In declaration order, _Fifty straddles the first two words. The optimized layout puts _Ten next to
+         //_Fifty, pads the rest of the first word and fits _Forty and _Twenty into the second word
+         using Mask_t = OptimizedNamedBitmask<_Twenty, _Fifty, _Forty, _Ten>;
+         using Expected_t = meta::Typelist<_Fifty, _Ten, detail::layout::Padding<60, 4>, _Forty, _Twenty>;
+         Assert::IsTrue(std::is_same<Expected_t, Mask_t::Layout>::value);
+         Assert::AreEqual(sizeof(NamedBitmask<_Twenty, _Fifty, _Forty, _Ten>), sizeof(Mask_t));
+
+         Mask_t mask{ 0xfffff, 0x3ffffffffffffULL, 0x123456789ULL, 0x3ff };
+         mask.Set<_Ten>(0x155);
+         Assert::AreEqual(0xfffffU, mask.Get<_Twenty>());
+         Assert::AreEqual(0x3ffffffffffffULL, static_cast<unsigned long long>(mask.Get<_Fifty>()));
+         Assert::AreEqual(0x123456789ULL, static_cast<unsigned long long>(mask.Get<_Forty>()));
+         Assert::AreEqual(static_cast<uint16_t>(0x155), mask.Get<_Ten>());
+      }
+
+      TEST_METHOD(Test_NoSpareBitsForPadding)
+      {
+         //128 bits in two words, a section has to straddle and no padding can be added
+         using Mask_t = OptimizedNamedBitmask<_Fifty, _Small, _Spare, _Forty, Hot<_Medium>, _Twenty>;
+         using Expected_t = meta::Typelist<_Medium, _Fifty, _Forty, _Twenty, _Small, _Spare>;
+         Assert::IsTrue(std::is_same<Expected_t, Mask_t::Layout>::value);
+         Assert::AreEqual(sizeof(uint64_t) * 2, sizeof(Mask_t));
+
+         Mask_t mask{ 1, 2, 3, 0xfedcba9876ULL, 5, 6 };
+         Assert::AreEqual(0xfedcba9876ULL, static_cast<unsigned long long>(mask.Get<_Forty>()));
+         Assert::AreEqual(static_cast<uint8_t>(3), mask.Get<_Spare>());
+         Assert::AreEqual(static_cast<uint16_t>(5), mask.Get<_Medium>());
+      }
+
+      TEST_METHOD(Test_DeclarationOrder)
+      {
+         using Mask_t = OptimizedNamedBitmask<_Small, Hot<_Medium>, _Large>;
+         constexpr Mask_t mask{ 2, 3, 4 };
+         static_assert(mask.Get<_Medium>() == 3, "Constructor must be constexpr");
+
+         const auto all = mask.GetAll();
+         Assert::IsTrue(std::make_tuple(static_cast<uint8_t>(2), static_cast<uint16_t>(3), 4U) == all);
+
+         Mask_t other;
+         other.SetMany<_Large, _Small>(4, 2);
+         other.Modify<_Medium>([](uint16_t& medium) { medium = 3; });
+         Assert::IsTrue(mask == other);
+
+         std::unordered_set<Mask_t> set{ mask, other, Mask_t(1, 1, 1) };
+         Assert::AreEqual(size_t(2), set.size());
+      }
+
+   };
+
+}
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\PackedTuple.h"
+
+#include <string>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   struct PaddedRecord
+   {
+      char a;
+      double b;
+      char c;
+      int d;
+   };
+
+   template<typename L, typename R>
+   struct SmallerAlignment : std::integral_constant<bool, (alignof(L) < alignof(R))> {};
+
+   TEST_CLASS(PackedTupleTest)
+   {
+   public:
+      TEST_METHOD(Test_SortPermutation)
+      {
+         using List_t = meta::Typelist<double, char, int, char, double>;
+         Assert::IsTrue(std::is_same<meta::Numberlist<1, 3, 2, 0, 4>,
+            meta::SortPermutation_t<SmallerAlignment, List_t>>::value);
+         Assert::IsTrue(std::is_same<meta::Typelist<char, char, int, double, double>,
+            meta::Sort_t<SmallerAlignment, List_t>>::value);
+
+         Assert::IsTrue(std::is_same<meta::Numberlist<2, 0, 1>,
+            meta::InversePermutation_t<meta::Numberlist<1, 2, 0>>>::value);
+         Assert::IsTrue(std::is_same<meta::Numberlist<>, meta::InversePermutation_t<meta::Numberlist<>>>::value);
+         Assert::IsTrue(std::is_same<meta::Numberlist<>,
+            meta::SortPermutation_t<SmallerAlignment, meta::Typelist<>>>::value);
+      }
+
+      TEST_METHOD(Test_NoPadding)
+      {
+         using Tuple_t = PackedTuple<char, double, char, int>;
+         Assert::IsTrue(std::is_same<meta::Typelist<double, int, char, char>, Tuple_t::Layout>::value);
+         Assert::IsTrue(std::is_same<meta::Numberlist<1, 3, 0, 2>, Tuple_t::Order>::value);
+         Assert::IsTrue(std::is_same<meta::Numberlist<2, 0, 3, 1>, Tuple_t::Positions>::value);
+
+         Assert::AreEqual(sizeof(PaddedRecord), size_t(24));
+         Assert::AreEqual(size_t(16), sizeof(Tuple_t));
+         Assert::AreEqual(alignof(double), alignof(Tuple_t));
+      }
+
+      TEST_METHOD(Test_GetInDeclarationOrder)
+      {
+         PackedTuple<uint8_t, uint64_t, uint16_t, uint8_t> tuple{ 1, 2, 3, 4 };
+         Assert::AreEqual(static_cast<uint8_t>(1), tuple.Get<0>());
+         Assert::AreEqual(2ULL, static_cast<unsigned long long>(tuple.Get<1>()));
+         Assert::AreEqual(static_cast<uint16_t>(3), tuple.Get<2>());
+         Assert::AreEqual(static_cast<uint8_t>(4), tuple.Get<3>());
+
+         tuple.Get<uint16_t>() = 30;
+         tuple.Get<0>() = 10;
+         Assert::AreEqual(static_cast<uint16_t>(30), tuple.Get<2>());
+         Assert::AreEqual(static_cast<uint8_t>(10), tuple.Get<0>());
+         Assert::AreEqual(static_cast<uint8_t>(4), tuple.Get<3>());
+
+         const PackedTuple<uint8_t, uint64_t, uint16_t, uint8_t> empty;
+         Assert::AreEqual(0ULL, static_cast<unsigned long long>(empty.Get<uint64_t>()));
+         Assert::IsTrue(empty != tuple);
+         Assert::IsTrue(PackedTuple<uint8_t, uint64_t, uint16_t, uint8_t>(10, 2, 30, 4) == tuple);
+      }
+
+      TEST_METHOD(Test_Constexpr)
+      {
+         constexpr PackedTuple<char, int64_t, int16_t> tuple{ 'x', 42, 7 };
+         static_assert(tuple.Get<int64_t>() == 42, "Get must be constexpr");
+         static_assert(tuple.Get<0>() == 'x', "Get must be constexpr");
+         Assert::AreEqual(static_cast<int16_t>(7), tuple.Get<2>());
+      }
+
+      TEST_METHOD(Test_NonTrivialMembers)
+      {
+         PackedTuple<char, std::string, int> tuple{ 'a', "Hello packed tuple, long enough to allocate", 5 };
+         auto copy = tuple;
+         copy.Get<std::string>() += "!";
+         Assert::AreEqual(std::string("Hello packed tuple, long enough to allocate"), tuple.Get<1>());
+         Assert::AreEqual(std::string("Hello packed tuple, long enough to allocate!"), copy.Get<1>());
+
+         auto moved = std::move(copy);
+         Assert::AreEqual('a', moved.Get<char>());
+         Assert::AreEqual(5, moved.Get<int>());
+      }
+
+   };
+
+}
@@ -0,0 +1,139 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\SoAVector.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   //! Throws when it is constructed from a negative value
+   struct Checked
+   {
+      Checked(int v) : value(v)
+      {
+         if (v < 0)
+            throw std::invalid_argument("negative");
+      }
+
+      int value;
+   };
+
+   using Record_t = SoAVector<meta::Typelist<uint32_t, float, double, std::string>>;
+
+   TEST_CLASS(SoAVectorTest)
+   {
+   public:
+      TEST_METHOD(Test_PushBackAndRows)
+      {
+         Record_t records;
+         Assert::IsTrue(records.Empty());
+         records.PushBack(1, 2.5f, 3.0, "first");
+         records.Emplace(4, 5.5f, 6.0, std::string("second"));
+         Assert::AreEqual(size_t(2), records.Size());
+
+         auto row = records[1];
+         Assert::AreEqual(size_t(1), row.Index());
+         Assert::AreEqual(4U, row.Get<0>());
+         Assert::AreEqual(5.5f, row.Get<float>());
+         Assert::AreEqual(std::string("second"), row.Get<std::string>());
+
+         row.Get<double>() = 60.0;
+         row.Get<3>() += "!";
+         const Record_t& constRecords = records;
+         Record_t::ConstRow constRow = records[1];
+         Assert::AreEqual(60.0, constRecords[1].Get<2>());
+         Assert::IsTrue(std::make_tuple(4U, 5.5f, 60.0, std::string("second!")) == constRow.Values());
+
+         records.PopBack();
+         Assert::AreEqual(size_t(1), records.Size());
+         Assert::AreEqual(std::string("first"), records[0].Get<3>());
+      }
+
+      TEST_METHOD(Test_ColumnsAreAlignedAndContiguous)
+      {
+         SoAVector<meta::Typelist<uint8_t, double, uint16_t>> records;
+         for (size_t i = 0; i < 1000; ++i)
+         {
+            records.PushBack(static_cast<uint8_t>(i), static_cast<double>(i), static_cast<uint16_t>(i * 2));
+         }
+
+         const auto doubles = records.Column<double>();
+         const auto shorts = records.Column<2>();
+         Assert::AreEqual(size_t(1000), doubles.Size());
+         Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(doubles.Data()) % 64);
+         Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(shorts.Data()) % 64);
+         Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(records.Column<0>().Data()) % 64);
+
+         Assert::AreEqual(999.0 * 1000.0 / 2.0, std::accumulate(doubles.begin(), doubles.end(), 0.0));
+         Assert::AreEqual(static_cast<uint16_t>(1998), shorts[999]);
+
+         for (auto& value : records.Column<uint8_t>())
+         {
+            value = 7;
+         }
+         Assert::AreEqual(static_cast<uint8_t>(7), records[500].Get<0>());
+      }
+
+      TEST_METHOD(Test_DuplicateTypesByIndex)
+      {
+         SoAVector<meta::Typelist<float, float, int>> records;
+         records.PushBack(1.f, 2.f, 3);
+         records.Resize(3);
+         Assert::AreEqual(size_t(3), records.Column<1>().Size());
+         Assert::AreEqual(2.f, records[0].Get<1>());
+         Assert::AreEqual(0.f, records[2].Get<1>());
+         Assert::AreEqual(0, records[2].Get<int>());
+
+         records.Reserve(100);
+         records.Clear();
+         Assert::IsTrue(records.Empty());
+         Assert::IsTrue(records.Column<0>().Empty());
+      }
+
+      //! bool columns are stored in a byte per record instead of std::vector<bool>, so they have a data pointer
+      TEST_METHOD(Test_BoolColumn)
+      {
+         SoAVector<meta::Typelist<int, bool>> records;
+         for (int i = 0; i < 100; ++i)
+         {
+            records.PushBack(i, i % 3 == 0);
+         }
+         records.Resize(101);
+
+         auto flags = records.Column<bool>();
+         Assert::AreEqual(size_t(101), flags.Size());
+         Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(flags.Data()) % 64);
+         Assert::AreEqual(std::ptrdiff_t(34), std::count(flags.begin(), flags.end(), true));
+         Assert::IsFalse(flags[100]);
+
+         records[1].Get<bool>() = true;
+         bool& flag = records[2].Get<1>();
+         flag = true;
+         const auto& constRecords = records;
+         Assert::IsTrue(constRecords.Column<1>()[1]);
+         Assert::IsTrue(std::make_tuple(2, true) == constRecords[2].Values());
+      }
+
+      TEST_METHOD(Test_FailedEmplaceKeepsColumnsInSync)
+      {
+         SoAVector<meta::Typelist<int, Checked, std::unique_ptr<int>>> records;
+         records.Emplace(1, 2, std::make_unique<int>(3));
+         Assert::ExpectException<std::invalid_argument>([&]() { records.Emplace(4, -1, std::make_unique<int>(6)); });
+
+         Assert::AreEqual(size_t(1), records.Size());
+         Assert::AreEqual(size_t(1), records.Column<0>().Size());
+         Assert::AreEqual(size_t(1), records.Column<2>().Size());
+         Assert::AreEqual(3, *records[0].Get<2>());
+      }
+
+   };
+
+}
@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "meta\TypeRegistry.h"
+#include "structures\VariantTypeId.h"
+
+#include <string>
+
+namespace mortanodevhelpertest
+{
+   struct Position { float x, y; };
+   struct Velocity { float x, y; };
+   struct Health { int32_t value; };
+   struct Name { std::string value; };
+}
+
+MDV_TYPE_NAME(mortanodevhelpertest::Position, "test::Position")
+MDV_TYPE_NAME(mortanodevhelpertest::Velocity, "test::Velocity")
+MDV_TYPE_NAME(mortanodevhelpertest::Health, "test::Health")
+MDV_TYPE_NAME(mortanodevhelpertest::Name, "test::Name")
+
+using namespace mdv;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   TEST_CLASS(TypeRegistryTest)
+   {
+   public:
+      TEST_METHOD(Test_TypeId)
+      {
+         // FNV-1a reference values
+         Assert::AreEqual(0xcbf29ce484222325ULL, static_cast<unsigned long long>(detail::registry::HashName("")));
+         Assert::AreEqual(0xaf63dc4c8601ec8cULL, static_cast<unsigned long long>(detail::registry::HashName("a")));
+
+         static_assert(TypeId<int32_t>::value == detail::registry::HashName("int32"), "");
+         static_assert(TypeId<Position>::value != TypeId<Velocity>::value, "");
+      }
+
+      TEST_METHOD(Test_IndexOf)
+      {
+         using List_t = meta::Typelist<Position, Velocity, Health, Name, float, double>;
+         using Registry_t = TypeRegistry<List_t>;
+
+         Assert::AreEqual(size_t(6), Registry_t::TypeCount);
+         for (size_t idx = 0; idx < Registry_t::TypeCount; ++idx)
+         {
+            Assert::AreEqual(idx, Registry_t::IndexOf(Registry_t::IdAt(idx)));
+         }
+         Assert::AreEqual(size_t(2), Registry_t::IndexOf(TypeId<Health>::value));
+         Assert::AreEqual(size_t(5), Registry_t::IndexOf(TypeId<double>::value));
+
+         Assert::AreEqual(Registry_t::NotFound, Registry_t::IndexOf(TypeId<int32_t>::value));
+         Assert::AreEqual(Registry_t::NotFound, Registry_t::IndexOf(0));
+      }
+
+      TEST_METHOD(Test_IndexOf_Edges)
+      {
+         Assert::AreEqual(meta::detail::NotFound, TypeRegistry<meta::Typelist<>>::IndexOf(TypeId<float>::value));
+
+         using Single_t = TypeRegistry<meta::Typelist<Name>>;
+         Assert::AreEqual(size_t(0), Single_t::IndexOf(TypeId<Name>::value));
+         Assert::AreEqual(Single_t::NotFound, Single_t::IndexOf(TypeId<Health>::value));
+      }
+
+      TEST_METHOD(Test_IndexOf_AllBuiltins)
+      {
+         using List_t = meta::Typelist<bool, char, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
+            uint64_t, float, double, std::string, Position, Velocity, Health, Name>;
+         using Registry_t = TypeRegistry<List_t>;
+
+         for (size_t idx = 0; idx < Registry_t::TypeCount; ++idx)
+         {
+            Assert::AreEqual(idx, Registry_t::IndexOf(Registry_t::IdAt(idx)));
+         }
+         Assert::AreEqual(size_t(12), Registry_t::IndexOf(TypeId<std::string>::value));
+      }
+
+      TEST_METHOD(Test_Variant_TypeId)
+      {
+         using Variant_t = Variant<Position, Health, Name>;
+
+         Assert::AreEqual(size_t(1), IndexOfTypeId<Variant_t>(TypeId<Health>::value));
+         Assert::AreEqual(VariantTypeRegistry_t<Variant_t>::NotFound, IndexOfTypeId<Variant_t>(TypeId<Velocity>::value));
+
+         Variant_t variant{ Name{ "abc" } };
+         Assert::AreEqual(TypeId<Name>::value, ActiveTypeId(variant));
+         variant = Health{ 42 };
+         Assert::AreEqual(TypeId<Health>::value, ActiveTypeId(variant));
+      }
+
+      TEST_METHOD(Test_Variant_EmplaceTypeId)
+      {
+         using Variant_t = Variant<Position, Health, Name>;
+         Variant_t variant{ Health{ 42 } };
+
+         // Round trip through the type tag, as a deserializer would do it
+         const auto tag = ActiveTypeId(Variant_t{ Name{ "abc" } });
+         Assert::IsTrue(EmplaceTypeId(variant, tag));
+         Assert::IsTrue(variant.Is<Name>());
+         Assert::IsTrue(variant.Get<Name>().value.empty());
+         variant.Get<Name>().value = "abc";
+         Assert::AreEqual(std::string("abc"), variant.Get<Name>().value);
+
+         Assert::IsFalse(EmplaceTypeId(variant, TypeId<Velocity>::value));
+         Assert::IsFalse(variant.HasValue());
+      }
+   };
+}
@@ -0,0 +1,240 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\Variant.h"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+   size_t AllocationCount = 0;
+   size_t DeallocationCount = 0;
+}
+
+//Global allocation hooks that count every allocation and deallocation made by this module
+
+void* operator new(size_t size)
+{
+   ++AllocationCount;
+   if (auto mem = std::malloc(size ? size : 1))
+      return mem;
+   throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+   return operator new(size);
+}
+
+void operator delete(void* mem) noexcept
+{
+   if (!mem)
+      return;
+   ++DeallocationCount;
+   std::free(mem);
+}
+
+void operator delete[](void* mem) noexcept
+{
+   operator delete(mem);
+}
+
+void operator delete(void* mem, size_t) noexcept
+{
+   operator delete(mem);
+}
+
+void operator delete[](void* mem, size_t) noexcept
+{
+   operator delete(mem);
+}
+
+namespace mortanodevhelpertest
+{
+
+   //! Records the number of allocations and deallocations that happen during its lifetime
+   struct AllocationScope
+   {
+      AllocationScope() :
+         _allocationsBefore(AllocationCount),
+         _deallocationsBefore(DeallocationCount)
+      {
+      }
+
+      size_t Allocations() const { return AllocationCount - _allocationsBefore; }
+      size_t Deallocations() const { return DeallocationCount - _deallocationsBefore; }
+
+   private:
+      size_t _allocationsBefore;
+      size_t _deallocationsBefore;
+   };
+
+   //! Counts the allocations and deallocations of the given operation
+   template<typename Func>
+   std::pair<size_t, size_t> CountAllocations(Func&& func)
+   {
+      AllocationScope scope;
+      func();
+      return{ scope.Allocations(), scope.Deallocations() };
+   }
+
+   //! Long enough to never fit into the small string buffer
+   const std::string LongString(128, 'x');
+
+   //! The operations on Variant must not allocate more (or less) than the same operations on the stored type
+   //! itself. Comparing with the plain type instead of hardcoding numbers keeps the tests valid for standard
+   //! libraries that allocate additional bookkeeping data in debug builds
+	TEST_CLASS(VariantAllocationTest)
+	{
+	public:
+
+      TEST_METHOD(Test_String_CopyFromValue)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         const auto expected = CountAllocations([]() { std::string copy(LongString); });
+         const auto actual = CountAllocations([]() { Var_t copy(LongString); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_String_MoveFromValue)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         std::string src1(LongString);
+         std::string src2(LongString);
+
+         const auto expected = CountAllocations([&src1]() { std::string moved(std::move(src1)); });
+         const auto actual = CountAllocations([&src2]() { Var_t moved(std::move(src2)); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_String_CopyCtor)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         const std::string str(LongString);
+         const Var_t var(LongString);
+
+         const auto expected = CountAllocations([&str]() { std::string copy(str); });
+         const auto actual = CountAllocations([&var]() { Var_t copy(var); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_String_MoveCtor)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         std::string str(LongString);
+         Var_t var(LongString);
+
+         const auto expected = CountAllocations([&str]() { std::string moved(std::move(str)); });
+         const auto actual = CountAllocations([&var]() { Var_t moved(std::move(var)); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_String_Destroy)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         auto str = new std::string(LongString);
+         auto var = new Var_t(LongString);
+
+         //Only count the destruction of the string, not the deallocation of the heap block holding it
+         auto expected = CountAllocations([str]() { str->~basic_string(); });
+         auto actual = CountAllocations([var]() { var->Clear(); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+
+         operator delete(str);
+         delete var;
+      }
+
+      TEST_METHOD(Test_String_CopyAssign)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         const std::string srcStr(LongString);
+         std::string dstStr(LongString);
+         const Var_t srcVar(LongString);
+         Var_t dstVar(LongString);
+
+         //Both hold a string, so Variant assigns it and the string can reuse its buffer
+         const auto expected = CountAllocations([&]() { dstStr = srcStr; });
+         const auto actual = CountAllocations([&]() { dstVar = srcVar; });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_String_VariantLifetime)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         const auto expected = CountAllocations([]() {
+            std::string str(LongString);
+            std::string copy(str);
+            std::string moved(std::move(copy));
+         });
+         const auto actual = CountAllocations([]() {
+            Var_t var(LongString);
+            Var_t copy(var);
+            Var_t moved(std::move(copy));
+            var = 42;
+            copy.Clear();
+         });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+         //Everything that was allocated must have been freed again
+         Assert::AreEqual(actual.first, actual.second);
+      }
+
+      TEST_METHOD(Test_Vector_CopyAndDestroy)
+      {
+         using Var_t = mdv::Variant<float, std::vector<int>>;
+
+         const std::vector<int> vec(64, 42);
+         const Var_t var(vec);
+
+         const auto expected = CountAllocations([&vec]() { std::vector<int> copy(vec); });
+         const auto actual = CountAllocations([&var]() { Var_t copy(var); });
+
+         Assert::AreEqual(expected.first, actual.first);
+         Assert::AreEqual(expected.second, actual.second);
+      }
+
+      TEST_METHOD(Test_Trivial_NoAllocations)
+      {
+         using Var_t = mdv::Variant<int, float, double>;
+
+         const auto actual = CountAllocations([]() {
+            Var_t var(42);
+            Var_t copy(var);
+            Var_t moved(std::move(copy));
+            moved = 23.0;
+            var.Clear();
+         });
+
+         Assert::AreEqual<size_t>(0, actual.first);
+         Assert::AreEqual<size_t>(0, actual.second);
+      }
+
+	};
+
+}
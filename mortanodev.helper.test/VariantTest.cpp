@@ -3,7 +3,10 @@
 
 #include "structures\Variant.h"
 
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -42,6 +45,62 @@ namespace mortanodevhelpertest
    size_t Counter::MoveCtorCalls = 0;
    size_t Counter::DtorCalls = 0;
 
+   //! Type that can be copied but not moved
+   struct NonMoveable
+   {
+      explicit NonMoveable(int val) : value(val) {}
+      NonMoveable(const NonMoveable&) = default;
+      NonMoveable(NonMoveable&&) = delete;
+
+      int value;
+   };
+
+   //! Type that can be constructed but not assigned
+   struct NonAssignable
+   {
+      explicit NonAssignable(int val) : value(val) {}
+
+      const int value;
+   };
+
+   //! Type without assignment and without a nothrow move whose copy can be made to throw. Counts the living
+   //! instances, so that a double destruction shows up
+   struct ThrowingCopy
+   {
+      static int Alive;
+
+      explicit ThrowingCopy(bool throwOnCopy) : throwOnCopy(throwOnCopy) { ++Alive; }
+      ThrowingCopy(const ThrowingCopy& other) : throwOnCopy(other.throwOnCopy)
+      {
+         if (throwOnCopy)
+            throw std::runtime_error("ThrowingCopy");
+         ++Alive;
+      }
+      ThrowingCopy& operator=(const ThrowingCopy&) = delete;
+      ~ThrowingCopy() { --Alive; }
+
+      bool throwOnCopy;
+   };
+
+   int ThrowingCopy::Alive = 0;
+
+   //! Type whose constructor always throws
+   struct ThrowingCtor
+   {
+      ThrowingCtor() { throw std::runtime_error("ThrowingCtor"); }
+   };
+
+   //! Encodes the combination of the visited types so that every cell of a dispatch table can be checked
+   struct PairVisitor
+   {
+      int Code(int) const { return 0; }
+      int Code(float) const { return 1; }
+      int Code(char) const { return 2; }
+
+      template<typename L, typename R>
+      int operator()(L l, R r) const { return Code(l) * 10 + Code(r); }
+   };
+
 	TEST_CLASS(VariantTest)
 	{
 	public:
@@ -789,6 +848,366 @@ namespace mortanodevhelpertest
       }
 
 
+      TEST_METHOD(Test_Visit_OneVariant)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, std::string>;
+
+         struct Visitor
+         {
+            std::string operator()(int val) const { return std::to_string(val); }
+            std::string operator()(const std::string& val) const { return val + "!"; }
+         };
+
+         Var_t v1(42);
+         Var_t v2("Hello"s);
+
+         Assert::AreEqual("42"s, mdv::Visit(Visitor(), v1));
+         Assert::AreEqual("Hello!"s, mdv::Visit(Visitor(), v2));
+
+         const Var_t& constRef = v2;
+         Assert::AreEqual("Hello!"s, mdv::Visit(Visitor(), constRef));
+      }
+
+      TEST_METHOD(Test_Visit_ModifiesValue)
+      {
+         using Var_t = mdv::Variant<int, float>;
+
+         Var_t v(42);
+
+         mdv::Visit([](auto& val) { val += 1; }, v);
+
+         Assert::IsTrue(v.Is<int>());
+         Assert::AreEqual(43, v.Get<int>());
+      }
+
+      TEST_METHOD(Test_Visit_MovesFromRvalue)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t v("Hello"s);
+
+         std::string moved;
+         mdv::Visit(mdv::MakeOverloaded(
+                       [](int&&) {},
+                       [&moved](std::string&& val) { moved = std::move(val); }),
+                    std::move(v));
+
+         Assert::AreEqual("Hello"s, moved);
+      }
+
+      TEST_METHOD(Test_Visit_MultipleVariants)
+      {
+         using Var1_t = mdv::Variant<int, float, char>;
+         using Var2_t = mdv::Variant<char, int>;
+
+         const Var1_t lefts[] = { Var1_t(1), Var1_t(1.f), Var1_t('a') };
+         const Var2_t rights[] = { Var2_t('a'), Var2_t(1) };
+
+         Assert::AreEqual(2, mdv::Visit(PairVisitor(), lefts[0], rights[0]));
+         Assert::AreEqual(0, mdv::Visit(PairVisitor(), lefts[0], rights[1]));
+         Assert::AreEqual(12, mdv::Visit(PairVisitor(), lefts[1], rights[0]));
+         Assert::AreEqual(10, mdv::Visit(PairVisitor(), lefts[1], rights[1]));
+         Assert::AreEqual(22, mdv::Visit(PairVisitor(), lefts[2], rights[0]));
+         Assert::AreEqual(20, mdv::Visit(PairVisitor(), lefts[2], rights[1]));
+
+         Assert::AreEqual(122, mdv::Visit([](auto a, auto b, auto c) { return PairVisitor()(a, b) * 10 + PairVisitor()(c, c) / 10; },
+            lefts[1], rights[0], lefts[2]));
+      }
+
+      TEST_METHOD(Test_Match)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, float, std::string>;
+
+         Var_t v(42.f);
+
+         auto result = v.Match(
+            [](int) { return 0; },
+            [](float val) { return static_cast<int>(val); },
+            [](const std::string&) { return 2; });
+
+         Assert::AreEqual(42, result);
+
+         v = "Hello"s;
+         v.Match(
+            [](int) {},
+            [](float) {},
+            [](std::string& val) { val += " World"; });
+
+         Assert::AreEqual("Hello World"s, v.Get<std::string>());
+      }
+
+      TEST_METHOD(Test_Layout)
+      {
+         struct alignas(32) OverAligned
+         {
+            float values[8];
+         };
+
+         //The discriminator only takes a single byte for small variants
+         Assert::AreEqual(2_sz_t, sizeof(mdv::Variant<char, bool>));
+         Assert::AreEqual(8_sz_t, sizeof(mdv::Variant<int, float>));
+         Assert::AreEqual(16_sz_t, sizeof(mdv::Variant<char, double>));
+
+         //The storage is aligned to the strictest alignment of all types
+         Assert::AreEqual(alignof(double), alignof(mdv::Variant<char, double>));
+         Assert::AreEqual(alignof(OverAligned), alignof(mdv::Variant<char, OverAligned>));
+
+         mdv::Variant<char, OverAligned> v{ OverAligned() };
+         Assert::AreEqual(0_sz_t, reinterpret_cast<uintptr_t>(&v.Get<OverAligned>()) % alignof(OverAligned));
+      }
+
+      TEST_METHOD(Test_Trivial_IsTriviallyCopyable)
+      {
+         Assert::IsTrue(std::is_trivially_copyable<mdv::Variant<int, float, double>>::value);
+         Assert::IsTrue(std::is_trivially_destructible<mdv::Variant<int, float, double>>::value);
+
+         Assert::IsFalse(std::is_trivially_copyable<mdv::Variant<int, std::string>>::value);
+         Assert::IsFalse(std::is_trivially_destructible<mdv::Variant<int, std::string>>::value);
+      }
+
+      TEST_METHOD(Test_Trivial_VectorReallocation)
+      {
+         using Var_t = mdv::Variant<int, float, double>;
+
+         std::vector<Var_t> values;
+         for (int i = 0; i < 100; ++i)
+         {
+            if (i % 3 == 0) values.emplace_back(i);
+            else if (i % 3 == 1) values.emplace_back(static_cast<float>(i));
+            else values.emplace_back();
+         }
+
+         for (int i = 0; i < 100; ++i)
+         {
+            if (i % 3 == 0) Assert::AreEqual(i, values[i].Get<int>());
+            else if (i % 3 == 1) Assert::AreEqual(static_cast<float>(i), values[i].Get<float>());
+            else Assert::IsFalse(values[i].HasValue());
+         }
+      }
+
+      TEST_METHOD(Test_NonCopyable_MoveOnly)
+      {
+         using Var_t = mdv::Variant<int, std::unique_ptr<int>>;
+
+         Assert::IsFalse(std::is_copy_constructible<Var_t>::value);
+         Assert::IsFalse(std::is_copy_assignable<Var_t>::value);
+         Assert::IsTrue(std::is_move_constructible<Var_t>::value);
+         Assert::IsTrue(std::is_nothrow_move_constructible<Var_t>::value);
+
+         Var_t src(std::make_unique<int>(42));
+         Var_t dst(std::move(src));
+
+         Assert::IsTrue(dst.Is<std::unique_ptr<int>>());
+         Assert::AreEqual(42, *dst.Get<std::unique_ptr<int>>());
+         Assert::IsTrue(src.Get<std::unique_ptr<int>>() == nullptr);
+      }
+
+      TEST_METHOD(Test_NonMoveable_FallsBackToCopy)
+      {
+         using Var_t = mdv::Variant<NonMoveable>;
+
+         NonMoveable value(23);
+         Var_t src{ value };
+         Var_t dst(std::move(src));
+
+         Assert::IsTrue(dst.Is<NonMoveable>());
+         Assert::AreEqual(23, dst.Get<NonMoveable>().value);
+      }
+
+      TEST_METHOD(Test_SameType_Assign)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t dst("abc"s);
+         const auto buffer = dst.Get<std::string>().data();
+
+         //The string is assigned, so it keeps its buffer
+         const Var_t src("def"s);
+         dst = src;
+         Assert::AreEqual("def"s, dst.Get<std::string>());
+         Assert::IsTrue(buffer == dst.Get<std::string>().data());
+
+         dst = Var_t("ghi"s);
+         Assert::AreEqual("ghi"s, dst.Get<std::string>());
+      }
+
+      TEST_METHOD(Test_SameType_AssignWithoutAssignmentOperator)
+      {
+         using Var_t = mdv::Variant<int, NonAssignable>;
+
+         Var_t dst{ NonAssignable(1) };
+         const Var_t src{ NonAssignable(2) };
+         dst = src;
+         Assert::AreEqual(2, dst.Get<NonAssignable>().value);
+
+         dst = Var_t{ NonAssignable(3) };
+         Assert::AreEqual(3, dst.Get<NonAssignable>().value);
+
+         const NonMoveable four(4), five(5);
+         mdv::Variant<NonMoveable> copyOnly{ four };
+         const mdv::Variant<NonMoveable> copySrc{ five };
+         copyOnly = copySrc;
+         Assert::AreEqual(5, copyOnly.Get<NonMoveable>().value);
+      }
+
+      TEST_METHOD(Test_SameType_ValueAssign)
+      {
+         using namespace std::string_literals;
+         mdv::Variant<int, std::string> var("abc"s);
+         const auto buffer = var.Get<std::string>().data();
+
+         const auto value = "def"s;
+         var = value;
+         Assert::AreEqual("def"s, var.Get<std::string>());
+         Assert::IsTrue(buffer == var.Get<std::string>().data());
+      }
+
+      TEST_METHOD(Test_ThrowingAssign_LeavesEmpty)
+      {
+         {
+            using Var_t = mdv::Variant<int, ThrowingCopy>;
+            const ThrowingCopy noThrow(false);
+            Var_t dst{ noThrow };
+            Var_t src{ noThrow };
+            src.Get<ThrowingCopy>().throwOnCopy = true;
+
+            //Can't be assigned and can't be replaced without the risk of losing dst, so it is destroyed first
+            Assert::ExpectException<std::runtime_error>([&]() { dst = src; });
+            Assert::IsFalse(dst.HasValue());
+
+            dst = 42;
+            Assert::ExpectException<std::runtime_error>([&]() { dst = src.Get<ThrowingCopy>(); });
+            Assert::IsFalse(dst.HasValue());
+         }
+         Assert::AreEqual(0, ThrowingCopy::Alive);
+      }
+
+      TEST_METHOD(Test_InPlaceCtor)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t v(mdv::InPlaceType<std::string>(), 5, 'a');
+
+         Assert::IsTrue(v.Is<std::string>());
+         Assert::AreEqual("aaaaa"s, v.Get<std::string>());
+      }
+
+      TEST_METHOD(Test_Emplace)
+      {
+         using namespace std::string_literals;
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t v(42);
+
+         auto& str = v.Emplace<std::string>("Hello"s);
+
+         Assert::IsTrue(v.Is<std::string>());
+         Assert::AreEqual("Hello"s, v.Get<std::string>());
+         Assert::IsTrue(&str == &v.Get<std::string>());
+
+         v.Emplace<int>(23);
+
+         Assert::IsTrue(v.Is<int>());
+         Assert::AreEqual(23, v.Get<int>());
+      }
+
+      TEST_METHOD(Test_Emplace_NoTemporaries)
+      {
+         using Var_t = mdv::Variant<int, Counter>;
+
+         Counter::Reset();
+         {
+            Var_t v1(mdv::InPlaceType<Counter>{});
+
+            Var_t v2;
+            v2.Emplace<Counter>();
+
+            Assert::AreEqual(2_sz_t, Counter::DefaultCtorCalls);
+            Assert::AreEqual(0_sz_t, Counter::CopyCtorCalls);
+            Assert::AreEqual(0_sz_t, Counter::MoveCtorCalls);
+            Assert::AreEqual(0_sz_t, Counter::DtorCalls);
+
+            //Replaces the current value, which has to be destroyed
+            v2.Emplace<Counter>();
+
+            Assert::AreEqual(3_sz_t, Counter::DefaultCtorCalls);
+            Assert::AreEqual(1_sz_t, Counter::DtorCalls);
+         }
+         Assert::AreEqual(3_sz_t, Counter::DtorCalls);
+         Counter::Reset();
+      }
+
+      TEST_METHOD(Test_Emplace_ThrowingCtorLeavesEmpty)
+      {
+         using Var_t = mdv::Variant<int, ThrowingCtor>;
+
+         Var_t v(42);
+
+         Assert::ExpectException<std::runtime_error>([&v]() { v.Emplace<ThrowingCtor>(); });
+         Assert::IsFalse(v.HasValue());
+      }
+
+      TEST_METHOD(Test_Get_ThrowsBadVariantAccess)
+      {
+         mdv::Variant<int, float> v(42);
+
+         Assert::ExpectException<mdv::BadVariantAccess>([&v]() { v.Get<float>(); });
+      }
+
+      TEST_METHOD(Test_GetIf)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t v(42);
+         const Var_t& cv = v;
+
+         Assert::IsNotNull(v.GetIf<int>());
+         Assert::AreEqual(42, *v.GetIf<int>());
+         Assert::IsNull(v.GetIf<std::string>());
+         Assert::IsNotNull(cv.GetIf<int>());
+         Assert::IsNull(cv.GetIf<std::string>());
+
+         *v.GetIf<int>() = 23;
+         Assert::AreEqual(23, v.Get<int>());
+
+         Assert::IsNotNull(v.GetIfLikely<int>());
+         Assert::IsNull(v.GetIfLikely<std::string>());
+
+         Var_t empty;
+         Assert::IsNull(empty.GetIf<int>());
+      }
+
+      TEST_METHOD(Test_UncheckedGet)
+      {
+         using Var_t = mdv::Variant<int, std::string>;
+
+         Var_t v(std::string("test"));
+         const Var_t& cv = v;
+
+         Assert::AreEqual(std::string("test"), v.UncheckedGet<std::string>());
+         Assert::AreEqual(std::string("test"), cv.UncheckedGet<std::string>());
+
+         v.UncheckedGet<std::string>() += "42";
+         Assert::AreEqual(std::string("test42"), v.Get<std::string>());
+      }
+
+      TEST_METHOD(Test_TryGet)
+      {
+         mdv::Variant<int, float> v(42);
+
+         int i = 0;
+         float f = 0;
+         Assert::IsTrue(v.TryGet(i));
+         Assert::AreEqual(42, i);
+         Assert::IsFalse(v.TryGet(f));
+         Assert::AreEqual(0.f, f);
+      }
+
 //TODO We need some tool that checks the compiler output 
 #ifdef CHECK_IF_COMPILES
 
@@ -0,0 +1,259 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "structures\VariantVector.h"
+
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace mortanodevhelpertest
+{
+
+   //! Returns the type index of the value it is called with
+   struct TypeIndexVisitor
+   {
+      size_t operator()(int) const { return 0; }
+      size_t operator()(double) const { return 1; }
+      size_t operator()(const std::string&) const { return 2; }
+   };
+
+	TEST_CLASS(VariantVectorTest)
+	{
+	public:
+
+      TEST_METHOD(Test_Empty)
+      {
+         mdv::VariantVector<int, double> vec;
+         Assert::IsTrue(vec.Empty());
+         Assert::AreEqual<size_t>(0, vec.Size());
+         Assert::AreEqual<size_t>(0, vec.Count<int>());
+      }
+
+      TEST_METHOD(Test_PushBack)
+      {
+         mdv::VariantVector<int, double, std::string> vec;
+         vec.PushBack(42);
+         vec.PushBack(23.0);
+         vec.PushBack(std::string("test"));
+         vec.PushBack(7);
+
+         Assert::AreEqual<size_t>(4, vec.Size());
+         Assert::AreEqual<size_t>(2, vec.Count<int>());
+         Assert::AreEqual<size_t>(1, vec.Count<double>());
+         Assert::AreEqual<size_t>(1, vec.Count<std::string>());
+
+         Assert::IsTrue(vec.Is<int>(0));
+         Assert::IsTrue(vec.Is<double>(1));
+         Assert::IsTrue(vec.Is<std::string>(2));
+         Assert::IsTrue(vec.Is<int>(3));
+
+         Assert::AreEqual(42, vec.Get<int>(0));
+         Assert::AreEqual(23.0, vec.Get<double>(1));
+         Assert::AreEqual(std::string("test"), vec.Get<std::string>(2));
+         Assert::AreEqual(7, vec.Get<int>(3));
+      }
+
+      TEST_METHOD(Test_PushBack_Variant)
+      {
+         using Vec_t = mdv::VariantVector<int, std::string>;
+         Vec_t vec;
+         vec.PushBack(Vec_t::Variant_t(42));
+         vec.PushBack(Vec_t::Variant_t(std::string("test")));
+
+         Assert::AreEqual(42, vec.Get<int>(0));
+         Assert::AreEqual(std::string("test"), vec.Get<std::string>(1));
+      }
+
+      TEST_METHOD(Test_Emplace)
+      {
+         mdv::VariantVector<int, std::string> vec;
+         auto& str = vec.Emplace<std::string>(3, 'x');
+         Assert::AreEqual(std::string("xxx"), str);
+         Assert::IsTrue(vec.Is<std::string>(0));
+      }
+
+      TEST_METHOD(Test_Get_WrongType)
+      {
+         mdv::VariantVector<int, double> vec;
+         vec.PushBack(42);
+         Assert::ExpectException<mdv::BadVariantAccess>([&vec]() { vec.Get<double>(0); });
+      }
+
+      TEST_METHOD(Test_ForEach)
+      {
+         mdv::VariantVector<int, double> vec;
+         for (int i = 0; i < 10; ++i)
+         {
+            vec.PushBack(i);
+            vec.PushBack(static_cast<double>(i));
+         }
+
+         int sum = 0;
+         vec.ForEach<int>([&sum](int val) { sum += val; });
+         Assert::AreEqual(45, sum);
+
+         vec.ForEach<int>([](int& val) { val *= 2; });
+         Assert::AreEqual(18, vec.Get<int>(18));
+
+         const int* ints = vec.PoolData<int>();
+         Assert::AreEqual(0, ints[0]);
+         Assert::AreEqual(18, ints[9]);
+      }
+
+      TEST_METHOD(Test_ForEachAll)
+      {
+         mdv::VariantVector<int, double, std::string> vec;
+         vec.PushBack(1);
+         vec.PushBack(std::string("a"));
+         vec.PushBack(2.0);
+         vec.PushBack(3);
+
+         size_t counts[3] = {};
+         vec.ForEachAll([&counts](const auto& val) { ++counts[TypeIndexVisitor{}(val)]; });
+
+         Assert::AreEqual<size_t>(2, counts[0]);
+         Assert::AreEqual<size_t>(1, counts[1]);
+         Assert::AreEqual<size_t>(1, counts[2]);
+      }
+
+      TEST_METHOD(Test_Visit)
+      {
+         mdv::VariantVector<int, double, std::string> vec;
+         vec.PushBack(1);
+         vec.PushBack(std::string("a"));
+         vec.PushBack(2.0);
+
+         Assert::AreEqual<size_t>(0, vec.Visit(0, TypeIndexVisitor{}));
+         Assert::AreEqual<size_t>(2, vec.Visit(1, TypeIndexVisitor{}));
+         Assert::AreEqual<size_t>(1, vec.Visit(2, TypeIndexVisitor{}));
+      }
+
+      //! Many elements with an irregular type pattern, so that discriminators span multiple words and the random
+      //! access has to use the per-block counts
+      TEST_METHOD(Test_ManyElements_RandomAccess)
+      {
+         mdv::VariantVector<int, double, std::string> vec;
+         constexpr int Count = 1000;
+         for (int i = 0; i < Count; ++i)
+         {
+            switch ((i * 7) % 3)
+            {
+            case 0: vec.PushBack(i); break;
+            case 1: vec.PushBack(static_cast<double>(i)); break;
+            default: vec.PushBack(std::to_string(i)); break;
+            }
+         }
+
+         Assert::AreEqual<size_t>(Count, vec.Size());
+         // Values, one 2-bit discriminator per element, and three counts for every block of 64 elements
+         const size_t valueBytes = vec.Count<int>() * sizeof(int) + vec.Count<double>() * sizeof(double) +
+            vec.Count<std::string>() * sizeof(std::string);
+         const size_t blocks = (Count + 63) / 64;
+         Assert::AreEqual(valueBytes + ((Count + 31) / 32) * sizeof(uint64_t) + blocks * 3 * sizeof(size_t),
+            vec.MemoryFootprint());
+         for (int i = 0; i < Count; ++i)
+         {
+            switch ((i * 7) % 3)
+            {
+            case 0: Assert::AreEqual(i, vec.Get<int>(i)); break;
+            case 1: Assert::AreEqual(static_cast<double>(i), vec.Get<double>(i)); break;
+            default: Assert::AreEqual(std::to_string(i), vec.Get<std::string>(i)); break;
+            }
+         }
+      }
+
+      //! 1 bit discriminators fill a word completely, 3 bit discriminators leave one bit of every word unused, and
+      //! a block is 63 elements then
+      TEST_METHOD(Test_ManyElements_DiscriminatorWidths)
+      {
+         mdv::VariantVector<int, double> twoTypes;
+         mdv::VariantVector<int, double, float, char, uint16_t> fiveTypes;
+         constexpr int Count = 1000;
+         for (int i = 0; i < Count; ++i)
+         {
+            if (i % 7 < 3)
+               twoTypes.PushBack(i);
+            else
+               twoTypes.PushBack(static_cast<double>(i));
+
+            switch (i % 5 == 0 ? 0 : (i * 3) % 5)
+            {
+            case 0: fiveTypes.PushBack(i); break;
+            case 1: fiveTypes.PushBack(static_cast<double>(i)); break;
+            case 2: fiveTypes.PushBack(static_cast<float>(i)); break;
+            case 3: fiveTypes.PushBack(static_cast<char>(i % 128)); break;
+            default: fiveTypes.PushBack(static_cast<uint16_t>(i)); break;
+            }
+         }
+
+         for (int i = 0; i < Count; ++i)
+         {
+            if (i % 7 < 3)
+               Assert::AreEqual(i, twoTypes.Get<int>(i));
+            else
+               Assert::AreEqual(static_cast<double>(i), twoTypes.Get<double>(i));
+
+            switch (i % 5 == 0 ? 0 : (i * 3) % 5)
+            {
+            case 0: Assert::AreEqual(i, fiveTypes.Get<int>(i)); break;
+            case 1: Assert::AreEqual(static_cast<double>(i), fiveTypes.Get<double>(i)); break;
+            case 2: Assert::AreEqual(static_cast<float>(i), fiveTypes.Get<float>(i)); break;
+            case 3: Assert::AreEqual(static_cast<char>(i % 128), fiveTypes.Get<char>(i)); break;
+            default: Assert::AreEqual(static_cast<uint16_t>(i), fiveTypes.Get<uint16_t>(i)); break;
+            }
+         }
+      }
+
+      //! bool is stored in a byte each instead of the bit-packed std::vector<bool>, so references to it work
+      TEST_METHOD(Test_Bool)
+      {
+         mdv::VariantVector<int, bool> vec;
+         vec.PushBack(1);
+         vec.PushBack(true);
+         auto& flag = vec.Emplace<bool>(false);
+         Assert::IsFalse(flag);
+
+         flag = true;
+         Assert::IsTrue(vec.Get<bool>(2));
+         vec.Get<bool>(1) = false;
+         Assert::IsFalse(vec.Get<bool>(1));
+
+         const auto& constVec = vec;
+         Assert::IsTrue(constVec.Get<bool>(2));
+         Assert::IsTrue(constVec.Visit(2, [](const auto& val) { return std::is_same<decltype(val), const bool&>::value; }));
+
+         size_t setFlags = 0;
+         vec.ForEach<bool>([&setFlags](bool& val) { setFlags += val ? 1 : 0; });
+         Assert::AreEqual<size_t>(1, setFlags);
+         Assert::AreEqual<size_t>(2, vec.Count<bool>());
+      }
+
+      TEST_METHOD(Test_Clear)
+      {
+         mdv::VariantVector<int, double> vec;
+         for (int i = 0; i < 100; ++i)
+         {
+            vec.PushBack(i);
+         }
+         vec.Clear();
+         Assert::IsTrue(vec.Empty());
+         Assert::AreEqual<size_t>(0, vec.Count<int>());
+
+         vec.PushBack(2.0);
+         Assert::AreEqual(2.0, vec.Get<double>(0));
+      }
+
+      TEST_METHOD(Test_SingleType)
+      {
+         mdv::VariantVector<int> vec;
+         for (int i = 0; i < 100; ++i)
+         {
+            vec.PushBack(i);
+         }
+         Assert::AreEqual(99, vec.Get<int>(99));
+      }
+
+	};
+
+}
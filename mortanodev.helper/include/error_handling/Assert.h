@@ -9,7 +9,7 @@ namespace mdv
 #endif
 
 #ifdef DEBUG_LEVEL_HIGH
-   void _AssertFail(const char* conditionText, const char* file, int line)
+   inline void _AssertFail(const char* conditionText, const char* file, int line)
    {
       std::cerr << "Condition " << conditionText << " failed at [" << file << "; line " << line << "]" << std::endl;
       __debugbreak();
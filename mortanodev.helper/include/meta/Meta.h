@@ -1,6 +1,7 @@
 #pragma once
 #include <type_traits>
 #include <tuple>
+#include <utility>
 
 namespace mdv
 {
@@ -65,24 +66,114 @@ namespace meta
    //! \brief Typelist structure
 	template<typename... Args> struct Typelist {};
 	
+#pragma region Flat-Helpers
+   //The algorithms on Typelist and Numberlist avoid recursion over the elements of the list. Each recursion step is a
+   //separate instantiation, so a list of N elements would need N nested instantiations per lookup (and O(N^2) for
+   //algorithms that rebuild the list in each step). Instead, they expand the whole parameter pack at once, which keeps
+   //the instantiation depth constant and the compile time and memory (nearly) linear in the size of the list
+   namespace detail
+   {
+
+      template<size_t Idx, typename T>
+      struct IndexedType
+      {
+         using type = T;
+      };
+
+      //! \brief Derives from IndexedType<I, T> for every element T at index I. Looking up an element is a single
+      //!        overload resolution against the base classes instead of a recursion over the list
+      template<typename Indices, typename... Args>
+      struct IndexedTypes;
+
+      template<size_t... Is, typename... Args>
+      struct IndexedTypes<std::index_sequence<Is...>, Args...> : IndexedType<Is, Args>...
+      {
+      };
+
+      //! \brief Only used in unevaluated context, the deduction picks the base class with the given index
+      template<size_t Idx, typename T>
+      IndexedType<Idx, T> SelectIndexed(const IndexedType<Idx, T>&);
+
+      template<typename... Args>
+      using IndexedTypes_t = IndexedTypes<std::index_sequence_for<Args...>, Args...>;
+
+      template<bool... Values>
+      struct BoolPack {};
+
+      //! \brief Are all values false? Shifting the pack by one only gives the same pack if all values are equal
+      template<bool... Values>
+      using NoneOf = std::is_same<BoolPack<false, Values...>, BoolPack<Values..., false>>;
+
+      //! \brief The values of a pack as constexpr array. The trailing element allows empty packs
+      template<typename T, T... Values>
+      struct ValueArray
+      {
+         constexpr static T values[sizeof...(Values) + 1] = { Values..., T() };
+      };
+
+      template<typename T, T... Values>
+      constexpr T ValueArray<T, Values...>::values[sizeof...(Values) + 1];
+
+      constexpr size_t NotFound = static_cast<size_t>(-1);
+
+      constexpr size_t Min(size_t l, size_t r)
+      {
+         return l < r ? l : r;
+      }
+
+      //! \brief Index of the first true value in [first, last), or NotFound. Splitting the range in halves keeps the
+      //!        recursion depth of the constant evaluation logarithmic
+      constexpr size_t FindFirst(const bool* values, size_t first, size_t last)
+      {
+         return last - first == 0 ? NotFound :
+            last - first == 1 ? (values[first] ? first : NotFound) :
+            Min(FindFirst(values, first, first + (last - first) / 2), FindFirst(values, first + (last - first) / 2, last));
+      }
+
+      //! \brief Sum of the values in [first, last), with logarithmic recursion depth like FindFirst
+      constexpr size_t SumRange(const size_t* values, size_t first, size_t last)
+      {
+         return last - first == 0 ? 0 :
+            last - first == 1 ? values[first] :
+            SumRange(values, first, first + (last - first) / 2) + SumRange(values, first + (last - first) / 2, last);
+      }
+
+      template<typename TList, typename Indices>
+      struct SelectMany;
+
+      //! \brief The elements of TList at the given indices
+      template<typename... Args, size_t... Is>
+      struct SelectMany<Typelist<Args...>, std::index_sequence<Is...>>
+      {
+         using type = Typelist<typename decltype(SelectIndexed<Is>(std::declval<IndexedTypes_t<Args...>>()))::type...>;
+      };
+
+      //! \brief Indices Offset, Offset + Step, Offset + 2 * Step, ... The step is added with wraparound, so that
+      //!        static_cast<size_t>(-1) counts downwards
+      template<size_t Count, size_t Offset, size_t Step>
+      struct IndexRange
+      {
+         template<size_t... Is>
+         static std::index_sequence<(Offset + Is * Step)...> Make(std::index_sequence<Is...>);
+
+         using type = decltype(Make(std::make_index_sequence<Count>()));
+      };
+
+   }
+#pragma endregion
+
 #pragma region At
    template<size_t, typename> struct At;
 
-   template<size_t Idx, typename Only>
-   struct At<Idx, Typelist<Only>>
+   //! \brief Access an element of a typelist
+   template<size_t Idx, typename... Args>
+   struct At<Idx, Typelist<Args...>>
    {
-      static_assert(Idx == 0, "Index out of bounds!");
-      using type = Only;
+      static_assert(Idx < sizeof...(Args), "Index out of bounds!");
+      using type = typename decltype(
+         detail::SelectIndexed<Idx>(std::declval<detail::IndexedTypes_t<Args...>>()))::type;
    };
 
-	//! \brief Access an element of a typelist
-	template<size_t Idx, typename First, typename... Last>
-	struct At<Idx, Typelist<First, Last...>>
-	{
-		static_assert(Idx < (1 + sizeof...(Last)), "Index out of bounds!");
-		using type = std::conditional_t<Idx == 0, First, typename At<Idx - 1, Typelist<Last...>>::type>;
-	};
-
 	template<size_t Idx, typename Typelist>
 	using At_t = typename At<Idx, Typelist>::type;
 #pragma endregion
@@ -101,24 +192,13 @@ namespace meta
 #pragma region IndexOf
    template<typename, typename> struct IndexOf;
 
-   //! \brief Index of a type in a typelist
-   template<typename What, typename First, typename... Rest>
-   struct IndexOf<What, Typelist<First, Rest...>>       
-   {
-   private:
-      constexpr static size_t tmp = IndexOf<What, Typelist<Rest...>>::value;
-   public:
-#pragma warning(push)
-#pragma warning(disable: 4307) //Compiler complains about integral overflow because we *might* add 1 to size_t max value. However, this will never happen because of the if check!
-      constexpr static size_t value = std::is_same<What, First>::value ? 0 :
-         (tmp == static_cast<size_t>(-1) ? -1 : 1 + tmp);
-#pragma warning(pop)
-   };
-
-   template<typename What>
-   struct IndexOf<What, Typelist<>>
+   //! \brief Index of a type in a typelist, or static_cast<size_t>(-1) if the typelist does not contain it. If the
+   //!        type is contained more than once, this is the index of the first occurrence
+   template<typename What, typename... Args>
+   struct IndexOf<What, Typelist<Args...>>
    {
-      constexpr static size_t value = static_cast<size_t>(-1);
+      constexpr static size_t value = detail::FindFirst(
+         detail::ValueArray<bool, std::is_same<What, Args>::value...>::values, 0, sizeof...(Args));
    };
 #pragma endregion
 
@@ -140,18 +220,9 @@ namespace meta
    template<typename, typename> struct Contains;
 
    //! \brief Is a type contained within a typelist?
-   template<typename What, typename First, typename... Rest>
-   struct Contains<What, Typelist<First, Rest...>> :
-      std::bool_constant<
-         std::is_same<What, First>::value | Contains<What, Typelist<Rest...>>::value
-      >
-   {
-   };
-
-   //! \brief Recursion stop case for empty type list
-   template<typename What>
-   struct Contains<What, Typelist<>> :
-      std::bool_constant<false>
+   template<typename What, typename... Args>
+   struct Contains<What, Typelist<Args...>> :
+      std::bool_constant<!detail::NoneOf<std::is_same<What, Args>::value...>::value>
    {
    };
 #pragma endregion
@@ -192,16 +263,11 @@ namespace meta
 
    template<typename> struct Reverse;
 
-   template<>
-   struct Reverse<Typelist<>>
-   {
-      using type = Typelist<>;
-   };
-
-   template<typename First, typename... Rest>
-   struct Reverse<Typelist<First, Rest...>>
+   template<typename... Args>
+   struct Reverse<Typelist<Args...>>
    {
-      using type = PushBack_t < First, Reverse<Typelist<Rest...>> >;
+      using type = typename detail::SelectMany<Typelist<Args...>,
+         typename detail::IndexRange<sizeof...(Args), sizeof...(Args) - 1, static_cast<size_t>(-1)>::type>::type;
    };
 
    //! \brief Reverse the given typelist
@@ -213,23 +279,11 @@ namespace meta
 #pragma region Take
    template<size_t, typename> struct Take;
 
-   template<size_t Count>
-   struct Take<Count, Typelist<>>
+   template<size_t Count, typename... Args>
+   struct Take<Count, Typelist<Args...>>
    {
-      using type = Typelist<>;
-   };
-
-   template<size_t Count, typename First, typename... Rest>
-   struct Take<Count, Typelist<First, Rest...>>
-   {
-      using type = std::conditional_t<
-         Count == 0,
-         Typelist<>,
-         Concat_t<
-         Typelist<First>,
-         typename Take<Count - 1, Typelist<Rest...>>::type
-         >
-      >;
+      using type = typename detail::SelectMany<Typelist<Args...>,
+         std::make_index_sequence<detail::Min(Count, sizeof...(Args))>>::type;
    };
 
    //! \brief Take metafunction that takes the first Count elements out of the given list
@@ -258,6 +312,25 @@ namespace meta
    using MaxOf_t = typename MaxOf<Comp, TList>::type;
 #pragma endregion
 
+#pragma region EraseAt
+   template<size_t, typename> struct EraseAt;
+
+   template<size_t Idx, typename... Args>
+   struct EraseAt<Idx, Typelist<Args...>>
+   {
+      static_assert(Idx < sizeof...(Args), "Index out of bounds!");
+      using type = Concat_t<
+         typename detail::SelectMany<Typelist<Args...>, std::make_index_sequence<Idx>>::type,
+         typename detail::SelectMany<Typelist<Args...>,
+            typename detail::IndexRange<sizeof...(Args) - Idx - 1, Idx + 1, 1>::type>::type
+      >;
+   };
+
+   //! \brief Removes the element at the given index from a typelist
+   template<size_t Idx, typename TList>
+   using EraseAt_t = typename EraseAt<Idx, TList>::type;
+#pragma endregion
+
 #pragma region Foldl
 
 #pragma region Fold-Helpers
@@ -323,25 +396,13 @@ namespace meta
 
    template<template<typename> class, typename> struct Transform;
 
-   template<
-      template<typename> class Func
-   >
-   struct Transform<Func, Typelist<>>
-   {
-      using type = Typelist<>;
-   };
-
    template<
       template<typename> class Func,
-      typename First,
-      typename... Rest
+      typename... Args
    >
-   struct Transform<Func, Typelist<First, Rest...>>
+   struct Transform<Func, Typelist<Args...>>
    {
-      using type = PushFront_t<
-         typename Func<First>::type, 
-         typename Transform<Func, Typelist<Rest...>>::type
-      >;
+      using type = Typelist<typename Func<Args>::type...>;
    };
 
    //! \brief Transform a typelist with the given metafunction
@@ -363,19 +424,12 @@ namespace meta
    template<size_t... Values> struct Numberlist {};
 
 #pragma region At
-   template<size_t Idx, size_t Only>
-   struct At<Idx, Numberlist<Only>> :
-      std::integral_constant<size_t, Only>
-   {
-      static_assert(Idx == 0, "Index out of bounds!");
-   };
-
    //! \brief Access an element of a Numberlist
-   template<size_t Idx, size_t First, size_t... Rest>
-   struct At<Idx, Numberlist<First, Rest...>> :
-      std::integral_constant<size_t, Idx == 0 ? First : At<Idx == 0 ? 0 : Idx - 1, Numberlist<Rest...>>::value>
+   template<size_t Idx, size_t... Values>
+   struct At<Idx, Numberlist<Values...>> :
+      std::integral_constant<size_t, detail::ValueArray<size_t, Values...>::values[Idx]>
    {
-      static_assert(Idx < (1 + sizeof...(Rest)), "Index out of bounds!");
+      static_assert(Idx < sizeof...(Values), "Index out of bounds!");
    };
 #pragma endregion
 
@@ -391,14 +445,10 @@ namespace meta
 #pragma region Sum
    template<typename> struct Sum;
 
-   //! \brief Sum of the elements of an empty Numberlist, which of course is zero
-   template<>
-   struct Sum<Numberlist<>> : std::integral_constant<size_t, 0> {};
-
-   //! \brief Sum of the elements of a Numberlist
-   template<size_t First, size_t... Rest>
-   struct Sum<Numberlist<First, Rest...>> :
-      std::integral_constant<size_t, First + Sum<Numberlist<Rest...>>::value>
+   //! \brief Sum of the elements of a Numberlist. The sum of an empty Numberlist is zero
+   template<size_t... Values>
+   struct Sum<Numberlist<Values...>> :
+      std::integral_constant<size_t, detail::SumRange(detail::ValueArray<size_t, Values...>::values, 0, sizeof...(Values))>
    {
    };
 #pragma endregion
@@ -429,23 +479,25 @@ namespace meta
 #pragma endregion
 
 #pragma region Take
-   template<size_t Count>
-   struct Take<Count, Numberlist<>>
+   namespace detail
    {
-      using type = Numberlist<>;
-   };
 
-   template<size_t Count, size_t First, size_t... Rest>
-   struct Take<Count, Numberlist<First, Rest...>>
+      template<typename NList, typename Indices>
+      struct SelectValues;
+
+      template<size_t... Values, size_t... Is>
+      struct SelectValues<Numberlist<Values...>, std::index_sequence<Is...>>
+      {
+         using type = Numberlist<ValueArray<size_t, Values...>::values[Is]...>;
+      };
+
+   }
+
+   template<size_t Count, size_t... Values>
+   struct Take<Count, Numberlist<Values...>>
    {
-      using type = std::conditional_t<
-         Count == 0,
-         Numberlist<>,
-         Concat_t<
-            Numberlist<First>, 
-            typename Take<Count - 1, Numberlist<Rest...>>::type
-         >
-      >;
+      using type = typename detail::SelectValues<Numberlist<Values...>,
+         std::make_index_sequence<detail::Min(Count, sizeof...(Values))>>::type;
    };
 #pragma endregion
 
@@ -482,6 +534,109 @@ namespace meta
 
 #pragma endregion
 
+#pragma region Sort
+   namespace detail
+   {
+
+      template<template <typename, typename> class Less, typename T, size_t Idx, typename TList, typename Indices>
+      struct StableRank;
+
+      //! \brief Position of the element T at index Idx in the sorted list. This is the number of elements that are
+      //!        less than T, plus the number of elements in front of T that are equivalent to it
+      template<template <typename, typename> class Less, typename T, size_t Idx, typename... Args, size_t... Is>
+      struct StableRank<Less, T, Idx, Typelist<Args...>, std::index_sequence<Is...>> :
+         std::integral_constant<size_t, SumRange(
+            ValueArray<size_t, (Less<Args, T>::value || (!Less<T, Args>::value && Is < Idx))...>::values,
+            0,
+            sizeof...(Args))>
+      {
+      };
+
+      template<template <typename, typename> class Less, typename TList, typename Indices>
+      struct SortedPositions;
+
+      template<template <typename, typename> class Less, typename... Args, size_t... Is>
+      struct SortedPositions<Less, Typelist<Args...>, std::index_sequence<Is...>>
+      {
+         using type = Numberlist<StableRank<Less, Args, Is, Typelist<Args...>, std::index_sequence<Is...>>::value...>;
+      };
+
+      template<size_t Value, typename NList>
+      struct IndexOfValue;
+
+      template<size_t Value, size_t... Values>
+      struct IndexOfValue<Value, Numberlist<Values...>> :
+         std::integral_constant<size_t, FindFirst(ValueArray<bool, (Values == Value)...>::values, 0, sizeof...(Values))>
+      {
+      };
+
+      template<typename NList, typename Indices>
+      struct Inverse;
+
+      template<size_t... Values, size_t... Is>
+      struct Inverse<Numberlist<Values...>, std::index_sequence<Is...>>
+      {
+         using type = Numberlist<IndexOfValue<Is, Numberlist<Values...>>::value...>;
+      };
+
+      template<typename TList, typename NList>
+      struct Permute;
+
+      template<typename... Args, size_t... Values>
+      struct Permute<Typelist<Args...>, Numberlist<Values...>>
+      {
+         using type = typename SelectMany<Typelist<Args...>, std::index_sequence<Values...>>::type;
+      };
+
+   }
+
+   template<typename> struct InversePermutation;
+
+   template<size_t... Values>
+   struct InversePermutation<Numberlist<Values...>>
+   {
+      using type = typename detail::Inverse<Numberlist<Values...>, std::make_index_sequence<sizeof...(Values)>>::type;
+   };
+
+   //! \brief Inverse of a permutation of the numbers 0 to N-1. If the permutation has the value P at index I, the
+   //!        inverse has the value I at index P
+   //!
+   //! Example: InversePermutation_t<Numberlist<1, 2, 0>> => Numberlist<2, 0, 1>
+   template<typename Permutation>
+   using InversePermutation_t = typename InversePermutation<Permutation>::type;
+
+   template<template <typename, typename> class, typename> struct SortPermutation;
+
+   template<template <typename, typename> class Less, typename... Args>
+   struct SortPermutation<Less, Typelist<Args...>>
+   {
+      //! \brief Position of each element in the sorted typelist, in the order of the unsorted typelist
+      using Positions = typename detail::SortedPositions<Less, Typelist<Args...>, std::index_sequence_for<Args...>>::type;
+      using type = InversePermutation_t<Positions>;
+   };
+
+   //! \brief Indices of the elements of a typelist in the order of a stable sort, see Sort_t. The inverse of this
+   //!        permutation is the position of each element in the sorted typelist
+   //!
+   //! Example: SortPermutation_t<Smaller, Typelist<int64_t, int8_t, int32_t>> => Numberlist<1, 2, 0>
+   template<template <typename, typename> class Less, typename TList>
+   using SortPermutation_t = typename SortPermutation<Less, TList>::type;
+
+   template<template <typename, typename> class Less, typename TList>
+   struct Sort
+   {
+      using type = typename detail::Permute<TList, SortPermutation_t<Less, TList>>::type;
+   };
+
+   //! \brief Stable sort of a typelist. Less<L, R>::value is true if L has to come before R. Elements for which
+   //!        neither is less than the other keep their order. The position of each element is computed directly
+   //!        from the number of elements that have to come before it, so there is no recursion over the list
+   //!
+   //! Example: Sort_t<Smaller, Typelist<int64_t, int8_t, int32_t>> => Typelist<int8_t, int32_t, int64_t>
+   template<template <typename, typename> class Less, typename TList>
+   using Sort_t = typename Sort<Less, TList>::type;
+#pragma endregion
+
 }
 
 }
\ No newline at end of file
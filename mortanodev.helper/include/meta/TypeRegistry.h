@@ -0,0 +1,291 @@
+#pragma once
+#include "Meta.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace mdv
+{
+
+#pragma region TypeName
+
+   //! \brief Stable name of a type. Names that the compiler generates (typeid, __FUNCSIG__) differ between
+   //!        compilers and versions, so every type that needs a type ID is registered with MDV_TYPE_NAME
+   template<typename T>
+   struct TypeName
+   {
+      static_assert(meta::AlwaysFalse<T>::value, "There is no name registered for this type, use MDV_TYPE_NAME!");
+   };
+
+   //! \brief Registers the name of a type. Has to be used in the global namespace. The name must not change
+   //!        anymore once type IDs are stored anywhere
+   //!
+   //! Example: MDV_TYPE_NAME(game::Player, "game::Player")
+#define MDV_TYPE_NAME(Type, Name) \
+   namespace mdv \
+   { \
+      template<> \
+      struct TypeName<Type> \
+      { \
+         constexpr static const char* Value() { return Name; } \
+      }; \
+   }
+
+#pragma endregion
+
+#pragma region TypeId
+   namespace detail
+   {
+      namespace registry
+      {
+
+         constexpr uint64_t HashOffset = 0xcbf29ce484222325ULL;
+         constexpr uint64_t HashPrime = 0x100000001b3ULL;
+
+         //! \brief 64 bit FNV-1a over a null-terminated string
+         constexpr uint64_t HashName(const char* name, uint64_t hash = HashOffset)
+         {
+            return *name == '\0' ? hash :
+               HashName(name + 1, (hash ^ static_cast<unsigned char>(*name)) * HashPrime);
+         }
+
+      }
+   }
+
+   //! \brief Stable 64 bit ID of a type, the hash of its registered name
+   template<typename T>
+   struct TypeId : std::integral_constant<uint64_t, detail::registry::HashName(TypeName<T>::Value())>
+   {
+   };
+
+#pragma endregion
+
+#pragma region TypeRegistry
+   namespace detail
+   {
+      namespace registry
+      {
+
+         //! \brief Seeds that are tried for each bucket of the hash table
+         constexpr uint64_t SeedCount = 1 << 16;
+         constexpr uint64_t NoSeed = static_cast<uint64_t>(-1);
+
+         constexpr uint64_t ShiftXor(uint64_t hash)
+         {
+            return hash ^ (hash >> 33);
+         }
+
+         //! \brief Finalizer of MurmurHash3, so that seeds that differ in a single bit give unrelated slots
+         constexpr uint64_t Mix(uint64_t hash)
+         {
+            return ShiftXor(ShiftXor(ShiftXor(hash) * 0xff51afd7ed558ccdULL) * 0xc4ceb9fe1a85ec53ULL);
+         }
+
+         //! \brief Maps the lower 32 bits of the hash to [0, count) with a multiplication instead of a division
+         constexpr size_t Scale(uint64_t hash, size_t count)
+         {
+            return static_cast<size_t>(((hash & 0xffffffffULL) * count) >> 32);
+         }
+
+         //! \brief Bucket of an ID. The ID is mixed first, because FNV-1a gives names that only differ in their
+         //!        last characters nearly the same upper bits
+         constexpr size_t BucketOf(uint64_t id, size_t buckets)
+         {
+            return Scale(Mix(id) >> 32, buckets);
+         }
+
+         //! \brief Slot of an ID inside the range of its bucket, which contains count slots
+         constexpr size_t SlotInBucket(uint64_t id, uint64_t seed, size_t count)
+         {
+            return Scale(Mix(id ^ seed), count);
+         }
+
+         constexpr size_t SlotInRange(uint64_t id, uint64_t seed, size_t first, size_t last)
+         {
+            return first + SlotInBucket(id, seed, last - first);
+         }
+
+         //! \brief Slot of an ID in the whole table. The buckets are stored one after the other, the slots of the
+         //!        bucket b are [starts[b], starts[b + 1])
+         constexpr size_t SlotOf(uint64_t id, const size_t* starts, const uint64_t* seeds, size_t buckets)
+         {
+            return SlotInRange(id, seeds[BucketOf(id, buckets)], starts[BucketOf(id, buckets)],
+               starts[BucketOf(id, buckets) + 1]);
+         }
+
+         //! \brief Number of IDs in [first, last) that come before the ID at the given index if the IDs are ordered
+         //!        by their bucket. With index 0, this is the first slot of the bucket
+         constexpr size_t CountBefore(const uint64_t* ids, size_t first, size_t last, size_t buckets, size_t bucket,
+            size_t index)
+         {
+            return last - first == 0 ? 0 :
+               last - first == 1 ? (BucketOf(ids[first], buckets) < bucket ||
+                  (BucketOf(ids[first], buckets) == bucket && first < index) ? 1 : 0) :
+               CountBefore(ids, first, first + (last - first) / 2, buckets, bucket, index) +
+               CountBefore(ids, first + (last - first) / 2, last, buckets, bucket, index);
+         }
+
+         //! \brief Is the slot different from the slots of all IDs in [first, last)?
+         constexpr bool SlotIsFree(const uint64_t* ids, size_t first, size_t last, uint64_t seed, size_t count,
+            size_t slot)
+         {
+            return first == last ||
+               (SlotInBucket(ids[first], seed, count) != slot && SlotIsFree(ids, first + 1, last, seed, count, slot));
+         }
+
+         //! \brief Does the seed give each ID in [first, last) a slot of its own?
+         constexpr bool AllDistinct(const uint64_t* ids, size_t first, size_t last, uint64_t seed, size_t count)
+         {
+            return last - first < 2 ||
+               (SlotIsFree(ids, first + 1, last, seed, count, SlotInBucket(ids[first], seed, count)) &&
+                  AllDistinct(ids, first + 1, last, seed, count));
+         }
+
+         constexpr uint64_t FindSeed(const uint64_t* ids, size_t first, size_t last, uint64_t lowest, uint64_t end);
+
+         //! \brief The seed that was found in the lower half, or else the first one in the upper half. The upper half
+         //!        is only searched if the lower half has no seed
+         constexpr uint64_t SeedOrSearch(uint64_t seed, const uint64_t* ids, size_t first, size_t last,
+            uint64_t lowest, uint64_t end)
+         {
+            return seed != NoSeed ? seed : FindSeed(ids, first, last, lowest, end);
+         }
+
+         //! \brief First seed in [lowest, end) that maps the IDs in [first, last) to distinct slots, or NoSeed. The
+         //!        range of seeds is split in halves, so the recursion depth stays logarithmic
+         constexpr uint64_t FindSeed(const uint64_t* ids, size_t first, size_t last, uint64_t lowest, uint64_t end)
+         {
+            return end - lowest == 1 ? (AllDistinct(ids, first, last, lowest, last - first) ? lowest : NoSeed) :
+               SeedOrSearch(FindSeed(ids, first, last, lowest, lowest + (end - lowest) / 2), ids, first, last,
+                  lowest + (end - lowest) / 2, end);
+         }
+
+         template<typename Ids, typename Keys = std::make_index_sequence<Ids::size()>>
+         struct Table;
+
+         //! \brief Minimal perfect hash table for the given IDs. The IDs are distributed over N buckets. For each
+         //!        bucket, a seed is searched at compile time that maps the IDs of the bucket to distinct slots in
+         //!        the range of the bucket, so all N IDs get one of N slots. This is the 'hash and displace'
+         //!        scheme, reduced to what a C++11 constexpr function can compute
+         template<uint64_t... Ids, size_t... Keys>
+         struct Table<std::integer_sequence<uint64_t, Ids...>, std::index_sequence<Keys...>>
+         {
+            constexpr static size_t KeyCount = sizeof...(Ids);
+            constexpr static size_t BucketCount = KeyCount > 0 ? KeyCount : 1;
+
+            using Ids_t = meta::detail::ValueArray<uint64_t, Ids...>;
+
+            //! \brief Position of each ID if the IDs are ordered by their bucket
+            using Positions_t = meta::Numberlist<
+               CountBefore(Ids_t::values, 0, KeyCount, BucketCount, BucketOf(Ids, BucketCount), Keys)...>;
+
+            template<size_t... Order>
+            static meta::detail::ValueArray<uint64_t, Ids_t::values[Order]...> SortIds(meta::Numberlist<Order...>);
+
+            using SortedIds_t = decltype(SortIds(meta::InversePermutation_t<Positions_t>()));
+
+            template<size_t... Buckets>
+            static meta::detail::ValueArray<size_t,
+               CountBefore(Ids_t::values, 0, KeyCount, BucketCount, Buckets, 0)...> MakeStarts(
+                  std::index_sequence<Buckets...>);
+
+            using Starts_t = decltype(MakeStarts(std::make_index_sequence<BucketCount + 1>()));
+
+            template<size_t... Buckets>
+            static meta::detail::ValueArray<uint64_t,
+               FindSeed(SortedIds_t::values, Starts_t::values[Buckets], Starts_t::values[Buckets + 1], 0,
+                  SeedCount)...> MakeSeeds(std::index_sequence<Buckets...>);
+
+            using Seeds_t = decltype(MakeSeeds(std::make_index_sequence<BucketCount>()));
+
+            //! \brief Index of the ID in each slot. If no seed was found for a bucket, this is no permutation and
+            //!        contains NotFound values, which are clamped so that only the static_assert below fires
+            using KeyOfSlot_t = meta::InversePermutation_t<meta::Numberlist<
+               SlotOf(Ids, Starts_t::values, Seeds_t::values, BucketCount)...>>;
+
+            template<size_t... SlotKeys>
+            static meta::detail::ValueArray<uint64_t, Ids_t::values[meta::detail::Min(SlotKeys, KeyCount)]...>
+               MakeSlotIds(meta::Numberlist<SlotKeys...>);
+
+            template<size_t... SlotKeys>
+            static meta::detail::ValueArray<size_t, SlotKeys...> MakeSlotKeys(meta::Numberlist<SlotKeys...>);
+
+            using SlotIds_t = decltype(MakeSlotIds(KeyOfSlot_t()));
+            using SlotKeys_t = decltype(MakeSlotKeys(KeyOfSlot_t()));
+
+            // There is one bucket per ID, so the IDs' indices also enumerate the buckets
+            static_assert(meta::detail::NoneOf<(Seeds_t::values[Keys] == NoSeed)...>::value,
+               "Two types have the same type ID, or no perfect hash was found for the type IDs!");
+
+            //! \brief Index of the given ID, or NotFound. This is one hash and one comparison
+            static size_t Find(uint64_t id)
+            {
+               const auto slot = SlotOf(id, Starts_t::values, Seeds_t::values, BucketCount);
+               return slot < KeyCount && SlotIds_t::values[slot] == id ? SlotKeys_t::values[slot] :
+                  meta::detail::NotFound;
+            }
+         };
+
+      }
+   }
+
+   template<typename TList>
+   struct TypeRegistry;
+
+   //! \brief Runtime mapping between the type IDs of the types in a typelist and their indices. Mapping an ID to an
+   //!        index uses a minimal perfect hash table that is generated at compile time, so it costs one hash
+   //!        and one comparison, independent of the number of types. All types need a registered name, see
+   //!        MDV_TYPE_NAME
+   //!
+   //! Example: TypeRegistry<Typelist<int32_t, float, double>>::IndexOf(TypeId<double>::value) => 2
+   template<typename... Args>
+   struct TypeRegistry<meta::Typelist<Args...>>
+   {
+      constexpr static size_t TypeCount = sizeof...(Args);
+      constexpr static size_t NotFound = meta::detail::NotFound;
+
+      //! \brief Index of the type with the given ID in the typelist, or NotFound if no type has this ID
+      static size_t IndexOf(uint64_t typeId)
+      {
+         return Table_t::Find(typeId);
+      }
+
+      //! \brief ID of the type at the given index in the typelist
+      static uint64_t IdAt(size_t index)
+      {
+         return Ids_t::values[index];
+      }
+
+   private:
+      using Ids_t = meta::detail::ValueArray<uint64_t, TypeId<Args>::value...>;
+      using Table_t = detail::registry::Table<std::integer_sequence<uint64_t, TypeId<Args>::value...>>;
+   };
+
+   template<typename... Args>
+   constexpr size_t TypeRegistry<meta::Typelist<Args...>>::TypeCount;
+
+   template<typename... Args>
+   constexpr size_t TypeRegistry<meta::Typelist<Args...>>::NotFound;
+
+#pragma endregion
+
+}
+
+#pragma region Builtin-Names
+MDV_TYPE_NAME(bool, "bool")
+MDV_TYPE_NAME(char, "char")
+MDV_TYPE_NAME(int8_t, "int8")
+MDV_TYPE_NAME(uint8_t, "uint8")
+MDV_TYPE_NAME(int16_t, "int16")
+MDV_TYPE_NAME(uint16_t, "uint16")
+MDV_TYPE_NAME(int32_t, "int32")
+MDV_TYPE_NAME(uint32_t, "uint32")
+MDV_TYPE_NAME(int64_t, "int64")
+MDV_TYPE_NAME(uint64_t, "uint64")
+MDV_TYPE_NAME(float, "float")
+MDV_TYPE_NAME(double, "double")
+MDV_TYPE_NAME(std::string, "std::string")
+#pragma endregion
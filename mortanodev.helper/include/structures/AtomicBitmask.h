@@ -0,0 +1,388 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "..\meta\Meta.h"
+#include "Bitmask.h"
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      //! \brief Ordering of the first load of a compare-and-swap loop. A section compare-exchange can return after
+      //!        this load alone, so it has to give the guarantees of a failed compare_exchange with the given order
+      constexpr std::memory_order FailureOrder(std::memory_order order)
+      {
+         return order == std::memory_order_acq_rel ? std::memory_order_acquire :
+            order == std::memory_order_release ? std::memory_order_relaxed : order;
+      }
+
+      //! \brief Common implementation of AtomicBitmask and AtomicNamedBitmask. The whole bitmask is stored in a
+      //!        single std::atomic word. Reading a section is a plain atomic load, everything that writes a section
+      //!        is a compare-and-swap loop on the whole word, so that the other sections are preserved
+      template<typename Mask_t>
+      class AtomicBitmaskBase
+      {
+      public:
+         using Value_t = Mask_t;
+         using Numbers = typename Mask_t::Numbers;
+         constexpr static size_t Sections = Mask_t::Sections;
+
+         static_assert(BitmaskStorage<Mask_t::RequiredSize>::WordCount == 1,
+            "Atomic bitmasks can have at most 64 bits!");
+
+         //! \brief Creates a bitmask with all bits set to zero
+         AtomicBitmaskBase() :
+            _word(0)
+         {
+         }
+
+         explicit AtomicBitmaskBase(const Mask_t& value) :
+            _word(ToWord(value))
+         {
+         }
+
+         AtomicBitmaskBase(const AtomicBitmaskBase&) = delete;
+         AtomicBitmaskBase& operator=(const AtomicBitmaskBase&) = delete;
+
+         //! \brief Is the underlying atomic word lock-free on this platform?
+         bool IsLockFree() const
+         {
+            return _word.is_lock_free();
+         }
+
+         //! \brief Loads all sections at once
+         Mask_t Load(std::memory_order order = std::memory_order_seq_cst) const
+         {
+            return FromWord(_word.load(order));
+         }
+
+         //! \brief Stores all sections at once
+         void Store(const Mask_t& value, std::memory_order order = std::memory_order_seq_cst)
+         {
+            _word.store(ToWord(value), order);
+         }
+
+         //! \brief Replaces all sections if the bitmask equals 'expected'. Otherwise, 'expected' receives the
+         //!        current value
+         //! \returns True if the bitmask was replaced
+         bool CompareExchange(Mask_t& expected, const Mask_t& desired,
+            std::memory_order order = std::memory_order_seq_cst)
+         {
+            auto expectedWord = ToWord(expected);
+            if (_word.compare_exchange_strong(expectedWord, ToWord(desired), order))
+               return true;
+            expected = FromWord(expectedWord);
+            return false;
+         }
+
+      protected:
+         using Data_t = typename BitmaskStorage<Mask_t::RequiredSize>::Word_t;
+
+         template<size_t Index>
+         using Section_t = Section<Data_t, Numbers, Index>;
+
+         template<size_t Index>
+         using SectionValue_t = typename Section_t<Index>::Value_t;
+
+         template<size_t Index>
+         SectionValue_t<Index> LoadAt(std::memory_order order) const
+         {
+            return GetSection<Index>(_word.load(order));
+         }
+
+         template<size_t... Indices>
+         std::tuple<SectionValue_t<Indices>...> LoadManyAt(std::memory_order order) const
+         {
+            const auto word = _word.load(order);
+            return SectionGroup<Data_t, Numbers, Indices...>::Get(&word);
+         }
+
+         template<size_t... Indices>
+         void StoreManyAt(std::memory_order order, SectionValue_t<Indices>... values)
+         {
+            auto current = _word.load(FailureOrder(order));
+            Data_t desired;
+            do
+            {
+               desired = current;
+               SectionGroup<Data_t, Numbers, Indices...>::Set(&desired, values...);
+            } while (!_word.compare_exchange_weak(current, desired, order));
+         }
+
+         //! \brief Replaces the section if it equals 'expected'. Changes of other sections don't make this fail,
+         //!        the loop retries until either the section differs or the exchange succeeds
+         template<size_t Index>
+         bool CompareExchangeAt(SectionValue_t<Index>& expected, SectionValue_t<Index> desired,
+            std::memory_order order)
+         {
+            auto current = _word.load(FailureOrder(order));
+            do
+            {
+               const auto section = GetSection<Index>(current);
+               if (section != expected)
+               {
+                  expected = section;
+                  return false;
+               }
+            } while (!_word.compare_exchange_weak(current, WithSection<Index>(current, desired), order));
+            return true;
+         }
+
+         //! \brief Adds to the section, wrapping around at the size of the section so that no carry reaches the
+         //!        next section
+         //! \returns The previous value of the section
+         template<size_t Index>
+         SectionValue_t<Index> FetchAddAt(uint64_t delta, std::memory_order order)
+         {
+            return FetchAddAt<Index>(delta, order, IsTopSection<Index>());
+         }
+
+         //! \brief Calls func with references to the values of the given sections and stores the results, all as
+         //!        one atomic operation. func may be called several times if other threads modify the bitmask
+         //!        concurrently, so it must not have side effects
+         //! \returns The bitmask before the modification
+         template<size_t... Indices, typename Func>
+         Mask_t ModifyAt(Func&& func, std::memory_order order)
+         {
+            using Group_t = SectionGroup<Data_t, Numbers, Indices...>;
+            auto current = _word.load(FailureOrder(order));
+            Data_t desired;
+            do
+            {
+               auto values = Group_t::Get(&current);
+               desired = current;
+               Apply<Indices...>(desired, values, func, std::make_index_sequence<sizeof...(Indices)>());
+            } while (!_word.compare_exchange_weak(current, desired, order));
+            return FromWord(current);
+         }
+
+      private:
+         //! \brief The highest section can be added to with a plain fetch_add if it ends at the last bit of the
+         //!        storage word, because the carry out of it is discarded by the hardware
+         template<size_t Index>
+         using IsTopSection = std::integral_constant<bool,
+            Index == Sections - 1 && Mask_t::RequiredSize == sizeof(Data_t) * 8>;
+
+         template<size_t Index>
+         SectionValue_t<Index> FetchAddAt(uint64_t delta, std::memory_order order, std::true_type)
+         {
+            const auto previous = _word.fetch_add(static_cast<Data_t>(delta << Section_t<Index>::Shift), order);
+            return GetSection<Index>(previous);
+         }
+
+         template<size_t Index>
+         SectionValue_t<Index> FetchAddAt(uint64_t delta, std::memory_order order, std::false_type)
+         {
+            auto current = _word.load(FailureOrder(order));
+            SectionValue_t<Index> previous;
+            do
+            {
+               previous = GetSection<Index>(current);
+            } while (!_word.compare_exchange_weak(current,
+               WithSection<Index>(current, static_cast<uint64_t>(previous) + delta), order));
+            return previous;
+         }
+
+         template<size_t... Indices, typename Tuple, typename Func, size_t... Is>
+         static void Apply(Data_t& word, Tuple& values, Func& func, std::index_sequence<Is...>)
+         {
+            func(std::get<Is>(values)...);
+            SectionGroup<Data_t, Numbers, Indices...>::Set(&word, std::get<Is>(values)...);
+         }
+
+         template<size_t Index>
+         static SectionValue_t<Index> GetSection(Data_t word)
+         {
+            return static_cast<SectionValue_t<Index>>(Section_t<Index>::Get(&word));
+         }
+
+         template<size_t Index>
+         static Data_t WithSection(Data_t word, uint64_t value)
+         {
+            Section_t<Index>::Set(&word, value);
+            return word;
+         }
+
+         static Data_t ToWord(const Mask_t& value)
+         {
+            return SingleWord<Mask_t>::ToWord(value);
+         }
+
+         static Mask_t FromWord(Data_t word)
+         {
+            return SingleWord<Mask_t>::FromWord(word);
+         }
+
+         std::atomic<Data_t> _word;
+      };
+
+   }
+
+   //! \brief Bitmask<Bits...> that can be shared between threads without a lock. All bits are stored in a single
+   //!        atomic word, so the bitmask can't be larger than 64 bits. Each operation is atomic with respect to the
+   //!        whole bitmask, including the operations that modify several sections at once
+   template<size_t... Bits>
+   class AtomicBitmask : public detail::AtomicBitmaskBase<Bitmask<Bits...>>
+   {
+      using Base_t = detail::AtomicBitmaskBase<Bitmask<Bits...>>;
+
+      template<size_t Index>
+      using ValueSize_t = detail::SizeToType_t<meta::At_t<Index, typename Base_t::Numbers>::value>;
+   public:
+      using Base_t::Base_t;
+      using Base_t::Load;
+      using Base_t::Store;
+      using Base_t::CompareExchange;
+
+      //! \brief Loads the section at Index
+      template<size_t Index>
+      ValueSize_t<Index> Load(std::memory_order order = std::memory_order_seq_cst) const
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template LoadAt<Index>(order);
+      }
+
+      //! \brief Loads the sections with the given indices from a single snapshot of the bitmask
+      template<size_t... Indices>
+      std::tuple<ValueSize_t<Indices>...> LoadMany(std::memory_order order = std::memory_order_seq_cst) const
+      {
+         return this->template LoadManyAt<Indices...>(order);
+      }
+
+      //! \brief Stores the section at Index, leaving all other sections unchanged
+      template<size_t Index>
+      void Store(ValueSize_t<Index> value, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         this->template StoreManyAt<Index>(order, value);
+      }
+
+      //! \brief Stores the sections with the given indices at once, leaving all other sections unchanged
+      template<size_t... Indices>
+      void StoreMany(ValueSize_t<Indices>... values, std::memory_order order = std::memory_order_seq_cst)
+      {
+         this->template StoreManyAt<Indices...>(order, values...);
+      }
+
+      //! \brief Replaces the section at Index if it equals 'expected'. Otherwise, 'expected' receives the current
+      //!        value of the section
+      //! \returns True if the section was replaced
+      template<size_t Index>
+      bool CompareExchange(ValueSize_t<Index>& expected, ValueSize_t<Index> desired,
+         std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template CompareExchangeAt<Index>(expected, desired, order);
+      }
+
+      //! \brief Adds to the section at Index. The section wraps around at its size without touching the other
+      //!        sections
+      //! \returns The previous value of the section
+      template<size_t Index>
+      ValueSize_t<Index> FetchAdd(ValueSize_t<Index> delta, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template FetchAddAt<Index>(delta, order);
+      }
+
+      //! \brief Subtracts from the section at Index, see FetchAdd
+      template<size_t Index>
+      ValueSize_t<Index> FetchSub(ValueSize_t<Index> delta, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template FetchAddAt<Index>(uint64_t(0) - delta, order);
+      }
+
+      //! \brief Atomically modifies the sections with the given indices. func is called with references to their
+      //!        current values and may be called several times under contention
+      //! \returns The bitmask before the modification
+      template<size_t... Indices, typename Func>
+      Bitmask<Bits...> Modify(Func&& func, std::memory_order order = std::memory_order_seq_cst)
+      {
+         return this->template ModifyAt<Indices...>(std::forward<Func>(func), order);
+      }
+   };
+
+   //! \brief NamedBitmask<NamedBits...> that can be shared between threads without a lock, see AtomicBitmask
+   template<typename... NamedBits>
+   class AtomicNamedBitmask : public detail::AtomicBitmaskBase<NamedBitmask<NamedBits...>>
+   {
+      using Base_t = detail::AtomicBitmaskBase<NamedBitmask<NamedBits...>>;
+   public:
+      using NamedSections = meta::Typelist<NamedBits...>;
+
+   private:
+      template<typename Section>
+      using Index = meta::IndexOf<Section, NamedSections>;
+
+      template<typename Section>
+      using ValueSize_t = detail::SizeTypeToType_t<Section>;
+
+   public:
+      using Base_t::Base_t;
+      using Base_t::Load;
+      using Base_t::Store;
+      using Base_t::CompareExchange;
+
+      template<typename Section>
+      ValueSize_t<Section> Load(std::memory_order order = std::memory_order_seq_cst) const
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template LoadAt<Index<Section>::value>(order);
+      }
+
+      template<typename... Sections>
+      std::tuple<ValueSize_t<Sections>...> LoadMany(std::memory_order order = std::memory_order_seq_cst) const
+      {
+         return this->template LoadManyAt<Index<Sections>::value...>(order);
+      }
+
+      template<typename Section>
+      void Store(ValueSize_t<Section> value, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         this->template StoreManyAt<Index<Section>::value>(order, value);
+      }
+
+      template<typename... Sections>
+      void StoreMany(ValueSize_t<Sections>... values, std::memory_order order = std::memory_order_seq_cst)
+      {
+         this->template StoreManyAt<Index<Sections>::value...>(order, values...);
+      }
+
+      template<typename Section>
+      bool CompareExchange(ValueSize_t<Section>& expected, ValueSize_t<Section> desired,
+         std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template CompareExchangeAt<Index<Section>::value>(expected, desired, order);
+      }
+
+      template<typename Section>
+      ValueSize_t<Section> FetchAdd(ValueSize_t<Section> delta, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template FetchAddAt<Index<Section>::value>(delta, order);
+      }
+
+      template<typename Section>
+      ValueSize_t<Section> FetchSub(ValueSize_t<Section> delta, std::memory_order order = std::memory_order_seq_cst)
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template FetchAddAt<Index<Section>::value>(uint64_t(0) - delta, order);
+      }
+
+      template<typename... Sections, typename Func>
+      NamedBitmask<NamedBits...> Modify(Func&& func, std::memory_order order = std::memory_order_seq_cst)
+      {
+         return this->template ModifyAt<Index<Sections>::value...>(std::forward<Func>(func), order);
+      }
+   };
+
+}
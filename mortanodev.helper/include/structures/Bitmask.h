@@ -2,6 +2,9 @@
 #include <type_traits>
 #include <stdint.h>
 #include <cstring>
+#include <functional>
+#include <tuple>
+#include <utility>
 
 #include "..\meta\Meta.h"
 
@@ -21,8 +24,8 @@ namespace mdv
                                 uint16_t,
                                 std::conditional_t<Size <= sizeof(uint32_t) * 8,
                                                    uint32_t,
-                                                   uint64_t  // Bitmask asserts that the sum is not
-                                                             // greater than 64 bits, so this is ok!
+                                                   uint64_t  // Bitmasks of more than 64 bits use an
+                                                             // array of uint64_t, so this is ok!
                                                    > > >;
       };
 
@@ -32,6 +35,12 @@ namespace mdv
       template<typename T>
       using SizeTypeToType_t = typename SizeToType<T::value>::type;
 
+      //! \brief Number of bits that are required to store the given value
+      constexpr size_t BitsRequired(size_t value)
+      {
+         return value == 0 ? 0 : 1 + BitsRequired(value >> 1);
+      }
+
       //! \brief Creates a mask where the first Size bits are set
       //!
       //! Example: Mask<1>::value => 0b00000001
@@ -40,20 +49,115 @@ namespace mdv
       //!          etc.
       template<size_t Size>
       struct Mask :
-         std::integral_constant<size_t,
+         std::integral_constant<uint64_t,
             Size == 0 ? 
             0 :
             1 | (Mask<Size-1>::value << 1)
          >
       {
+         static_assert(Size <= 64, "Masks of more than 64 bits are not supported!");
       };
 
       template<>
       struct Mask<0> :
-         std::integral_constant<size_t, 0>
+         std::integral_constant<uint64_t, 0>
       {
       };
 
+      //! \brief Number of bits in a single storage word of a Bitmask
+      constexpr size_t WordBits = sizeof(uint64_t) * 8;
+
+      //! \brief Storage type of a Bitmask with the given number of bits. Up to 64 bits, this is the smallest
+      //!        unsigned integer that can hold all bits. Larger bitmasks use an array of uint64_t words
+      template<size_t RequiredSize>
+      struct BitmaskStorage
+      {
+         constexpr static size_t WordCount = RequiredSize <= WordBits ? 1 : (RequiredSize + WordBits - 1) / WordBits;
+         using Word_t = std::conditional_t<RequiredSize <= WordBits, SizeToType_t<RequiredSize>, uint64_t>;
+      };
+
+      template<
+         typename Word_t,     //The storage word type of the Bitmask
+         size_t Offset,       //Offset of the section in bits, counted from the first bit of the first word
+         size_t Size,         //Size of the section in bits
+         bool Straddles = ((Offset % WordBits) + Size > WordBits)
+      >
+      struct SectionAccess;
+
+      //! \brief Access to a section that lies completely inside a single word. This is a single shift and mask
+      template<typename Word_t, size_t Offset, size_t Size>
+      struct SectionAccess<Word_t, Offset, Size, false>
+      {
+         constexpr static size_t WordIndex = Offset / WordBits;
+         constexpr static size_t Shift = Offset % WordBits;
+         constexpr static uint64_t Mask = detail::Mask<Size>::value;
+
+         constexpr static uint64_t Get(const Word_t* data)
+         {
+            return (static_cast<uint64_t>(data[WordIndex]) >> Shift) & Mask;
+         }
+
+         static void Set(Word_t* data, uint64_t value)
+         {
+            //First clear the data because we don't want any bits to remain in the section, then set the new bits
+            data[WordIndex] = static_cast<Word_t>(
+               (data[WordIndex] & ~(Mask << Shift)) | ((value & Mask) << Shift));
+         }
+      };
+
+      //! \brief Access to a section that straddles the boundary between two words. The lower bits of the section
+      //!        are the upper bits of the first word, the upper bits of the section are the lower bits of the second
+      //!        word. Both parts are spliced together with shifts that are known at compile time
+      template<typename Word_t, size_t Offset, size_t Size>
+      struct SectionAccess<Word_t, Offset, Size, true>
+      {
+         static_assert(std::is_same<Word_t, uint64_t>::value, "Only multi-word bitmasks can have straddling sections!");
+
+         constexpr static size_t WordIndex = Offset / WordBits;
+         constexpr static size_t Shift = Offset % WordBits;
+         //Number of bits of the section that lie in the first word
+         constexpr static size_t LowBits = WordBits - Shift;
+         constexpr static uint64_t Mask = detail::Mask<Size>::value;
+
+         constexpr static uint64_t Get(const Word_t* data)
+         {
+            return ((data[WordIndex] >> Shift) | (data[WordIndex + 1] << LowBits)) & Mask;
+         }
+
+         static void Set(Word_t* data, uint64_t value)
+         {
+            data[WordIndex] = (data[WordIndex] & ~(Mask << Shift)) | ((value & Mask) << Shift);
+            data[WordIndex + 1] = (data[WordIndex + 1] & ~(Mask >> LowBits)) | ((value & Mask) >> LowBits);
+         }
+      };
+
+      //! \brief Access to the section with the given index of a Bitmask with the given section sizes
+      template<typename Word_t, typename Numbers, size_t Index>
+      struct Section :
+         SectionAccess<
+            Word_t,
+            meta::Sum<meta::Take_t<Index, Numbers>>::value, //The offset is the sum of all previous sections
+            meta::At_t<Index, Numbers>::value
+         >
+      {
+         constexpr static size_t Bits = meta::At_t<Index, Numbers>::value;
+         static_assert(Bits <= 64, "Sections of more than 64 bits are not supported!");
+
+         //And, neat sideeffect, we can determine the correct value type from the size of the section
+         using Value_t = SizeToType_t<Bits>;
+      };
+
+      //! \brief The part of a section value that falls into the storage word with the given index
+      template<size_t Word, size_t Offset, size_t Size>
+      constexpr uint64_t ShiftIntoWord(uint64_t value)
+      {
+         return (Offset + Size <= Word * WordBits || Offset >= (Word + 1) * WordBits) ?
+            0 :
+            Offset >= Word * WordBits ?
+               (value & Mask<Size>::value) << (Offset % WordBits) :
+               (value & Mask<Size>::value) >> ((Word * WordBits - Offset) % WordBits);
+      }
+
       template<
          typename SectionList,      //A list with all sections of the Bitmask
          size_t CumulativeOffset   //The cumulative offset of all previous sections
@@ -73,18 +177,18 @@ namespace mdv
          CumulativeOffset
       >
       {
-         template<typename First, typename... Other>
-         static uint64_t Get(First first, Other... other)
+         //! \brief Assembles the storage word with the given index from the section values
+         template<size_t Word, typename First, typename... Other>
+         constexpr static uint64_t Get(First first, Other... other)
          {
             static_assert(sizeof...(OtherSections) == sizeof...(Other), "Section parameter pack and function arguments must have the same size!");
       
-            constexpr static size_t Mask = detail::Mask<FirstSection>::value;
             //Mask and shift the current value and then OR with the remaining values
-            return ((first & Mask) << CumulativeOffset) |
+            return ShiftIntoWord<Word, CumulativeOffset, FirstSection>(first) |
                MaskAndOffset<
                   meta::Numberlist<OtherSections...>, //Skip the current section
                   CumulativeOffset + FirstSection    //Add the size of this section to the offset
-               >::Get(other...);
+               >::template Get<Word>(other...);
          }
       };
       
@@ -94,11 +198,136 @@ namespace mdv
          CumulativeOffset
       >
       {
-         template<typename First>
-         static uint64_t Get(First first)
+         template<size_t Word, typename First>
+         constexpr static uint64_t Get(First first)
+         {
+            return ShiftIntoWord<Word, CumulativeOffset, FirstSection>(first);
+         }
+      };
+
+      //! \brief Assembles the storage word with the given index of a bitmask from all section values. This is a
+      //!        single expression that ORs together the masked and shifted values, so it can initialize the storage
+      //!        at compile time and compiles to a single store per word at runtime
+      template<typename Data_t, typename Numbers, size_t Word, typename... Args>
+      constexpr Data_t AssembleWord(Args... args)
+      {
+         return static_cast<Data_t>(MaskAndOffset<Numbers, 0>::template Get<Word>(args...));
+      }
+
+      //! \brief Access to several sections of a bitmask at once. Setting them computes one combined mask and one
+      //!        combined value per storage word at compile time, so each word is cleared and ORed only once
+      //!        instead of once per section. Each section may only be given once
+      template<typename Data_t, typename Numbers, size_t... Indices>
+      struct SectionGroup
+      {
+         constexpr static size_t WordCount = BitmaskStorage<meta::Sum<Numbers>::value>::WordCount;
+
+         template<size_t Index>
+         using Value_t = typename Section<Data_t, Numbers, Index>::Value_t;
+
+         template<size_t Index>
+         using Offset = meta::Sum<meta::Take_t<Index, Numbers>>;
+
+         //! \brief All bits of the given sections inside the storage word with the given index
+         template<size_t Word, size_t... SectionIndices>
+         struct WordMask : std::integral_constant<uint64_t, 0> {};
+
+         template<size_t Word, size_t First, size_t... Rest>
+         struct WordMask<Word, First, Rest...> :
+            std::integral_constant<uint64_t,
+               ShiftIntoWord<Word, Offset<First>::value, meta::At_t<First, Numbers>::value>(~uint64_t(0)) |
+               WordMask<Word, Rest...>::value
+            >
+         {
+         };
+
+         template<size_t Word>
+         constexpr static uint64_t WordValue()
          {
-            constexpr static size_t Mask = detail::Mask<FirstSection>::value;
-            return ((first & Mask) << CumulativeOffset);
+            return 0;
+         }
+
+         //! \brief The bits of the given section values inside the storage word with the given index
+         template<size_t Word, size_t First, size_t... Rest, typename Value, typename... Values>
+         constexpr static uint64_t WordValue(Value value, Values... values)
+         {
+            return ShiftIntoWord<Word, Offset<First>::value, meta::At_t<First, Numbers>::value>(value) |
+               WordValue<Word, Rest...>(values...);
+         }
+
+         static void Set(Data_t* data, Value_t<Indices>... values)
+         {
+            SetWords(data, std::make_index_sequence<WordCount>(), values...);
+         }
+
+         static std::tuple<Value_t<Indices>...> Get(const Data_t* data)
+         {
+            return std::tuple<Value_t<Indices>...>(
+               static_cast<Value_t<Indices>>(Section<Data_t, Numbers, Indices>::Get(data))...);
+         }
+
+      private:
+         template<size_t... Words>
+         static void SetWords(Data_t* data, std::index_sequence<Words...>, Value_t<Indices>... values)
+         {
+            //Words that contain none of the sections have an empty mask and value, the compiler removes those
+            using swallow = int[];
+            (void)swallow {
+               0, ((void)(data[Words] = static_cast<Data_t>(
+                  (data[Words] & ~WordMask<Words, Indices...>::value) | WordValue<Words, Indices...>(values...))), 0)...
+            };
+         }
+      };
+
+      //! \brief Final mixing step of MurmurHash3. Every input bit affects every output bit, so sections in the
+      //!        high bits of a word still change the low bits of the hash that hash maps use for their buckets
+      inline uint64_t MixWord(uint64_t word)
+      {
+         word ^= word >> 33;
+         word *= 0xff51afd7ed558ccdULL;
+         word ^= word >> 33;
+         word *= 0xc4ceb9fe1a85ec53ULL;
+         word ^= word >> 33;
+         return word;
+      }
+
+      //! \brief Access to the storage words of a bitmask of any size, for algorithms that work on the whole
+      //!        storage instead of single sections
+      template<typename Mask_t>
+      struct StorageWords
+      {
+         using Storage_t = BitmaskStorage<Mask_t::RequiredSize>;
+         using Word_t = typename Storage_t::Word_t;
+         constexpr static size_t WordCount = Storage_t::WordCount;
+
+         //! \brief Copies the storage words of the given bitmask to words
+         static void Read(const Mask_t& mask, Word_t* words)
+         {
+            std::memcpy(words, &mask, sizeof(Word_t) * WordCount);
+         }
+
+         static bool Equal(const Word_t* l, const Word_t* r)
+         {
+            for (size_t i = 0; i < WordCount; ++i)
+            {
+               if (l[i] != r[i])
+                  return false;
+            }
+            return true;
+         }
+
+         //! \brief Hash over all storage words. Bits that belong to no section are always zero, so they don't
+         //!        change the hash
+         static size_t Hash(const Mask_t& mask)
+         {
+            Word_t words[WordCount];
+            Read(mask, words);
+            uint64_t hash = 0;
+            for (size_t i = 0; i < WordCount; ++i)
+            {
+               hash = MixWord(hash ^ words[i]);
+            }
+            return static_cast<size_t>(hash);
          }
       };
 
@@ -107,7 +336,9 @@ namespace mdv
    //! \brief Super-awesome Bitmask of variable size
    //!        Allows to specify a couple of integers that define the size of each section within the bitmask and access
    //!        the data in each of these sections separately.
-   //! ONLY SUPPORTS BITMASK OF UP TO 64 BITS!
+   //! Bitmasks of up to 64 bits are stored in the smallest fitting unsigned integer, larger bitmasks in an array of
+   //! uint64_t. A single section can't be larger than 64 bits. Sections that straddle two words are spliced
+   //! together from both words, all offsets and shifts are resolved at compile time.
    template<size_t... Bits>
    class Bitmask
    {
@@ -119,7 +350,7 @@ namespace mdv
 
       //! \brief Default ctor, sets all bits to zero
       constexpr Bitmask() : 
-         _data(0)
+         _data{}
       {
       }
 
@@ -127,23 +358,25 @@ namespace mdv
       //! \param args One value for each section of this Bitmask. The type of that value matches the size of 
       //!             the section (uint8_t for 8 bit or less, uint16_t for 16 bits or less etc.)
       constexpr explicit Bitmask(detail::SizeToType_t<Bits>... args) :
-         _data(0) //TODO Assemble all args into one bitmask at once and assign this to _data!
+         Bitmask(std::make_index_sequence<Storage_t::WordCount>(), args...)
       {
-         using Indices_t = std::make_index_sequence<Sections>;
-         SetAllFromArgs(args..., Indices_t());
       }
 
       //! \brief Copy ctor
-      Bitmask(const Bitmask& other)         
+      Bitmask(const Bitmask& other) = default;
+
+      //! \brief Copy assignment
+      Bitmask& operator=(const Bitmask& other) = default;
+
+      //! \brief Two bitmasks are equal if all of their sections are equal
+      bool operator==(const Bitmask& other) const
       {
-         _data = other._data;
+         return detail::StorageWords<Bitmask>::Equal(_data, other._data);
       }
 
-      //! \brief Copy assignment
-      Bitmask& operator=(const Bitmask& other)
+      bool operator!=(const Bitmask& other) const
       {
-         _data = other._data;
-         return *this;
+         return !(*this == other);
       }
 
       //! \brief Sets the bits of the section with the given index
@@ -159,60 +392,80 @@ namespace mdv
       {
          static_assert(Index < Sections, "Index out of bounds!");         
 
-         //Get the previous sections of this bitmask, these are the bits that we have to skip
-         using Previous_t = meta::Take_t<Index, Numbers>;
-         //By summing the elements of the previous section, we get the total bit count to skip
-         constexpr static size_t OffsetBits = meta::Sum<Previous_t>::value;
-         //We also need the size of the current section
-         constexpr static size_t SectionBits = meta::At_t<Index, Numbers>::value;
-         //Now we can create a mask of the size of the current section
-         constexpr static size_t Mask = detail::Mask<SectionBits>::value;
-
-         //First clear the data because we don't want any bits to remain in the section
-         _data &= ~(Mask << OffsetBits);
-         //Then set the new bits
-         _data |= (value & Mask) << OffsetBits;
+         //The offset of the section is the sum of all previous sections. It is known at compile time, so this is a
+         //single shift and mask (or two, if the section straddles two words)
+         detail::Section<Data_t, Numbers, Index>::Set(_data, value);
       }
 
       //! \brief Get the value inside this bitmask at the given section index
       //! \returns Value of the section at Index
       //! \tparam Index Index of the section to get the value from     
       template<size_t Index>
-      decltype(auto) Get() const
+      constexpr decltype(auto) Get() const
       {
          static_assert(Index < Sections, "Index out of bounds!");
 
-         //Get the previous sections of this bitmask, these are the bits that we have to skip
-         using Previous_t = meta::Take_t<Index, Numbers>;
-         //By summing the elements of the previous section, we get the total bit count to skip
-         constexpr static size_t OffsetBits = meta::Sum<Previous_t>::value;
-         //We also need the size of the current section
-         constexpr static size_t SectionBits = meta::At_t<Index, Numbers>::value;
-         //Now we can create a mask of the size of the current section
-         constexpr static size_t Mask = detail::Mask<SectionBits>::value;
-         //And, neat sideeffect, we can determine the correct return type from the size of the current section
-         using Return_t = detail::SizeToType_t<SectionBits>;
-
-         return static_cast<Return_t>( (_data >> OffsetBits) & Mask ); 
+         using Section_t = detail::Section<Data_t, Numbers, Index>;
+         return static_cast<typename Section_t::Value_t>(Section_t::Get(_data));
+      }
+
+      //! \brief Sets the sections with the given indices at once. This clears and sets each storage word only
+      //!        once, no matter how many sections are set
+      //! \param values One value for each of the given sections
+      template<size_t... Indices>
+      void SetMany(detail::SizeToType_t<meta::At_t<Indices, Numbers>::value>... values)
+      {
+         detail::SectionGroup<Data_t, Numbers, Indices...>::Set(_data, values...);
+      }
+
+      //! \brief Get the values of the sections with the given indices
+      //! \returns Tuple with one value for each of the given sections, works with std::tie
+      template<size_t... Indices>
+      decltype(auto) GetMany() const
+      {
+         return detail::SectionGroup<Data_t, Numbers, Indices...>::Get(_data);
+      }
+
+      //! \brief Get the values of all sections
+      decltype(auto) GetAll() const
+      {
+         return GetAllSections(std::make_index_sequence<Sections>());
+      }
+
+      //! \brief Calls func with references to the values of the sections with the given indices and writes the
+      //!        modified values back with a single SetMany
+      template<size_t... Indices, typename Func>
+      void Modify(Func&& func)
+      {
+         auto values = GetMany<Indices...>();
+         ApplyAndSet<Indices...>(values, std::forward<Func>(func), std::make_index_sequence<sizeof...(Indices)>());
       }
 
    private:
-      constexpr static size_t RequiredBytes = (RequiredSize + 7) / 8;
-      static_assert(RequiredBytes <= sizeof(uint64_t), "Maximum bitmask size exceeded! Largest supported type is uint64_t!");
+      using Storage_t = detail::BitmaskStorage<RequiredSize>;
+      using Data_t = typename Storage_t::Word_t;
 
-      //! \brief Sets each section value by extracting the corresponding value from the tuple
-      //! This uses an index_sequence to set along the elements of the tuple, get each element and call Set<> for each element
       template<size_t... Is>
-      inline void SetAllFromArgs(detail::SizeToType_t<Bits>... args, std::index_sequence<Is...>)
+      decltype(auto) GetAllSections(std::index_sequence<Is...>) const
       {
-         using swallow = int[];
-         (void)swallow {
-            0, ((void)Set<Is>( args ),0)...
-         };
+         return GetMany<Is...>();
+      }
+
+      template<size_t... Indices, typename Tuple, typename Func, size_t... Is>
+      void ApplyAndSet(Tuple& values, Func&& func, std::index_sequence<Is...>)
+      {
+         std::forward<Func>(func)(std::get<Is>(values)...);
+         SetMany<Indices...>(std::get<Is>(values)...);
       }
 
-      using Data_t = detail::SizeToType_t<RequiredSize>;
-      Data_t _data;
+      //! \brief Assembles each storage word from all section values
+      template<size_t... Words>
+      constexpr Bitmask(std::index_sequence<Words...>, detail::SizeToType_t<Bits>... args) :
+         _data{ detail::AssembleWord<Data_t, Numbers, Words>(args...)... }
+      {
+      }
+
+      Data_t _data[Storage_t::WordCount];
    };
 
    template<>
@@ -229,7 +482,7 @@ namespace mdv
       constexpr static size_t RequiredSize = meta::Sum<Numbers>::value;
 
       constexpr NamedBitmask() :
-         _data(0)
+         _data{}
       {
       }
 
@@ -237,19 +490,22 @@ namespace mdv
       //! \param args One value for each section of this Bitmask. The type of that value matches the size of 
       //!             the section (uint8_t for 8 bit or less, uint16_t for 16 bits or less etc.)
       constexpr explicit NamedBitmask(detail::SizeTypeToType_t<NamedBits>... args) :
-         _data(static_cast<decltype(_data)>(detail::MaskAndOffset<Numbers, 0>::Get(args...)))
+         NamedBitmask(std::make_index_sequence<Storage_t::WordCount>(), args...)
       {
       }
 
-      NamedBitmask(const NamedBitmask& other)
+      NamedBitmask(const NamedBitmask& other) = default;
+
+      NamedBitmask& operator=(const NamedBitmask& other) = default;
+
+      bool operator==(const NamedBitmask& other) const
       {
-         _data = other._data;
+         return detail::StorageWords<NamedBitmask>::Equal(_data, other._data);
       }
 
-      NamedBitmask& operator=(const NamedBitmask& other)
+      bool operator!=(const NamedBitmask& other) const
       {
-         _data = other._data;
-         return *this;
+         return !(*this == other);
       }
 
       template<
@@ -264,56 +520,169 @@ namespace mdv
       {
          static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
 
-         //First get the index of the section from the NamedSections typelist
-         constexpr static size_t SectionIndex = meta::IndexOf<Section, NamedSections>::value;
-         //Get the previous sections of this bitmask, these are the bits that we have to skip
-         using Previous_t = meta::Take_t<SectionIndex, Numbers>;
-         //By summing the elements of the previous section, we get the total bit count to skip
-         constexpr static size_t OffsetBits = meta::Sum<Previous_t>::value;
-         //We also need the size of the current section
-         constexpr static size_t SectionBits = meta::At_t<SectionIndex, Numbers>::value;
-         //Now we can create a mask of the size of the current section
-         constexpr static size_t Mask = detail::Mask<SectionBits>::value;
-
-         //First clear the data because we don't want any bits to remain in the section
-         _data &= ~(Mask << OffsetBits);
-         //Then set the new bits
-         _data |= (value & Mask) << OffsetBits;
+         //Get the index of the section from the NamedSections typelist, everything else works like in Bitmask
+         detail::Section<Data_t, Numbers, meta::IndexOf<Section, NamedSections>::value>::Set(_data, value);
       }
 
       //! \brief Get the value inside this bitmask at the given section
       //! \returns Value of the section at Index
       //! \tparam Section The section to get the value from 
       template<typename Section>
-      decltype(auto) Get() const
+      constexpr decltype(auto) Get() const
       {
          static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
 
-         //First get the index of the section from the NamedSections typelist
-         constexpr static size_t SectionIndex = meta::IndexOf<Section, NamedSections>::value;
-         //Get the previous sections of this bitmask, these are the bits that we have to skip
-         using Previous_t = meta::Take_t<SectionIndex, Numbers>;
-         //By summing the elements of the previous section, we get the total bit count to skip
-         constexpr static size_t OffsetBits = meta::Sum<Previous_t>::value;
-         //We also need the size of the current section
-         constexpr static size_t SectionBits = meta::At_t<SectionIndex, Numbers>::value;
-         //Now we can create a mask of the size of the current section
-         constexpr static size_t Mask = detail::Mask<SectionBits>::value;
-         //And, neat sideeffect, we can determine the correct return type from the size of the current section
-         using Return_t = detail::SizeToType_t<SectionBits>;
-
-         return static_cast<Return_t>((_data >> OffsetBits) & Mask);
+         using Section_t = detail::Section<Data_t, Numbers, meta::IndexOf<Section, NamedSections>::value>;
+         return static_cast<typename Section_t::Value_t>(Section_t::Get(_data));
+      }
+
+      //! \brief Sets the given sections at once, see Bitmask::SetMany
+      template<typename... Sections>
+      void SetMany(detail::SizeTypeToType_t<Sections>... values)
+      {
+         static_assert(meta::Foldl_t<meta::And, std::true_type,
+            meta::Typelist<std::bool_constant<meta::Contains<Sections, NamedSections>::value>...>>::value,
+            "Section not found in this Bitmask!");
+         detail::SectionGroup<Data_t, Numbers, meta::IndexOf<Sections, NamedSections>::value...>::Set(_data, values...);
+      }
+
+      //! \brief Get the values of the given sections
+      //! \returns Tuple with one value for each of the given sections, works with std::tie
+      template<typename... Sections>
+      decltype(auto) GetMany() const
+      {
+         return detail::SectionGroup<Data_t, Numbers, meta::IndexOf<Sections, NamedSections>::value...>::Get(_data);
+      }
+
+      //! \brief Get the values of all sections, in the order of the NamedBits
+      decltype(auto) GetAll() const
+      {
+         return GetMany<NamedBits...>();
+      }
+
+      //! \brief Calls func with references to the values of the given sections and writes the modified values back
+      //!        with a single SetMany
+      template<typename... Sections, typename Func>
+      void Modify(Func&& func)
+      {
+         auto values = GetMany<Sections...>();
+         ApplyAndSet<Sections...>(values, std::forward<Func>(func), std::index_sequence_for<Sections...>());
       }
 
    private:
-      constexpr static size_t RequiredBytes = (RequiredSize + 7) / 8;
-      static_assert(RequiredBytes <= sizeof(uint64_t), "Maximum bitmask size exceeded! Largest supported type is uint64_t!");
+      using Storage_t = detail::BitmaskStorage<RequiredSize>;
+      using Data_t = typename Storage_t::Word_t;
 
-      using Data_t = detail::SizeToType_t<RequiredSize>;
-      Data_t _data;
+      template<typename... Sections, typename Tuple, typename Func, size_t... Is>
+      void ApplyAndSet(Tuple& values, Func&& func, std::index_sequence<Is...>)
+      {
+         std::forward<Func>(func)(std::get<Is>(values)...);
+         SetMany<Sections...>(std::get<Is>(values)...);
+      }
+
+      //! \brief Assembles each storage word from all section values
+      template<size_t... Words>
+      constexpr NamedBitmask(std::index_sequence<Words...>, detail::SizeTypeToType_t<NamedBits>... args) :
+         _data{ detail::AssembleWord<Data_t, Numbers, Words>(args...)... }
+      {
+      }
+
+      Data_t _data[Storage_t::WordCount];
    };
 
    template<>
    class NamedBitmask<> {};
 
-}
\ No newline at end of file
+   namespace detail
+   {
+
+      template<typename Mask_t>
+      struct IndexedSections;
+
+      //! \brief Access to the sections of a Bitmask by their index
+      template<size_t... Bits>
+      struct IndexedSections<Bitmask<Bits...>>
+      {
+         template<size_t Index>
+         static decltype(auto) Get(const Bitmask<Bits...>& mask)
+         {
+            return mask.template Get<Index>();
+         }
+
+         template<size_t Index, typename Value_t>
+         static void Set(Bitmask<Bits...>& mask, Value_t value)
+         {
+            mask.template Set<Index>(value);
+         }
+      };
+
+      //! \brief Access to the sections of a NamedBitmask by their index
+      template<typename... NamedBits>
+      struct IndexedSections<NamedBitmask<NamedBits...>>
+      {
+         template<size_t Index>
+         static decltype(auto) Get(const NamedBitmask<NamedBits...>& mask)
+         {
+            return mask.template Get<meta::At_t<Index, meta::Typelist<NamedBits...>>>();
+         }
+
+         template<size_t Index, typename Value_t>
+         static void Set(NamedBitmask<NamedBits...>& mask, Value_t value)
+         {
+            mask.template Set<meta::At_t<Index, meta::Typelist<NamedBits...>>>(value);
+         }
+      };
+
+      //! \brief Conversion between a bitmask of up to 64 bits and its storage word, for algorithms that work on all
+      //!        sections at once
+      template<typename Mask_t>
+      struct SingleWord
+      {
+         using Word_t = typename BitmaskStorage<Mask_t::RequiredSize>::Word_t;
+
+         static_assert(BitmaskStorage<Mask_t::RequiredSize>::WordCount == 1, "Bitmask must have at most 64 bits!");
+         static_assert(sizeof(Mask_t) == sizeof(Word_t), "Bitmask must consist of exactly one word!");
+
+         static Word_t ToWord(const Mask_t& value)
+         {
+            Word_t word;
+            std::memcpy(&word, &value, sizeof(word));
+            return word;
+         }
+
+         static Mask_t FromWord(Word_t word)
+         {
+            Mask_t value;
+            std::memcpy(static_cast<void*>(&value), &word, sizeof(word));
+            return value;
+         }
+      };
+
+   }
+
+}
+
+namespace std
+{
+
+   //! \brief Hash for Bitmask, so that it can be used as key in unordered containers
+   template<size_t... Bits>
+   struct hash<mdv::Bitmask<Bits...>>
+   {
+      size_t operator()(const mdv::Bitmask<Bits...>& mask) const
+      {
+         return mdv::detail::StorageWords<mdv::Bitmask<Bits...>>::Hash(mask);
+      }
+   };
+
+   //! \brief Hash for NamedBitmask
+   template<typename... NamedBits>
+   struct hash<mdv::NamedBitmask<NamedBits...>>
+   {
+      size_t operator()(const mdv::NamedBitmask<NamedBits...>& mask) const
+      {
+         return mdv::detail::StorageWords<mdv::NamedBitmask<NamedBits...>>::Hash(mask);
+      }
+   };
+
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <stdint.h>
+#include <type_traits>
+
+#include "..\meta\Meta.h"
+#include "Bitmask.h"
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      namespace swar
+      {
+
+         //! \brief The lowest 'count' bits set
+         constexpr uint64_t LowBits(size_t count)
+         {
+            return count >= WordBits ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+         }
+
+         //! \brief Masks that describe where the sections of a bitmask lie. The SWAR algorithms treat the highest bit
+         //!        of each section separately, so that no carry or borrow can cross into the next section. The
+         //!        bitmask needs no guard bits between its sections for this
+         template<typename Numbers, size_t Offset = 0>
+         struct Masks;
+
+         template<size_t Offset>
+         struct Masks<meta::Numberlist<>, Offset>
+         {
+            constexpr static uint64_t High = 0;
+            constexpr static size_t MaxBits = 0;
+
+            template<size_t Shift>
+            constexpr static uint64_t Within()
+            {
+               return 0;
+            }
+         };
+
+         template<size_t First, size_t... Rest, size_t Offset>
+         struct Masks<meta::Numberlist<First, Rest...>, Offset>
+         {
+            using Next_t = Masks<meta::Numberlist<Rest...>, Offset + First>;
+
+            //! \brief The highest bit of each section
+            constexpr static uint64_t High = (First == 0 ? 0 : uint64_t(1) << (Offset + First - 1)) | Next_t::High;
+            //! \brief All bits of all sections
+            constexpr static uint64_t All = LowBits(Offset + First + meta::Sum<meta::Numberlist<Rest...>>::value);
+            //! \brief All bits of each section except for the highest one
+            constexpr static uint64_t Low = All & ~High;
+            //! \brief Size of the largest section
+            constexpr static size_t MaxBits = First > Next_t::MaxBits ? First : Next_t::MaxBits;
+
+            //! \brief The bits of each section that have another bit of the same section 'Shift' bits above them
+            template<size_t Shift>
+            constexpr static uint64_t Within()
+            {
+               return (First > Shift ? LowBits(First - Shift) << Offset : 0) | Next_t::template Within<Shift>();
+            }
+         };
+
+         template<typename Mask_t>
+         struct Ops
+         {
+            using Masks_t = Masks<typename Mask_t::Numbers>;
+            using Word_t = typename SingleWord<Mask_t>::Word_t;
+
+            constexpr static uint64_t High = Masks_t::High;
+            constexpr static uint64_t Low = Masks_t::Low;
+
+            static uint64_t Load(const Mask_t& mask)
+            {
+               return SingleWord<Mask_t>::ToWord(mask);
+            }
+
+            static Mask_t Store(uint64_t word)
+            {
+               return SingleWord<Mask_t>::FromWord(static_cast<Word_t>(word));
+            }
+
+            //! \brief Sums the low bits of each section, then fixes the highest bits. The carry out of a section is
+            //!        dropped
+            static uint64_t Add(uint64_t l, uint64_t r)
+            {
+               return ((l & Low) + (r & Low)) ^ ((l ^ r) & High);
+            }
+
+            //! \brief With the highest bit of each section of l set, subtracting the low bits of r never borrows
+            //!        from the next section
+            static uint64_t Sub(uint64_t l, uint64_t r)
+            {
+               return ((l | High) - (r & Low)) ^ ((l ^ ~r) & High);
+            }
+
+            //! \brief Highest bit of each section whose sum overflows
+            static uint64_t CarryFlags(uint64_t l, uint64_t r, uint64_t sum)
+            {
+               return ((l & r) | ((l | r) & ~sum)) & High;
+            }
+
+            //! \brief Highest bit of each section where l < r. The highest bit of (l | High) - (r & Low) tells
+            //!        whether the low bits of l are at least the low bits of r
+            static uint64_t LessFlags(uint64_t l, uint64_t r)
+            {
+               const auto lowNoBorrow = (l | High) - (r & Low);
+               return ((~l & r) | (~(l ^ r) & ~lowNoBorrow)) & High;
+            }
+
+            //! \brief Highest bit of each section where l == r, see ZeroFields for BitmaskArray
+            static uint64_t EqualFlags(uint64_t l, uint64_t r)
+            {
+               const auto diff = l ^ r;
+               const auto nonZero = (((diff & Low) + Low) | diff) & High;
+               return ~nonZero & High;
+            }
+
+            //! \brief Expands the highest bit of each section to the whole section. Each step copies the bits
+            //!        'Shift' positions down, but never across a section boundary
+            static uint64_t Expand(uint64_t flags)
+            {
+               return Expand<1>(flags, std::integral_constant<bool, (1 < Masks_t::MaxBits)>());
+            }
+
+            template<size_t Shift>
+            static uint64_t Expand(uint64_t flags, std::true_type)
+            {
+               flags |= (flags >> Shift) & Masks_t::template Within<Shift>();
+               return Expand<Shift * 2>(flags, std::integral_constant<bool, (Shift * 2 < Masks_t::MaxBits)>());
+            }
+
+            template<size_t Shift>
+            static uint64_t Expand(uint64_t flags, std::false_type)
+            {
+               return flags;
+            }
+
+            static uint64_t Select(uint64_t condition, uint64_t ifSet, uint64_t ifNotSet)
+            {
+               return (ifSet & condition) | (ifNotSet & ~condition);
+            }
+         };
+
+         template<typename T>
+         struct IsBitmask : std::false_type {};
+
+         template<size_t... Bits>
+         struct IsBitmask<Bitmask<Bits...>> : std::true_type {};
+
+         template<typename... NamedBits>
+         struct IsBitmask<NamedBitmask<NamedBits...>> : std::true_type {};
+
+         //! \brief Restricts the operations to Bitmask and NamedBitmask
+         template<typename Mask_t, typename Result_t = Mask_t>
+         using EnableIfBitmask_t = std::enable_if_t<IsBitmask<Mask_t>::value, Result_t>;
+
+      }
+
+   }
+
+   //The following functions work on all sections of a bitmask at once, with a few integer instructions on the
+   //storage word (SIMD within a register). They support bitmasks of up to 64 bits. Comparisons return a bitmask in
+   //which all bits of a section are set if the comparison is true for that section
+
+   //! \brief Adds each section of r to the same section of l, each section wraps around on overflow
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> AddSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::Store(Ops_t::Add(Ops_t::Load(l), Ops_t::Load(r)));
+   }
+
+   //! \brief Subtracts each section of r from the same section of l, each section wraps around on underflow
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> SubSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::Store(Ops_t::Sub(Ops_t::Load(l), Ops_t::Load(r)));
+   }
+
+   //! \brief Adds each section of r to the same section of l, sections that overflow are set to their maximum
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> AddSectionsSaturated(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      const auto left = Ops_t::Load(l);
+      const auto right = Ops_t::Load(r);
+      const auto sum = Ops_t::Add(left, right);
+      return Ops_t::Store(sum | Ops_t::Expand(Ops_t::CarryFlags(left, right, sum)));
+   }
+
+   //! \brief Subtracts each section of r from the same section of l, sections that underflow are set to zero
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> SubSectionsSaturated(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      const auto left = Ops_t::Load(l);
+      const auto right = Ops_t::Load(r);
+      return Ops_t::Store(Ops_t::Sub(left, right) & ~Ops_t::Expand(Ops_t::LessFlags(left, right)));
+   }
+
+   //! \brief The smaller value of each section
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> MinSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      const auto left = Ops_t::Load(l);
+      const auto right = Ops_t::Load(r);
+      return Ops_t::Store(Ops_t::Select(Ops_t::Expand(Ops_t::LessFlags(left, right)), left, right));
+   }
+
+   //! \brief The larger value of each section
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> MaxSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      const auto left = Ops_t::Load(l);
+      const auto right = Ops_t::Load(r);
+      return Ops_t::Store(Ops_t::Select(Ops_t::Expand(Ops_t::LessFlags(left, right)), right, left));
+   }
+
+   //! \brief All bits of each section that is equal in l and r
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> EqualSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::Store(Ops_t::Expand(Ops_t::EqualFlags(Ops_t::Load(l), Ops_t::Load(r))));
+   }
+
+   //! \brief All bits of each section that is smaller in l than in r
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t> LessSections(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::Store(Ops_t::Expand(Ops_t::LessFlags(Ops_t::Load(l), Ops_t::Load(r))));
+   }
+
+   //! \brief Is any section of l smaller than the same section of r? !AnySectionLess(l, r) means that every
+   //!        section of l is greater than or equal to the same section of r
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t, bool> AnySectionLess(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::LessFlags(Ops_t::Load(l), Ops_t::Load(r)) != 0;
+   }
+
+   //! \brief Is every section of l equal to the same section of r?
+   template<typename Mask_t>
+   detail::swar::EnableIfBitmask_t<Mask_t, bool> AllSectionsEqual(const Mask_t& l, const Mask_t& r)
+   {
+      using Ops_t = detail::swar::Ops<Mask_t>;
+      return Ops_t::Load(l) == Ops_t::Load(r);
+   }
+
+}
@@ -0,0 +1,375 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "..\meta\Meta.h"
+#include "..\error_handling\Assert.h"
+#include "Bitmask.h"
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      //! \brief Reads up to 64 bits starting at an arbitrary bit offset. The value may straddle two words, so there
+      //!        has to be at least one word after the word that contains the first bit
+      inline uint64_t ReadBits(const uint64_t* words, size_t bitOffset, uint64_t mask)
+      {
+         const auto word = bitOffset / WordBits;
+         const auto shift = bitOffset % WordBits;
+         //Shifting in two steps keeps both shifts below 64 bits, so for shift == 0 the second word adds nothing
+         //and we need no branch
+         return ((words[word] >> shift) | ((words[word + 1] << 1) << (WordBits - 1 - shift))) & mask;
+      }
+
+      //! \brief Writes up to 64 bits starting at an arbitrary bit offset. Same requirements as ReadBits
+      inline void WriteBits(uint64_t* words, size_t bitOffset, uint64_t mask, uint64_t value)
+      {
+         const auto word = bitOffset / WordBits;
+         const auto shift = bitOffset % WordBits;
+         value &= mask;
+         words[word] = (words[word] & ~(mask << shift)) | (value << shift);
+         words[word + 1] = (words[word + 1] & ~((mask >> 1) >> (WordBits - 1 - shift))) |
+            ((value >> 1) >> (WordBits - 1 - shift));
+      }
+
+      //! \brief Common implementation of BitmaskArray and NamedBitmaskArray. Stores the records back to back at
+      //!        exactly Mask_t::RequiredSize bits each inside an array of uint64_t words
+      template<typename Mask_t>
+      class BitmaskArrayBase
+      {
+      public:
+         using Value_t = Mask_t;
+         using Numbers = typename Mask_t::Numbers;
+         constexpr static size_t Sections = Mask_t::Sections;
+         //! \brief Number of bits of a single record
+         constexpr static size_t RequiredSize = Mask_t::RequiredSize;
+
+         //! \brief Proxy reference to a single record inside the array
+         class Reference
+         {
+         public:
+            Reference(BitmaskArrayBase* array, size_t index) :
+               _array(array),
+               _index(index)
+            {
+            }
+
+            Reference(const Reference&) = default;
+
+            operator Mask_t() const
+            {
+               return _array->Load(_index);
+            }
+
+            Reference& operator=(const Mask_t& value)
+            {
+               _array->Store(_index, value);
+               return *this;
+            }
+
+            //! \brief Assigns the value of the referenced record, not the reference itself
+            Reference& operator=(const Reference& other)
+            {
+               return *this = static_cast<Mask_t>(other);
+            }
+
+            friend void swap(Reference left, Reference right)
+            {
+               const Mask_t tmp = left;
+               left = static_cast<Mask_t>(right);
+               right = tmp;
+            }
+
+         private:
+            BitmaskArrayBase* _array;
+            size_t _index;
+         };
+
+         //! \brief Random access iterator over the records. Dereferencing yields a Reference proxy for mutable
+         //!        iterators and a copy of the record for const iterators
+         template<bool Const>
+         class Iterator
+         {
+         public:
+            using Array_t = std::conditional_t<Const, const BitmaskArrayBase, BitmaskArrayBase>;
+
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Mask_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, Mask_t, Reference>;
+            using pointer = void;
+
+            Iterator() :
+               _array(nullptr),
+               _index(0)
+            {
+            }
+
+            Iterator(Array_t* array, size_t index) :
+               _array(array),
+               _index(index)
+            {
+            }
+
+            //! \brief Conversion from mutable to const iterator
+            template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            Iterator(const Iterator<OtherConst>& other) :
+               _array(other._array),
+               _index(other._index)
+            {
+            }
+
+            reference operator*() const { return (*_array)[_index]; }
+            reference operator[](difference_type offset) const { return (*_array)[_index + offset]; }
+
+            Iterator& operator++() { ++_index; return *this; }
+            Iterator operator++(int) { auto tmp = *this; ++_index; return tmp; }
+            Iterator& operator--() { --_index; return *this; }
+            Iterator operator--(int) { auto tmp = *this; --_index; return tmp; }
+
+            Iterator& operator+=(difference_type offset) { _index += offset; return *this; }
+            Iterator& operator-=(difference_type offset) { _index -= offset; return *this; }
+
+            friend Iterator operator+(Iterator it, difference_type offset) { return it += offset; }
+            friend Iterator operator+(difference_type offset, Iterator it) { return it += offset; }
+            friend Iterator operator-(Iterator it, difference_type offset) { return it -= offset; }
+
+            friend difference_type operator-(const Iterator& left, const Iterator& right)
+            {
+               return static_cast<difference_type>(left._index) - static_cast<difference_type>(right._index);
+            }
+
+            friend bool operator==(const Iterator& left, const Iterator& right) { return left._index == right._index; }
+            friend bool operator!=(const Iterator& left, const Iterator& right) { return left._index != right._index; }
+            friend bool operator<(const Iterator& left, const Iterator& right) { return left._index < right._index; }
+            friend bool operator>(const Iterator& left, const Iterator& right) { return left._index > right._index; }
+            friend bool operator<=(const Iterator& left, const Iterator& right) { return left._index <= right._index; }
+            friend bool operator>=(const Iterator& left, const Iterator& right) { return left._index >= right._index; }
+
+         private:
+            template<bool> friend class Iterator;
+
+            Array_t* _array;
+            size_t _index;
+         };
+
+         using iterator = Iterator<false>;
+         using const_iterator = Iterator<true>;
+
+         BitmaskArrayBase() :
+            _size(0)
+         {
+         }
+
+         //! \brief Creates an array of the given number of records with all bits set to zero
+         explicit BitmaskArrayBase(size_t count) :
+            _words(WordsFor(count), 0),
+            _size(count)
+         {
+         }
+
+         size_t Size() const { return _size; }
+
+         bool Empty() const { return _size == 0; }
+
+         //! \brief Resizes the array, new records have all bits set to zero
+         void Resize(size_t count)
+         {
+            if (count < _size)
+            {
+               //Clear the bits of the removed records in all words that are kept (the word shared with the
+               //remaining records and the padding word), so that growing again yields zeroed records
+               const auto usedBits = count * RequiredSize;
+               const auto firstWord = usedBits / WordBits;
+               _words[firstWord] &= (uint64_t(1) << (usedBits % WordBits)) - 1;
+               std::fill(_words.begin() + firstWord + 1, _words.end(), 0);
+            }
+            _words.resize(WordsFor(count), 0);
+            _size = count;
+         }
+
+         void Reserve(size_t count)
+         {
+            _words.reserve(WordsFor(count));
+         }
+
+         void Clear()
+         {
+            _words.clear();
+            _size = 0;
+         }
+
+         void PushBack(const Mask_t& value)
+         {
+            Resize(_size + 1);
+            Store(_size - 1, value);
+         }
+
+         Reference operator[](size_t index)
+         {
+            MDV_ASSERT(index < _size);
+            return Reference(this, index);
+         }
+
+         Mask_t operator[](size_t index) const
+         {
+            MDV_ASSERT(index < _size);
+            return Load(index);
+         }
+
+         iterator begin() { return iterator(this, 0); }
+         iterator end() { return iterator(this, _size); }
+         const_iterator begin() const { return const_iterator(this, 0); }
+         const_iterator end() const { return const_iterator(this, _size); }
+         const_iterator cbegin() const { return begin(); }
+         const_iterator cend() const { return end(); }
+
+         //! \brief The packed words. This includes one padding word at the end whenever the array is not empty
+         const uint64_t* Data() const { return _words.data(); }
+         uint64_t* Data() { return _words.data(); }
+
+         //! \brief Number of words returned by Data()
+         size_t WordCount() const { return _words.size(); }
+
+         //! \brief Number of words for the given number of records, including one padding word so that reading
+         //!        the last record can always access the word after it
+         constexpr static size_t WordsFor(size_t count)
+         {
+            return count == 0 ? 0 : (count * RequiredSize + WordBits - 1) / WordBits + 1;
+         }
+
+         //! \brief Loads the whole record at the given index into a bitmask
+         Mask_t Load(size_t index) const
+         {
+            Mask_t value;
+            LoadSections(index, value, std::make_index_sequence<Sections>());
+            return value;
+         }
+
+         //! \brief Stores the whole bitmask into the record at the given index
+         void Store(size_t index, const Mask_t& value)
+         {
+            StoreSections(index, value, std::make_index_sequence<Sections>());
+         }
+
+      protected:
+         template<size_t Index>
+         using Section_t = detail::Section<uint64_t, Numbers, Index>;
+
+         //! \brief Offset of the section with the given index inside a record
+         template<size_t Index>
+         using SectionOffset = meta::Sum<meta::Take_t<Index, Numbers>>;
+
+         template<size_t Index>
+         typename Section_t<Index>::Value_t GetAt(size_t element) const
+         {
+            MDV_ASSERT(element < _size);
+            return static_cast<typename Section_t<Index>::Value_t>(detail::ReadBits(
+               _words.data(), element * RequiredSize + SectionOffset<Index>::value, Section_t<Index>::Mask));
+         }
+
+         template<size_t Index>
+         void SetAt(size_t element, uint64_t value)
+         {
+            MDV_ASSERT(element < _size);
+            detail::WriteBits(
+               _words.data(), element * RequiredSize + SectionOffset<Index>::value, Section_t<Index>::Mask, value);
+         }
+
+      private:
+         template<size_t... Is>
+         void LoadSections(size_t index, Mask_t& value, std::index_sequence<Is...>) const
+         {
+            using swallow = int[];
+            (void)swallow {
+               0, ((void)IndexedSections<Mask_t>::template Set<Is>(value, GetAt<Is>(index)), 0)...
+            };
+         }
+
+         template<size_t... Is>
+         void StoreSections(size_t index, const Mask_t& value, std::index_sequence<Is...>)
+         {
+            using swallow = int[];
+            (void)swallow {
+               0, ((void)SetAt<Is>(index, IndexedSections<Mask_t>::template Get<Is>(value)), 0)...
+            };
+         }
+
+         std::vector<uint64_t> _words;
+         size_t _size;
+      };
+
+   }
+
+   //! \brief Densely packed array of Bitmask<Bits...> records. In contrast to std::vector<Bitmask<Bits...>>, each
+   //!        record takes exactly Bitmask<Bits...>::RequiredSize bits without any padding, so a 13 bit record
+   //!        takes 13 bits instead of 16. Records may straddle word boundaries
+   template<size_t... Bits>
+   class BitmaskArray : public detail::BitmaskArrayBase<Bitmask<Bits...>>
+   {
+      using Base_t = detail::BitmaskArrayBase<Bitmask<Bits...>>;
+   public:
+      using Base_t::Base_t;
+
+      //! \brief Get the value of the section at Index of the record at the given element index
+      template<size_t Index>
+      decltype(auto) Get(size_t element) const
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template GetAt<Index>(element);
+      }
+
+      //! \brief Set the value of the section at Index of the record at the given element index
+      template<
+         size_t Index,
+         typename ValueSize_t = detail::SizeToType_t<
+            meta::At_t<Index, typename Base_t::Numbers>::value
+         >
+      >
+      void Set(size_t element, ValueSize_t value)
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         this->template SetAt<Index>(element, value);
+      }
+   };
+
+   //! \brief Densely packed array of NamedBitmask<NamedBits...> records, see BitmaskArray
+   template<typename... NamedBits>
+   class NamedBitmaskArray : public detail::BitmaskArrayBase<NamedBitmask<NamedBits...>>
+   {
+      using Base_t = detail::BitmaskArrayBase<NamedBitmask<NamedBits...>>;
+   public:
+      using NamedSections = meta::Typelist<NamedBits...>;
+      using Base_t::Base_t;
+
+      //! \brief Get the value of the given section of the record at the given element index
+      template<typename Section>
+      decltype(auto) Get(size_t element) const
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template GetAt<meta::IndexOf<Section, NamedSections>::value>(element);
+      }
+
+      //! \brief Set the value of the given section of the record at the given element index
+      template<
+         typename Section,
+         typename ValueSize_t = detail::SizeToType_t<
+            meta::At_t<
+               meta::IndexOf<Section, meta::Typelist<NamedBits...>>::value, typename Base_t::Numbers
+            >::value
+         >
+      >
+      void Set(size_t element, ValueSize_t value)
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         this->template SetAt<meta::IndexOf<Section, NamedSections>::value>(element, value);
+      }
+   };
+
+}
@@ -0,0 +1,337 @@
+#pragma once
+#include <cstring>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+#include "..\meta\Meta.h"
+#include "..\util\Compiler.h"
+#include "..\util\CpuFeatures.h"
+#include "BitmaskArray.h"
+
+#ifdef MDV_X64
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      namespace columns
+      {
+
+         //! \brief Repeats the lowest 'stride' bits of pattern 'count' times
+         constexpr uint64_t Repeat(uint64_t pattern, size_t stride, size_t count)
+         {
+            return count == 0 ? 0 : (pattern << (stride * (count - 1))) | Repeat(pattern, stride, count - 1);
+         }
+
+         inline unsigned CountTrailingZeros(uint64_t value)
+         {
+#if defined(_MSC_VER) && defined(MDV_X64)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+            unsigned index = 0;
+            for (; (value & 1) == 0; value >>= 1)
+               ++index;
+            return index;
+#endif
+         }
+
+         //! \brief Number of set bits. The POPCNT instruction is not part of the baseline instruction set, so this
+         //!        counts the bits of all bytes in parallel
+         inline unsigned PopCount(uint64_t value)
+         {
+            value -= (value >> 1) & 0x5555555555555555ULL;
+            value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+            value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            return static_cast<unsigned>((value * 0x0101010101010101ULL) >> 56);
+         }
+
+         //! \brief Position of one section inside the packed records of a BitmaskArray. Records of up to 32 bits
+         //!        are processed in chunks of RecordsPerChunk records, which are read with a single (possibly
+         //!        straddling) 64 bit load. The masks describe the section in every record of a chunk
+         template<typename Numbers, size_t Index>
+         struct Layout
+         {
+            constexpr static size_t RecordBits = meta::Sum<Numbers>::value;
+            constexpr static size_t Offset = meta::Sum<meta::Take_t<Index, Numbers>>::value;
+            constexpr static size_t Bits = meta::At_t<Index, Numbers>::value;
+            constexpr static uint64_t SectionMask = Mask<Bits>::value;
+
+            constexpr static bool Chunked = RecordBits <= WordBits / 2;
+            constexpr static size_t RecordsPerChunk = Chunked ? WordBits / RecordBits : 1;
+            constexpr static size_t ChunkBits = RecordsPerChunk * RecordBits;
+
+            //! \brief All bits of the section in every record of a chunk
+            constexpr static uint64_t FieldMask = Chunked ? Repeat(SectionMask << Offset, RecordBits, RecordsPerChunk) : 0;
+            //! \brief Lowest bit of the section in every record, multiplying a value with this repeats the value
+            constexpr static uint64_t FieldOnes = Chunked ? Repeat(uint64_t(1) << Offset, RecordBits, RecordsPerChunk) : 0;
+            //! \brief Highest bit of the section in every record
+            constexpr static uint64_t FieldHighBits = FieldOnes << (Bits - 1);
+            constexpr static uint64_t FieldLowBits = FieldMask & ~FieldHighBits;
+         };
+
+         template<typename Layout_t>
+         uint64_t ReadChunk(const uint64_t* words, size_t record)
+         {
+            return ReadBits(words, record * Layout_t::RecordBits, ~uint64_t(0));
+         }
+
+         template<typename Layout_t>
+         uint64_t ReadSection(const uint64_t* words, size_t record)
+         {
+            return ReadBits(words, record * Layout_t::RecordBits + Layout_t::Offset, Layout_t::SectionMask);
+         }
+
+         //! \brief Sets the highest bit of every section in the chunk whose value is zero. With the low bits of a
+         //!        section added to all ones, the carry reaches the highest bit exactly if any low bit is set. The
+         //!        carry never leaves the section
+         template<typename Layout_t>
+         uint64_t ZeroFields(uint64_t chunk)
+         {
+            const auto nonZero = (((chunk & Layout_t::FieldLowBits) + Layout_t::FieldLowBits) | chunk) &
+               Layout_t::FieldHighBits;
+            return ~nonZero & Layout_t::FieldHighBits;
+         }
+
+         template<typename Layout_t, typename Out_t>
+         void GatherPortable(const uint64_t* words, size_t count, Out_t* out)
+         {
+            size_t record = 0;
+            if (Layout_t::Chunked)
+            {
+               for (; record + Layout_t::RecordsPerChunk <= count; record += Layout_t::RecordsPerChunk)
+               {
+                  const auto chunk = ReadChunk<Layout_t>(words, record);
+                  for (size_t i = 0; i < Layout_t::RecordsPerChunk; ++i)
+                  {
+                     out[record + i] = static_cast<Out_t>(
+                        (chunk >> (i * Layout_t::RecordBits + Layout_t::Offset)) & Layout_t::SectionMask);
+                  }
+               }
+            }
+            for (; record < count; ++record)
+            {
+               out[record] = static_cast<Out_t>(ReadSection<Layout_t>(words, record));
+            }
+         }
+
+         template<typename Layout_t>
+         void FilterPortable(const uint64_t* words, size_t count, uint64_t value, std::vector<size_t>& indices)
+         {
+            size_t record = 0;
+            if (Layout_t::Chunked)
+            {
+               const auto pattern = value * Layout_t::FieldOnes;
+               for (; record + Layout_t::RecordsPerChunk <= count; record += Layout_t::RecordsPerChunk)
+               {
+                  auto matches = ZeroFields<Layout_t>(ReadChunk<Layout_t>(words, record) ^ pattern);
+                  for (; matches; matches &= matches - 1)
+                  {
+                     indices.push_back(record + CountTrailingZeros(matches) / Layout_t::RecordBits);
+                  }
+               }
+            }
+            for (; record < count; ++record)
+            {
+               if (ReadSection<Layout_t>(words, record) == value)
+                  indices.push_back(record);
+            }
+         }
+
+#ifdef MDV_X64
+
+         //! \brief PEXT collects the section of all records in a chunk into consecutive bits, PDEP spreads them
+         //!        into the lanes of the output type, so that a whole chunk is written with a few stores. Requires
+         //!        every section value to fit into Out_t
+         template<typename Layout_t, typename Out_t>
+         MDV_TARGET_BMI2 void GatherBmi2(const uint64_t* words, size_t count, Out_t* out)
+         {
+            constexpr size_t LaneBits = sizeof(Out_t) * 8;
+            constexpr size_t LanesPerWord = WordBits / LaneBits;
+            constexpr uint64_t LaneMask = Repeat(Layout_t::SectionMask, LaneBits, LanesPerWord);
+
+            size_t record = 0;
+            for (; record + Layout_t::RecordsPerChunk <= count; record += Layout_t::RecordsPerChunk)
+            {
+               const auto packed = _pext_u64(ReadChunk<Layout_t>(words, record), Layout_t::FieldMask);
+               for (size_t lane = 0; lane < Layout_t::RecordsPerChunk; lane += LanesPerWord)
+               {
+                  const auto lanes = _pdep_u64(packed >> (lane * Layout_t::Bits), LaneMask);
+                  const auto lanesInChunk = Layout_t::RecordsPerChunk - lane;
+                  std::memcpy(out + record + lane, &lanes,
+                     (lanesInChunk < LanesPerWord ? lanesInChunk : LanesPerWord) * sizeof(Out_t));
+               }
+            }
+            for (; record < count; ++record)
+            {
+               out[record] = static_cast<Out_t>(ReadSection<Layout_t>(words, record));
+            }
+         }
+
+         //! \brief Same as FilterPortable, but PEXT compresses the matches into one bit per record, so the index
+         //!        of a match needs no division
+         template<typename Layout_t>
+         MDV_TARGET_BMI2 void FilterBmi2(const uint64_t* words, size_t count, uint64_t value,
+            std::vector<size_t>& indices)
+         {
+            const auto pattern = value * Layout_t::FieldOnes;
+            size_t record = 0;
+            for (; record + Layout_t::RecordsPerChunk <= count; record += Layout_t::RecordsPerChunk)
+            {
+               auto matches = _pext_u64(ZeroFields<Layout_t>(ReadChunk<Layout_t>(words, record) ^ pattern),
+                  Layout_t::FieldHighBits);
+               for (; matches; matches &= matches - 1)
+               {
+                  indices.push_back(record + CountTrailingZeros(matches));
+               }
+            }
+            for (; record < count; ++record)
+            {
+               if (ReadSection<Layout_t>(words, record) == value)
+                  indices.push_back(record);
+            }
+         }
+
+#endif
+
+         //! \brief The BMI2 kernels are used if the records are chunked and the CPU supports BMI2. Note that PEXT
+         //!        and PDEP are microcoded and slow on AMD CPUs before Zen 3
+         template<typename Layout_t, typename Out_t>
+         void Gather(const uint64_t* words, size_t count, Out_t* out)
+         {
+            using Kernel_t = void(*)(const uint64_t*, size_t, Out_t*);
+            static const Kernel_t kernel = []() -> Kernel_t {
+#ifdef MDV_X64
+               if (Layout_t::Chunked && std::is_integral<Out_t>::value && Layout_t::Bits <= sizeof(Out_t) * 8 &&
+                  GetCpuFeatures().bmi2)
+                  return &GatherBmi2<Layout_t, Out_t>;
+#endif
+               return &GatherPortable<Layout_t, Out_t>;
+            }();
+            kernel(words, count, out);
+         }
+
+         template<typename Layout_t>
+         void Filter(const uint64_t* words, size_t count, uint64_t value, std::vector<size_t>& indices)
+         {
+            //Values that don't fit into the section can't match, and would overflow into other sections when
+            //repeated over the chunk
+            if (value > Layout_t::SectionMask)
+               return;
+
+            using Kernel_t = void(*)(const uint64_t*, size_t, uint64_t, std::vector<size_t>&);
+            static const Kernel_t kernel = []() -> Kernel_t {
+#ifdef MDV_X64
+               if (Layout_t::Chunked && GetCpuFeatures().bmi2)
+                  return &FilterBmi2<Layout_t>;
+#endif
+               return &FilterPortable<Layout_t>;
+            }();
+            kernel(words, count, value, indices);
+         }
+
+         template<typename Layout_t>
+         size_t Count(const uint64_t* words, size_t count, uint64_t value)
+         {
+            if (value > Layout_t::SectionMask)
+               return 0;
+
+            size_t matches = 0;
+            size_t record = 0;
+            if (Layout_t::Chunked)
+            {
+               const auto pattern = value * Layout_t::FieldOnes;
+               for (; record + Layout_t::RecordsPerChunk <= count; record += Layout_t::RecordsPerChunk)
+               {
+                  //Most chunks contain no match when the filter is selective
+                  const auto zero = ZeroFields<Layout_t>(ReadChunk<Layout_t>(words, record) ^ pattern);
+                  if (zero)
+                     matches += PopCount(zero);
+               }
+            }
+            for (; record < count; ++record)
+            {
+               if (ReadSection<Layout_t>(words, record) == value)
+                  ++matches;
+            }
+            return matches;
+         }
+
+         template<typename Array_t, size_t Index>
+         using ArrayLayout = Layout<typename Array_t::Numbers, Index>;
+
+      }
+
+   }
+
+   //! \brief Reads the section at Index of all records in the array into the given column. Consecutive records are
+   //!        read in chunks of 64 bits, and with BMI2 each chunk is unpacked with PEXT and PDEP
+   //! \param out Array of array.Size() values that receives the section values
+   template<size_t Index, size_t... Bits, typename Out_t>
+   void GatherSection(const BitmaskArray<Bits...>& array, Out_t* out)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArray<Bits...>, Index>;
+      detail::columns::Gather<Layout_t>(array.Data(), array.Size(), out);
+   }
+
+   //! \brief Reads the given section of all records in the array into the given column, see GatherSection for
+   //!        BitmaskArray
+   template<typename Section, typename... NamedBits, typename Out_t>
+   void GatherSection(const NamedBitmaskArray<NamedBits...>& array, Out_t* out)
+   {
+      using Array_t = NamedBitmaskArray<NamedBits...>;
+      static_assert(meta::Contains<Section, typename Array_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<Array_t, meta::IndexOf<Section, typename Array_t::NamedSections>::value>;
+      detail::columns::Gather<Layout_t>(array.Data(), array.Size(), out);
+   }
+
+   //! \brief Appends the indices of all records whose section at Index equals the given value to 'indices', in
+   //!        ascending order. All records of a chunk are compared at once, without extracting the sections
+   template<size_t Index, size_t... Bits>
+   void FilterSection(const BitmaskArray<Bits...>& array, uint64_t value, std::vector<size_t>& indices)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArray<Bits...>, Index>;
+      detail::columns::Filter<Layout_t>(array.Data(), array.Size(), value, indices);
+   }
+
+   template<typename Section, typename... NamedBits>
+   void FilterSection(const NamedBitmaskArray<NamedBits...>& array, uint64_t value, std::vector<size_t>& indices)
+   {
+      using Array_t = NamedBitmaskArray<NamedBits...>;
+      static_assert(meta::Contains<Section, typename Array_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<Array_t, meta::IndexOf<Section, typename Array_t::NamedSections>::value>;
+      detail::columns::Filter<Layout_t>(array.Data(), array.Size(), value, indices);
+   }
+
+   //! \brief Number of records whose section at Index equals the given value
+   template<size_t Index, size_t... Bits>
+   size_t CountSection(const BitmaskArray<Bits...>& array, uint64_t value)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArray<Bits...>, Index>;
+      return detail::columns::Count<Layout_t>(array.Data(), array.Size(), value);
+   }
+
+   template<typename Section, typename... NamedBits>
+   size_t CountSection(const NamedBitmaskArray<NamedBits...>& array, uint64_t value)
+   {
+      using Array_t = NamedBitmaskArray<NamedBits...>;
+      static_assert(meta::Contains<Section, typename Array_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<Array_t, meta::IndexOf<Section, typename Array_t::NamedSections>::value>;
+      return detail::columns::Count<Layout_t>(array.Data(), array.Size(), value);
+   }
+
+}
@@ -0,0 +1,402 @@
+#pragma once
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "..\meta\Meta.h"
+#include "..\error_handling\Assert.h"
+#include "..\util\Compiler.h"
+#include "BitmaskArray.h"
+#include "BitmaskArrayColumns.h"
+
+namespace mdv
+{
+
+   //! \brief Thrown when a serialized BitmaskArray is damaged or was written for a different record layout
+   class BadBitmaskArrayFile : public std::runtime_error
+   {
+   public:
+      explicit BadBitmaskArrayFile(const std::string& reason) :
+         std::runtime_error("Invalid serialized BitmaskArray: " + reason)
+      {
+      }
+   };
+
+   namespace detail
+   {
+
+      namespace file
+      {
+
+         //! \brief On-disk format of a BitmaskArray. All fields are little endian, independent of the machine that
+         //!        wrote the file:
+         //!
+         //! Offset  Size  Field
+         //!      0     8  Magic "MDVBMARR"
+         //!      8     4  Format version
+         //!     12     4  Header size (64)
+         //!     16     8  Fingerprint of the section sizes
+         //!     24     4  Bits per record
+         //!     28     4  Number of sections
+         //!     32     8  Number of records
+         //!     40     8  Number of payload words, including the padding word of BitmaskArray
+         //!     48     8  Offset of the payload from the start of the file
+         //!     56     8  Reserved, zero
+         //!     64     -  Payload, the packed words of the array as little endian uint64_t
+         //!
+         //! The payload starts at a multiple of 64 bytes, so it is suitably aligned inside a memory mapping
+         constexpr char Magic[] = "MDVBMARR";
+         constexpr size_t MagicSize = 8;
+         constexpr uint32_t FormatVersion = 1;
+         constexpr size_t HeaderSize = 64;
+
+         //! \brief 64 bit FNV-1a over a single byte
+         constexpr uint64_t HashByte(uint64_t hash, uint64_t byte)
+         {
+            return (hash ^ (byte & 0xff)) * 0x100000001b3ULL;
+         }
+
+         constexpr uint64_t HashValue(uint64_t hash, uint64_t value, size_t bytes = 8)
+         {
+            return bytes == 0 ? hash : HashValue(HashByte(hash, value), value >> 8, bytes - 1);
+         }
+
+         template<typename Numbers>
+         struct Fingerprint;
+
+         template<>
+         struct Fingerprint<meta::Numberlist<>> : std::integral_constant<uint64_t, 0xcbf29ce484222325ULL> {};
+
+         //! \brief Hash of the number and the sizes of the sections. The names of the sections of a NamedBitmask
+         //!        are not part of it, only their sizes
+         template<size_t First, size_t... Rest>
+         struct Fingerprint<meta::Numberlist<First, Rest...>> :
+            std::integral_constant<uint64_t, HashValue(Fingerprint<meta::Numberlist<Rest...>>::value,
+               First + (uint64_t(sizeof...(Rest) + 1) << 32))>
+         {
+         };
+
+         inline void StoreLittleEndian(unsigned char* bytes, uint64_t value, size_t size)
+         {
+            for (size_t i = 0; i < size; ++i)
+            {
+               bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+         }
+
+         inline uint64_t LoadLittleEndian(const unsigned char* bytes, size_t size)
+         {
+            uint64_t value = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+               value |= uint64_t(bytes[i]) << (8 * i);
+            }
+            return value;
+         }
+
+         inline bool IsLittleEndianHost()
+         {
+            const uint16_t probe = 1;
+            unsigned char firstByte;
+            std::memcpy(&firstByte, &probe, 1);
+            return firstByte == 1;
+         }
+
+         struct Header
+         {
+            uint64_t fingerprint;
+            uint32_t recordBits;
+            uint32_t sections;
+            uint64_t records;
+            uint64_t words;
+            uint64_t payloadOffset;
+         };
+
+         inline void EncodeHeader(const Header& header, unsigned char* bytes)
+         {
+            std::memset(bytes, 0, HeaderSize);
+            std::memcpy(bytes, Magic, MagicSize);
+            StoreLittleEndian(bytes + 8, FormatVersion, 4);
+            StoreLittleEndian(bytes + 12, HeaderSize, 4);
+            StoreLittleEndian(bytes + 16, header.fingerprint, 8);
+            StoreLittleEndian(bytes + 24, header.recordBits, 4);
+            StoreLittleEndian(bytes + 28, header.sections, 4);
+            StoreLittleEndian(bytes + 32, header.records, 8);
+            StoreLittleEndian(bytes + 40, header.words, 8);
+            StoreLittleEndian(bytes + 48, header.payloadOffset, 8);
+         }
+
+         MDV_NORETURN MDV_NOINLINE inline void ThrowBadFile(const char* reason)
+         {
+            throw BadBitmaskArrayFile(reason);
+         }
+
+         //! \brief Checks the header against the expected layout and returns the validated header
+         template<typename Numbers>
+         Header DecodeHeader(const unsigned char* bytes, size_t size, size_t recordBits, size_t sections)
+         {
+            if (size < HeaderSize)
+               ThrowBadFile("too small for the header");
+            if (std::memcmp(bytes, Magic, MagicSize) != 0)
+               ThrowBadFile("wrong magic number");
+            if (LoadLittleEndian(bytes + 8, 4) != FormatVersion)
+               ThrowBadFile("unsupported format version");
+            if (LoadLittleEndian(bytes + 12, 4) != HeaderSize)
+               ThrowBadFile("unexpected header size");
+
+            Header header;
+            header.fingerprint = LoadLittleEndian(bytes + 16, 8);
+            header.recordBits = static_cast<uint32_t>(LoadLittleEndian(bytes + 24, 4));
+            header.sections = static_cast<uint32_t>(LoadLittleEndian(bytes + 28, 4));
+            header.records = LoadLittleEndian(bytes + 32, 8);
+            header.words = LoadLittleEndian(bytes + 40, 8);
+            header.payloadOffset = LoadLittleEndian(bytes + 48, 8);
+
+            if (header.fingerprint != Fingerprint<Numbers>::value || header.recordBits != recordBits ||
+               header.sections != sections)
+               ThrowBadFile("the section layout does not match");
+
+            if (header.records > UINT64_MAX / recordBits)
+               ThrowBadFile("too many records");
+            const auto expectedWords = header.records == 0 ? 0 :
+               (header.records * recordBits + WordBits - 1) / WordBits + 1;
+            if (header.words != expectedWords)
+               ThrowBadFile("the payload size does not match the number of records");
+            if (header.payloadOffset < HeaderSize || header.payloadOffset % sizeof(uint64_t) != 0)
+               ThrowBadFile("invalid payload offset");
+            if (header.payloadOffset > size || (size - header.payloadOffset) / sizeof(uint64_t) < header.words)
+               ThrowBadFile("truncated payload");
+            return header;
+         }
+
+      }
+
+      //! \brief Common implementation of BitmaskArrayView and NamedBitmaskArrayView
+      template<typename Mask_t>
+      class BitmaskArrayViewBase
+      {
+      public:
+         using Value_t = Mask_t;
+         using Numbers = typename Mask_t::Numbers;
+         constexpr static size_t Sections = Mask_t::Sections;
+         constexpr static size_t RequiredSize = Mask_t::RequiredSize;
+
+         //! \brief Empty view
+         BitmaskArrayViewBase() :
+            _words(nullptr),
+            _size(0),
+            _wordCount(0)
+         {
+         }
+
+         //! \brief Validates the serialized array at the given memory and refers to its payload without copying it.
+         //!        The memory has to stay valid as long as the view is used
+         //! \param data Start of a serialized BitmaskArray, e.g. a memory mapped file. The payload must be aligned to
+         //!             8 bytes, which is always the case if data is aligned to 8 bytes
+         //! \param size Number of bytes at data
+         //! \throws BadBitmaskArrayFile if the data is damaged or was written for a different record layout
+         BitmaskArrayViewBase(const void* data, size_t size)
+         {
+            if (!file::IsLittleEndianHost())
+               file::ThrowBadFile("views of the payload require a little endian machine");
+
+            const auto bytes = static_cast<const unsigned char*>(data);
+            const auto header = file::DecodeHeader<Numbers>(bytes, size, RequiredSize, Sections);
+            const auto payload = bytes + header.payloadOffset;
+            if (reinterpret_cast<uintptr_t>(payload) % alignof(uint64_t) != 0)
+               file::ThrowBadFile("the payload is not aligned to 8 bytes");
+
+            _words = reinterpret_cast<const uint64_t*>(payload);
+            _size = static_cast<size_t>(header.records);
+            _wordCount = static_cast<size_t>(header.words);
+         }
+
+         size_t Size() const { return _size; }
+
+         bool Empty() const { return _size == 0; }
+
+         //! \brief The packed words, exactly like BitmaskArray::Data
+         const uint64_t* Data() const { return _words; }
+
+         size_t WordCount() const { return _wordCount; }
+
+         //! \brief Loads the whole record at the given index into a bitmask
+         Mask_t Load(size_t index) const
+         {
+            Mask_t value;
+            LoadSections(index, value, std::make_index_sequence<Sections>());
+            return value;
+         }
+
+         Mask_t operator[](size_t index) const
+         {
+            return Load(index);
+         }
+
+      protected:
+         template<size_t Index>
+         using Section_t = detail::Section<uint64_t, Numbers, Index>;
+
+         template<size_t Index>
+         using SectionOffset = meta::Sum<meta::Take_t<Index, Numbers>>;
+
+         template<size_t Index>
+         typename Section_t<Index>::Value_t GetAt(size_t element) const
+         {
+            MDV_ASSERT(element < _size);
+            return static_cast<typename Section_t<Index>::Value_t>(detail::ReadBits(
+               _words, element * RequiredSize + SectionOffset<Index>::value, Section_t<Index>::Mask));
+         }
+
+      private:
+         template<size_t... Is>
+         void LoadSections(size_t index, Mask_t& value, std::index_sequence<Is...>) const
+         {
+            using swallow = int[];
+            (void)swallow {
+               0, ((void)IndexedSections<Mask_t>::template Set<Is>(value, GetAt<Is>(index)), 0)...
+            };
+         }
+
+         const uint64_t* _words;
+         size_t _size;
+         size_t _wordCount;
+      };
+
+   }
+
+   //! \brief Writes the given BitmaskArray or NamedBitmaskArray in the on-disk format, see detail::file. The result
+   //!        can be read without deserializing it with BitmaskArrayView or NamedBitmaskArrayView
+   template<typename Array_t>
+   void WriteBitmaskArray(const Array_t& array, std::ostream& out)
+   {
+      detail::file::Header header;
+      header.fingerprint = detail::file::Fingerprint<typename Array_t::Numbers>::value;
+      header.recordBits = static_cast<uint32_t>(Array_t::RequiredSize);
+      header.sections = static_cast<uint32_t>(Array_t::Sections);
+      header.records = array.Size();
+      header.words = array.WordCount();
+      header.payloadOffset = detail::file::HeaderSize;
+
+      unsigned char bytes[detail::file::HeaderSize];
+      detail::file::EncodeHeader(header, bytes);
+      out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+
+      if (detail::file::IsLittleEndianHost())
+      {
+         out.write(reinterpret_cast<const char*>(array.Data()), array.WordCount() * sizeof(uint64_t));
+         return;
+      }
+      for (size_t i = 0; i < array.WordCount(); ++i)
+      {
+         unsigned char word[sizeof(uint64_t)];
+         detail::file::StoreLittleEndian(word, array.Data()[i], sizeof(word));
+         out.write(reinterpret_cast<const char*>(word), sizeof(word));
+      }
+   }
+
+   //! \brief Number of bytes that WriteBitmaskArray writes for the given array
+   template<typename Array_t>
+   size_t SerializedSize(const Array_t& array)
+   {
+      return detail::file::HeaderSize + array.WordCount() * sizeof(uint64_t);
+   }
+
+   //! \brief Read-only BitmaskArray over serialized records, typically a memory mapped file. Get, Load and the
+   //!        column scans work directly on the serialized words, so opening the view costs only the header check
+   //!
+   //! Example:
+   //! MappedFile file("records.bin");
+   //! BitmaskArrayView<5, 8> view(file.Data(), file.Size());
+   template<size_t... Bits>
+   class BitmaskArrayView : public detail::BitmaskArrayViewBase<Bitmask<Bits...>>
+   {
+      using Base_t = detail::BitmaskArrayViewBase<Bitmask<Bits...>>;
+   public:
+      using Base_t::Base_t;
+
+      //! \brief Get the value of the section at Index of the record at the given element index
+      template<size_t Index>
+      decltype(auto) Get(size_t element) const
+      {
+         static_assert(Index < Base_t::Sections, "Index out of bounds!");
+         return this->template GetAt<Index>(element);
+      }
+   };
+
+   //! \brief Read-only NamedBitmaskArray over serialized records, see BitmaskArrayView
+   template<typename... NamedBits>
+   class NamedBitmaskArrayView : public detail::BitmaskArrayViewBase<NamedBitmask<NamedBits...>>
+   {
+      using Base_t = detail::BitmaskArrayViewBase<NamedBitmask<NamedBits...>>;
+   public:
+      using NamedSections = meta::Typelist<NamedBits...>;
+      using Base_t::Base_t;
+
+      //! \brief Get the value of the given section of the record at the given element index
+      template<typename Section>
+      decltype(auto) Get(size_t element) const
+      {
+         static_assert(meta::Contains<Section, NamedSections>::value, "Section not found in this Bitmask!");
+         return this->template GetAt<meta::IndexOf<Section, NamedSections>::value>(element);
+      }
+   };
+
+   //! \brief GatherSection for a view, see GatherSection for BitmaskArray
+   template<size_t Index, size_t... Bits, typename Out_t>
+   void GatherSection(const BitmaskArrayView<Bits...>& view, Out_t* out)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArrayView<Bits...>, Index>;
+      detail::columns::Gather<Layout_t>(view.Data(), view.Size(), out);
+   }
+
+   template<typename Section, typename... NamedBits, typename Out_t>
+   void GatherSection(const NamedBitmaskArrayView<NamedBits...>& view, Out_t* out)
+   {
+      using View_t = NamedBitmaskArrayView<NamedBits...>;
+      static_assert(meta::Contains<Section, typename View_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<View_t, meta::IndexOf<Section, typename View_t::NamedSections>::value>;
+      detail::columns::Gather<Layout_t>(view.Data(), view.Size(), out);
+   }
+
+   //! \brief FilterSection for a view, see FilterSection for BitmaskArray
+   template<size_t Index, size_t... Bits>
+   void FilterSection(const BitmaskArrayView<Bits...>& view, uint64_t value, std::vector<size_t>& indices)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArrayView<Bits...>, Index>;
+      detail::columns::Filter<Layout_t>(view.Data(), view.Size(), value, indices);
+   }
+
+   template<typename Section, typename... NamedBits>
+   void FilterSection(const NamedBitmaskArrayView<NamedBits...>& view, uint64_t value, std::vector<size_t>& indices)
+   {
+      using View_t = NamedBitmaskArrayView<NamedBits...>;
+      static_assert(meta::Contains<Section, typename View_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<View_t, meta::IndexOf<Section, typename View_t::NamedSections>::value>;
+      detail::columns::Filter<Layout_t>(view.Data(), view.Size(), value, indices);
+   }
+
+   //! \brief CountSection for a view, see CountSection for BitmaskArray
+   template<size_t Index, size_t... Bits>
+   size_t CountSection(const BitmaskArrayView<Bits...>& view, uint64_t value)
+   {
+      static_assert(Index < sizeof...(Bits), "Index out of bounds!");
+      using Layout_t = detail::columns::ArrayLayout<BitmaskArrayView<Bits...>, Index>;
+      return detail::columns::Count<Layout_t>(view.Data(), view.Size(), value);
+   }
+
+   template<typename Section, typename... NamedBits>
+   size_t CountSection(const NamedBitmaskArrayView<NamedBits...>& view, uint64_t value)
+   {
+      using View_t = NamedBitmaskArrayView<NamedBits...>;
+      static_assert(meta::Contains<Section, typename View_t::NamedSections>::value, "Section not found in this Bitmask!");
+      using Layout_t = detail::columns::ArrayLayout<View_t, meta::IndexOf<Section, typename View_t::NamedSections>::value>;
+      return detail::columns::Count<Layout_t>(view.Data(), view.Size(), value);
+   }
+
+}
@@ -0,0 +1,503 @@
+#pragma once
+#include <stdint.h>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "..\meta\Meta.h"
+#include "..\util\Compiler.h"
+#include "..\util\CpuFeatures.h"
+#include "Bitmask.h"
+
+#ifdef MDV_X86
+#include <immintrin.h>
+#endif
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      namespace bulk
+      {
+
+         //! \brief Unsigned integer with the same size as T
+         template<typename T>
+         using Unsigned_t = SizeToType_t<sizeof(T) * 8>;
+
+         //! \brief Unsigned integer with twice the size of T
+         template<typename T>
+         using Wider_t = SizeToType_t<sizeof(T) * 16>;
+
+         //! \brief The SIMD kernels work on single-word bitmasks and integral values that are not wider than the
+         //!        word (the values are narrowed or widened in registers). Everything else uses the scalar loops
+         template<typename Mask_t, typename Value_t>
+         using SupportsKernels = std::integral_constant<bool,
+            BitmaskStorage<Mask_t::RequiredSize>::WordCount == 1 &&
+            std::is_integral<Value_t>::value &&
+            sizeof(Value_t) <= sizeof(typename BitmaskStorage<Mask_t::RequiredSize>::Word_t)>;
+
+         //! \brief The extraction kernels store the section bits as they are, which is only a valid object
+         //!        representation of a bool if the section is 0 or 1. bool is therefore always extracted by the
+         //!        scalar loop, which converts the value
+         template<typename Mask_t, typename Out_t>
+         using SupportsExtractKernels = std::integral_constant<bool,
+            SupportsKernels<Mask_t, Out_t>::value && !std::is_same<Out_t, bool>::value>;
+
+         template<typename Word_t, typename Section_t, typename Out_t>
+         void ExtractScalar(const Word_t* in, size_t count, Out_t* out)
+         {
+            for (size_t i = 0; i < count; ++i)
+            {
+               out[i] = static_cast<Out_t>((in[i] >> Section_t::Shift) & Section_t::Mask);
+            }
+         }
+
+         //! \brief Signed columns are converted through their unsigned type, so they are zero extended like in the
+         //!        SIMD kernels and the bits above a narrow column don't depend on its sign
+         template<typename Mask_t, typename Word_t, size_t... Is, typename... Columns>
+         void PackScalar(Word_t* out, size_t count, std::index_sequence<Is...>, const Columns*... columns)
+         {
+            for (size_t i = 0; i < count; ++i)
+            {
+               Word_t word = 0;
+               using swallow = int[];
+               (void)swallow {
+                  0, ((void)(word |= static_cast<Word_t>(
+                     (static_cast<uint64_t>(static_cast<Unsigned_t<Columns>>(columns[i])) &
+                        Section<Word_t, typename Mask_t::Numbers, Is>::Mask) <<
+                        Section<Word_t, typename Mask_t::Numbers, Is>::Shift)), 0)...
+               };
+               out[i] = word;
+            }
+         }
+
+#ifdef MDV_X86
+
+         //! \brief SSE2 lane operations. There are no shifts for 8 bit lanes, we use the 16 bit shifts instead. The
+         //!        bits that are shifted over from the neighbouring byte are always removed by the section mask,
+         //!        because a section never crosses the boundary of its word
+         struct Sse2
+         {
+            using Vector = __m128i;
+            constexpr static size_t VectorSize = 16;
+
+            MDV_TARGET_SSE2 static Vector LoadU(const void* mem) { return _mm_loadu_si128(static_cast<const __m128i*>(mem)); }
+            MDV_TARGET_SSE2 static void StoreU(void* mem, Vector v) { _mm_storeu_si128(static_cast<__m128i*>(mem), v); }
+            MDV_TARGET_SSE2 static Vector Zero() { return _mm_setzero_si128(); }
+            MDV_TARGET_SSE2 static Vector And(Vector l, Vector r) { return _mm_and_si128(l, r); }
+            MDV_TARGET_SSE2 static Vector Or(Vector l, Vector r) { return _mm_or_si128(l, r); }
+
+            MDV_TARGET_SSE2 static Vector Broadcast(uint8_t value) { return _mm_set1_epi8(static_cast<char>(value)); }
+            MDV_TARGET_SSE2 static Vector Broadcast(uint16_t value) { return _mm_set1_epi16(static_cast<short>(value)); }
+            MDV_TARGET_SSE2 static Vector Broadcast(uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+            MDV_TARGET_SSE2 static Vector Broadcast(uint64_t value) { return _mm_set1_epi64x(static_cast<long long>(value)); }
+
+            template<int Shift> MDV_TARGET_SSE2 static Vector Srli(Vector v, uint8_t) { return _mm_srli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Srli(Vector v, uint16_t) { return _mm_srli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Srli(Vector v, uint32_t) { return _mm_srli_epi32(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Srli(Vector v, uint64_t) { return _mm_srli_epi64(v, Shift); }
+
+            template<int Shift> MDV_TARGET_SSE2 static Vector Slli(Vector v, uint8_t) { return _mm_slli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Slli(Vector v, uint16_t) { return _mm_slli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Slli(Vector v, uint32_t) { return _mm_slli_epi32(v, Shift); }
+            template<int Shift> MDV_TARGET_SSE2 static Vector Slli(Vector v, uint64_t) { return _mm_slli_epi64(v, Shift); }
+
+            //Narrows the lanes of two vectors to half their size, truncating the values. The tag is the type of
+            //the narrowed lanes
+
+            MDV_TARGET_SSE2 static Vector Narrow(Vector l, Vector r, uint8_t)
+            {
+               const auto low = _mm_set1_epi16(0xff);
+               return _mm_packus_epi16(_mm_and_si128(l, low), _mm_and_si128(r, low));
+            }
+
+            MDV_TARGET_SSE2 static Vector Narrow(Vector l, Vector r, uint16_t)
+            {
+               //SSE2 has no unsigned saturation for 32 bit lanes, so we sign extend the lower 16 bits, which then
+               //survive the signed saturation unchanged
+               return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(l, 16), 16), _mm_srai_epi32(_mm_slli_epi32(r, 16), 16));
+            }
+
+            MDV_TARGET_SSE2 static Vector Narrow(Vector l, Vector r, uint32_t)
+            {
+               return _mm_unpacklo_epi64(_mm_shuffle_epi32(l, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(r, _MM_SHUFFLE(2, 0, 2, 0)));
+            }
+
+            //Zero extends the lower half of the lanes to twice their size. The tag is the type of the source lanes
+
+            MDV_TARGET_SSE2 static Vector WidenLow(Vector v, uint8_t) { return _mm_unpacklo_epi8(v, _mm_setzero_si128()); }
+            MDV_TARGET_SSE2 static Vector WidenLow(Vector v, uint16_t) { return _mm_unpacklo_epi16(v, _mm_setzero_si128()); }
+            MDV_TARGET_SSE2 static Vector WidenLow(Vector v, uint32_t) { return _mm_unpacklo_epi32(v, _mm_setzero_si128()); }
+
+            //! \brief Loads the given number of bytes into the lower part of a vector
+            MDV_TARGET_SSE2 static Vector LoadPartial(const void* mem, std::integral_constant<size_t, 16>) { return LoadU(mem); }
+            MDV_TARGET_SSE2 static Vector LoadPartial(const void* mem, std::integral_constant<size_t, 8>)
+            {
+               return _mm_loadl_epi64(static_cast<const __m128i*>(mem));
+            }
+            MDV_TARGET_SSE2 static Vector LoadPartial(const void* mem, std::integral_constant<size_t, 4>)
+            {
+               int value;
+               std::memcpy(&value, mem, sizeof(value));
+               return _mm_cvtsi32_si128(value);
+            }
+            MDV_TARGET_SSE2 static Vector LoadPartial(const void* mem, std::integral_constant<size_t, 2>)
+            {
+               uint16_t value;
+               std::memcpy(&value, mem, sizeof(value));
+               return _mm_cvtsi32_si128(value);
+            }
+
+            //! \brief Zero extends the lanes of type Current_t until they have the type Word_t
+            template<typename Word_t, typename Current_t>
+            MDV_TARGET_SSE2 static Vector WidenTo(Vector v, std::true_type)
+            {
+               return v;
+            }
+
+            template<typename Word_t, typename Current_t>
+            MDV_TARGET_SSE2 static Vector WidenTo(Vector v, std::false_type)
+            {
+               using Next_t = Wider_t<Current_t>;
+               return WidenTo<Word_t, Next_t>(WidenLow(v, Current_t()),
+                  std::integral_constant<bool, sizeof(Next_t) == sizeof(Word_t)>());
+            }
+
+            //! \brief Loads one vector worth of Word_t lanes from values of type In_t
+            template<typename Word_t, typename In_t>
+            MDV_TARGET_SSE2 static Vector LoadWidened(const In_t* in)
+            {
+               using Bytes = std::integral_constant<size_t, VectorSize / sizeof(Word_t) * sizeof(In_t)>;
+               return WidenTo<Word_t, Unsigned_t<In_t>>(LoadPartial(in, Bytes()),
+                  std::integral_constant<bool, sizeof(In_t) == sizeof(Word_t)>());
+            }
+
+            //! \brief Extracts one vector worth of Value_t lanes. For narrower values, several vectors of words are
+            //!        extracted and narrowed
+            template<typename Section_t, typename Word_t, typename Value_t>
+            MDV_TARGET_SSE2 static Vector Extract(const Word_t* in, std::true_type)
+            {
+               return And(Srli<Section_t::Shift>(LoadU(in), Word_t()), Broadcast(static_cast<Word_t>(Section_t::Mask)));
+            }
+
+            template<typename Section_t, typename Word_t, typename Value_t>
+            MDV_TARGET_SSE2 static Vector Extract(const Word_t* in, std::false_type)
+            {
+               using Next_t = Wider_t<Value_t>;
+               using IsWord = std::integral_constant<bool, sizeof(Next_t) == sizeof(Word_t)>;
+               constexpr size_t NextLanes = VectorSize / sizeof(Next_t);
+               return Narrow(Extract<Section_t, Word_t, Next_t>(in, IsWord()),
+                  Extract<Section_t, Word_t, Next_t>(in + NextLanes, IsWord()), Value_t());
+            }
+         };
+
+         //! \brief AVX2 lane operations, see Sse2. The pack instructions work within each 128 bit half, so the
+         //!        narrowed results have to be permuted back into order
+         struct Avx2
+         {
+            using Vector = __m256i;
+            constexpr static size_t VectorSize = 32;
+
+            MDV_TARGET_AVX2 static Vector LoadU(const void* mem) { return _mm256_loadu_si256(static_cast<const __m256i*>(mem)); }
+            MDV_TARGET_AVX2 static void StoreU(void* mem, Vector v) { _mm256_storeu_si256(static_cast<__m256i*>(mem), v); }
+            MDV_TARGET_AVX2 static Vector Zero() { return _mm256_setzero_si256(); }
+            MDV_TARGET_AVX2 static Vector And(Vector l, Vector r) { return _mm256_and_si256(l, r); }
+            MDV_TARGET_AVX2 static Vector Or(Vector l, Vector r) { return _mm256_or_si256(l, r); }
+
+            MDV_TARGET_AVX2 static Vector Broadcast(uint8_t value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+            MDV_TARGET_AVX2 static Vector Broadcast(uint16_t value) { return _mm256_set1_epi16(static_cast<short>(value)); }
+            MDV_TARGET_AVX2 static Vector Broadcast(uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+            MDV_TARGET_AVX2 static Vector Broadcast(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+
+            template<int Shift> MDV_TARGET_AVX2 static Vector Srli(Vector v, uint8_t) { return _mm256_srli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Srli(Vector v, uint16_t) { return _mm256_srli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Srli(Vector v, uint32_t) { return _mm256_srli_epi32(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Srli(Vector v, uint64_t) { return _mm256_srli_epi64(v, Shift); }
+
+            template<int Shift> MDV_TARGET_AVX2 static Vector Slli(Vector v, uint8_t) { return _mm256_slli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Slli(Vector v, uint16_t) { return _mm256_slli_epi16(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Slli(Vector v, uint32_t) { return _mm256_slli_epi32(v, Shift); }
+            template<int Shift> MDV_TARGET_AVX2 static Vector Slli(Vector v, uint64_t) { return _mm256_slli_epi64(v, Shift); }
+
+            MDV_TARGET_AVX2 static Vector Narrow(Vector l, Vector r, uint8_t)
+            {
+               const auto low = _mm256_set1_epi16(0xff);
+               const auto packed = _mm256_packus_epi16(_mm256_and_si256(l, low), _mm256_and_si256(r, low));
+               return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+            }
+
+            MDV_TARGET_AVX2 static Vector Narrow(Vector l, Vector r, uint16_t)
+            {
+               const auto low = _mm256_set1_epi32(0xffff);
+               const auto packed = _mm256_packus_epi32(_mm256_and_si256(l, low), _mm256_and_si256(r, low));
+               return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+            }
+
+            MDV_TARGET_AVX2 static Vector Narrow(Vector l, Vector r, uint32_t)
+            {
+               const auto even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+               return _mm256_permute2x128_si256(
+                  _mm256_permutevar8x32_epi32(l, even), _mm256_permutevar8x32_epi32(r, even), 0x20);
+            }
+
+            //Zero extending loads for each combination of source and destination lane size
+
+            MDV_TARGET_AVX2 static Vector Widen(const uint8_t* in, uint16_t) { return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))); }
+            MDV_TARGET_AVX2 static Vector Widen(const uint8_t* in, uint32_t) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in))); }
+            MDV_TARGET_AVX2 static Vector Widen(const uint8_t* in, uint64_t)
+            {
+               int value;
+               std::memcpy(&value, in, sizeof(value));
+               return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(value));
+            }
+            MDV_TARGET_AVX2 static Vector Widen(const uint16_t* in, uint32_t) { return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))); }
+            MDV_TARGET_AVX2 static Vector Widen(const uint16_t* in, uint64_t) { return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in))); }
+            MDV_TARGET_AVX2 static Vector Widen(const uint32_t* in, uint64_t) { return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))); }
+
+            template<typename Word_t, typename In_t>
+            MDV_TARGET_AVX2 static Vector LoadWidened(const In_t* in, std::true_type)
+            {
+               return LoadU(in);
+            }
+
+            template<typename Word_t, typename In_t>
+            MDV_TARGET_AVX2 static Vector LoadWidened(const In_t* in, std::false_type)
+            {
+               return Widen(reinterpret_cast<const Unsigned_t<In_t>*>(in), Word_t());
+            }
+
+            template<typename Word_t, typename In_t>
+            MDV_TARGET_AVX2 static Vector LoadWidened(const In_t* in)
+            {
+               return LoadWidened<Word_t>(in, std::integral_constant<bool, sizeof(In_t) == sizeof(Word_t)>());
+            }
+
+            template<typename Section_t, typename Word_t, typename Value_t>
+            MDV_TARGET_AVX2 static Vector Extract(const Word_t* in, std::true_type)
+            {
+               return And(Srli<Section_t::Shift>(LoadU(in), Word_t()), Broadcast(static_cast<Word_t>(Section_t::Mask)));
+            }
+
+            template<typename Section_t, typename Word_t, typename Value_t>
+            MDV_TARGET_AVX2 static Vector Extract(const Word_t* in, std::false_type)
+            {
+               using Next_t = Wider_t<Value_t>;
+               using IsWord = std::integral_constant<bool, sizeof(Next_t) == sizeof(Word_t)>;
+               constexpr size_t NextLanes = VectorSize / sizeof(Next_t);
+               return Narrow(Extract<Section_t, Word_t, Next_t>(in, IsWord()),
+                  Extract<Section_t, Word_t, Next_t>(in + NextLanes, IsWord()), Value_t());
+            }
+         };
+
+         //The loops can't be shared between the instruction sets, because every function that uses the intrinsics
+         //of an instruction set has to be compiled for that instruction set
+
+         template<typename Section_t, typename Word_t, typename Out_t>
+         MDV_TARGET_SSE2 void ExtractSse2(const Word_t* in, size_t count, Out_t* out)
+         {
+            using Value_t = Unsigned_t<Out_t>;
+            using IsWord = std::integral_constant<bool, sizeof(Value_t) == sizeof(Word_t)>;
+            constexpr size_t PerVector = Sse2::VectorSize / sizeof(Value_t);
+
+            size_t i = 0;
+            for (; i + PerVector <= count; i += PerVector)
+            {
+               Sse2::StoreU(out + i, Sse2::Extract<Section_t, Word_t, Value_t>(in + i, IsWord()));
+            }
+            ExtractScalar<Word_t, Section_t>(in + i, count - i, out + i);
+         }
+
+         template<typename Section_t, typename Word_t, typename Out_t>
+         MDV_TARGET_AVX2 void ExtractAvx2(const Word_t* in, size_t count, Out_t* out)
+         {
+            using Value_t = Unsigned_t<Out_t>;
+            using IsWord = std::integral_constant<bool, sizeof(Value_t) == sizeof(Word_t)>;
+            constexpr size_t PerVector = Avx2::VectorSize / sizeof(Value_t);
+
+            size_t i = 0;
+            for (; i + PerVector <= count; i += PerVector)
+            {
+               Avx2::StoreU(out + i, Avx2::Extract<Section_t, Word_t, Value_t>(in + i, IsWord()));
+            }
+            ExtractScalar<Word_t, Section_t>(in + i, count - i, out + i);
+         }
+
+         //! \brief Packs all sections of one vector worth of words in a single pass over the output
+         template<typename Mask_t, typename Word_t, size_t... Is, typename... Columns>
+         MDV_TARGET_SSE2 void PackSse2(Word_t* out, size_t count, std::index_sequence<Is...> indices, const Columns*... columns)
+         {
+            constexpr size_t PerVector = Sse2::VectorSize / sizeof(Word_t);
+
+            size_t i = 0;
+            for (; i + PerVector <= count; i += PerVector)
+            {
+               auto result = Sse2::Zero();
+               using swallow = int[];
+               (void)swallow {
+                  0, ((void)(result = Sse2::Or(result, Sse2::Slli<Section<Word_t, typename Mask_t::Numbers, Is>::Shift>(
+                     Sse2::And(Sse2::LoadWidened<Word_t>(columns + i),
+                        Sse2::Broadcast(static_cast<Word_t>(Section<Word_t, typename Mask_t::Numbers, Is>::Mask))),
+                     Word_t()))), 0)...
+               };
+               Sse2::StoreU(out + i, result);
+            }
+            PackScalar<Mask_t>(out + i, count - i, indices, (columns + i)...);
+         }
+
+         template<typename Mask_t, typename Word_t, size_t... Is, typename... Columns>
+         MDV_TARGET_AVX2 void PackAvx2(Word_t* out, size_t count, std::index_sequence<Is...> indices, const Columns*... columns)
+         {
+            constexpr size_t PerVector = Avx2::VectorSize / sizeof(Word_t);
+
+            size_t i = 0;
+            for (; i + PerVector <= count; i += PerVector)
+            {
+               auto result = Avx2::Zero();
+               using swallow = int[];
+               (void)swallow {
+                  0, ((void)(result = Avx2::Or(result, Avx2::Slli<Section<Word_t, typename Mask_t::Numbers, Is>::Shift>(
+                     Avx2::And(Avx2::LoadWidened<Word_t>(columns + i),
+                        Avx2::Broadcast(static_cast<Word_t>(Section<Word_t, typename Mask_t::Numbers, Is>::Mask))),
+                     Word_t()))), 0)...
+               };
+               Avx2::StoreU(out + i, result);
+            }
+            PackScalar<Mask_t>(out + i, count - i, indices, (columns + i)...);
+         }
+
+#endif
+
+         //! \brief Selects the best extraction kernel for the CPU this program runs on. This happens once per
+         //!        instantiation
+         template<typename Section_t, typename Word_t, typename Out_t>
+         void Extract(const Word_t* in, size_t count, Out_t* out)
+         {
+            using Kernel_t = void(*)(const Word_t*, size_t, Out_t*);
+            static const Kernel_t kernel = []() -> Kernel_t {
+#ifdef MDV_X86
+               if (GetCpuFeatures().avx2)
+                  return &ExtractAvx2<Section_t, Word_t, Out_t>;
+               if (GetCpuFeatures().sse2)
+                  return &ExtractSse2<Section_t, Word_t, Out_t>;
+#endif
+               return &ExtractScalar<Word_t, Section_t, Out_t>;
+            }();
+            kernel(in, count, out);
+         }
+
+         template<typename Mask_t, typename Word_t, size_t... Is, typename... Columns>
+         void Pack(Word_t* out, size_t count, std::index_sequence<Is...> indices, const Columns*... columns)
+         {
+            using Kernel_t = void(*)(Word_t*, size_t, std::index_sequence<Is...>, const Columns*...);
+            static const Kernel_t kernel = []() -> Kernel_t {
+#ifdef MDV_X86
+               if (GetCpuFeatures().avx2)
+                  return &PackAvx2<Mask_t>;
+               if (GetCpuFeatures().sse2)
+                  return &PackSse2<Mask_t>;
+#endif
+               return &PackScalar<Mask_t>;
+            }();
+            kernel(out, count, indices, columns...);
+         }
+
+         template<typename Mask_t, size_t SectionIndex, typename Out_t>
+         void ExtractSection(const Mask_t* in, size_t count, Out_t* out, std::true_type)
+         {
+            using Word_t = typename BitmaskStorage<Mask_t::RequiredSize>::Word_t;
+            static_assert(sizeof(Mask_t) == sizeof(Word_t), "Bitmask must consist of exactly one word!");
+
+            Extract<Section<Word_t, typename Mask_t::Numbers, SectionIndex>>(
+               reinterpret_cast<const Word_t*>(in), count, out);
+         }
+
+         template<typename Mask_t, size_t SectionIndex, typename Out_t>
+         void ExtractSection(const Mask_t* in, size_t count, Out_t* out, std::false_type)
+         {
+            for (size_t i = 0; i < count; ++i)
+            {
+               out[i] = static_cast<Out_t>(IndexedSections<Mask_t>::template Get<SectionIndex>(in[i]));
+            }
+         }
+
+         template<typename Mask_t, size_t... Is, typename... Columns>
+         void PackSections(Mask_t* out, size_t count, std::true_type, std::index_sequence<Is...> indices,
+            const Columns*... columns)
+         {
+            using Word_t = typename BitmaskStorage<Mask_t::RequiredSize>::Word_t;
+            static_assert(sizeof(Mask_t) == sizeof(Word_t), "Bitmask must consist of exactly one word!");
+
+            Pack<Mask_t>(reinterpret_cast<Word_t*>(out), count, indices, columns...);
+         }
+
+         template<typename Mask_t, size_t... Is, typename... Columns>
+         void PackSections(Mask_t* out, size_t count, std::false_type, std::index_sequence<Is...>,
+            const Columns*... columns)
+         {
+            for (size_t i = 0; i < count; ++i)
+            {
+               out[i] = Mask_t();
+               using swallow = int[];
+               (void)swallow {
+                  0, ((void)IndexedSections<Mask_t>::template Set<Is>(out[i], columns[i]), 0)...
+               };
+            }
+         }
+
+      }
+
+   }
+
+   //! \brief Extracts the section at Index from each of the given bitmasks. For bitmasks of up to 64 bits and
+   //!        integral output types that are not wider than the bitmask, this uses SSE2 or AVX2 kernels, depending
+   //!        on the CPU this program runs on. Values that don't fit into Out_t are truncated
+   //! \param in Array of 'count' bitmasks
+   //! \param out Array of 'count' values that receives the section values
+   template<size_t Index, size_t... Bits, typename Out_t>
+   void ExtractSection(const Bitmask<Bits...>* in, size_t count, Out_t* out)
+   {
+      using Mask_t = Bitmask<Bits...>;
+      static_assert(Index < Mask_t::Sections, "Index out of bounds!");
+      detail::bulk::ExtractSection<Mask_t, Index>(in, count, out,
+         detail::bulk::SupportsExtractKernels<Mask_t, Out_t>());
+   }
+
+   //! \brief Extracts the given section from each of the given bitmasks, see ExtractSection for Bitmask
+   template<typename Section, typename... NamedBits, typename Out_t>
+   void ExtractSection(const NamedBitmask<NamedBits...>* in, size_t count, Out_t* out)
+   {
+      using Mask_t = NamedBitmask<NamedBits...>;
+      static_assert(meta::Contains<Section, typename Mask_t::NamedSections>::value, "Section not found in this Bitmask!");
+      detail::bulk::ExtractSection<Mask_t, meta::IndexOf<Section, typename Mask_t::NamedSections>::value>(
+         in, count, out, detail::bulk::SupportsExtractKernels<Mask_t, Out_t>());
+   }
+
+   //! \brief Assembles bitmasks from one array of values per section. This is the inverse of ExtractSection. All
+   //!        sections of a vector of bitmasks are assembled at once, so the output is written in a single pass
+   //! \param out Array of 'count' bitmasks that receives the result
+   //! \param columns One array of 'count' values for each section of the bitmask, in section order
+   template<size_t... Bits, typename... Columns>
+   void PackSections(Bitmask<Bits...>* out, size_t count, const Columns*... columns)
+   {
+      using Mask_t = Bitmask<Bits...>;
+      static_assert(sizeof...(Columns) == Mask_t::Sections, "There must be exactly one column per section!");
+      using Supported = meta::Foldl_t<meta::And, std::true_type,
+         meta::Typelist<detail::bulk::SupportsKernels<Mask_t, Columns>...>>;
+      detail::bulk::PackSections(out, count, std::integral_constant<bool, Supported::value>(),
+         std::make_index_sequence<Mask_t::Sections>(), columns...);
+   }
+
+   template<typename... NamedBits, typename... Columns>
+   void PackSections(NamedBitmask<NamedBits...>* out, size_t count, const Columns*... columns)
+   {
+      using Mask_t = NamedBitmask<NamedBits...>;
+      static_assert(sizeof...(Columns) == Mask_t::Sections, "There must be exactly one column per section!");
+      using Supported = meta::Foldl_t<meta::And, std::true_type,
+         meta::Typelist<detail::bulk::SupportsKernels<Mask_t, Columns>...>>;
+      detail::bulk::PackSections(out, count, std::integral_constant<bool, Supported::value>(),
+         std::make_index_sequence<Mask_t::Sections>(), columns...);
+   }
+
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "..\meta\Meta.h"
+#include "Bitmask.h"
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      namespace radix
+      {
+
+         //! \brief Maximum number of bits per pass of the radix sort. 2^11 counters per pass still fit into the L1
+         //!        cache, and most sections need a single pass
+         constexpr size_t MaxDigitBits = 11;
+         constexpr size_t MaxBuckets = size_t(1) << MaxDigitBits;
+
+         //! \brief A range of bits in the storage of a bitmask
+         template<size_t Offset_, size_t Bits_>
+         struct BitRange
+         {
+            constexpr static size_t Offset = Offset_;
+            constexpr static size_t Bits = Bits_;
+         };
+
+         template<typename Range, typename Ranges, bool Adjacent>
+         struct PrependRange;
+
+         template<typename Range, typename Ranges>
+         struct PrependRange<Range, Ranges, false>
+         {
+            using type = meta::PushFront_t<Range, Ranges>;
+         };
+
+         //! \brief The next less significant key lies directly below Range, so both can be compared as one value
+         template<typename Range, typename Next, typename... Rest>
+         struct PrependRange<Range, meta::Typelist<Next, Rest...>, true>
+         {
+            using type = meta::Typelist<BitRange<Next::Offset, Next::Bits + Range::Bits>, Rest...>;
+         };
+
+         template<typename Range, typename Ranges>
+         struct IsAdjacent : std::false_type {};
+
+         template<typename Range, typename Next, typename... Rest>
+         struct IsAdjacent<Range, meta::Typelist<Next, Rest...>> :
+            std::integral_constant<bool, Next::Offset + Next::Bits == Range::Offset>
+         {
+         };
+
+         template<typename Numbers, size_t... Indices>
+         struct KeyRanges;
+
+         template<typename Numbers>
+         struct KeyRanges<Numbers>
+         {
+            using type = meta::Typelist<>;
+         };
+
+         //! \brief The bit ranges of the sort key, from the most to the least significant one. Sections that follow
+         //!        each other in the key and lie directly on top of each other in the bitmask become one range
+         template<typename Numbers, size_t First, size_t... Rest>
+         struct KeyRanges<Numbers, First, Rest...>
+         {
+            using Range_t = BitRange<meta::Sum<meta::Take_t<First, Numbers>>::value, meta::At_t<First, Numbers>::value>;
+            using Rest_t = typename KeyRanges<Numbers, Rest...>::type;
+
+            using type = std::conditional_t<Range_t::Bits == 0,
+               Rest_t,
+               typename PrependRange<Range_t, Rest_t, IsAdjacent<Range_t, Rest_t>::value>::type>;
+         };
+
+         //! \brief Splits a range into digits of similar size, the least significant digit first
+         template<size_t Offset, size_t Bits, size_t Width>
+         struct SplitRange
+         {
+            constexpr static size_t DigitBits = Bits < Width ? Bits : Width;
+            using type = meta::PushFront_t<BitRange<Offset, DigitBits>,
+               typename SplitRange<Offset + DigitBits, Bits - DigitBits, Width>::type>;
+         };
+
+         template<size_t Offset, size_t Width>
+         struct SplitRange<Offset, 0, Width>
+         {
+            using type = meta::Typelist<>;
+         };
+
+         template<typename Ranges>
+         struct Digits;
+
+         template<>
+         struct Digits<meta::Typelist<>>
+         {
+            using type = meta::Typelist<>;
+         };
+
+         //! \brief The digits of the radix sort for the given key ranges, in the order of the passes. A LSD radix sort
+         //!        starts with the least significant digit
+         template<typename First, typename... Rest>
+         struct Digits<meta::Typelist<First, Rest...>>
+         {
+            constexpr static size_t Passes = (First::Bits + MaxDigitBits - 1) / MaxDigitBits;
+            constexpr static size_t Width = (First::Bits + Passes - 1) / Passes;
+
+            using type = meta::Concat_t<typename Digits<meta::Typelist<Rest...>>::type,
+               typename SplitRange<First::Offset, First::Bits, Width>::type>;
+         };
+
+         template<typename Mask_t, typename DigitList>
+         struct Sorter;
+
+         //! \brief LSD radix sort with one pass per digit. All histograms are built in a single read of the input, and
+         //!        passes in which all elements have the same digit are skipped
+         template<typename Mask_t, typename... DigitList>
+         struct Sorter<Mask_t, meta::Typelist<DigitList...>>
+         {
+            using Words_t = StorageWords<Mask_t>;
+            using Word_t = typename Words_t::Word_t;
+
+            template<typename Digit>
+            static size_t Read(const Mask_t& mask)
+            {
+               Word_t words[Words_t::WordCount];
+               Words_t::Read(mask, words);
+               return static_cast<size_t>(SectionAccess<Word_t, Digit::Offset, Digit::Bits>::Get(words));
+            }
+
+            template<typename Iterator>
+            static void Sort(Iterator first, Iterator last)
+            {
+               const auto count = static_cast<size_t>(std::distance(first, last));
+               if (count < 2)
+                  return;
+
+               std::vector<size_t> histograms(sizeof...(DigitList) * MaxBuckets, 0);
+               CountDigits(first, count, histograms.data(), std::index_sequence_for<DigitList...>());
+
+               std::vector<Mask_t> buffer(count);
+               if (Passes(first, buffer.data(), count, histograms.data(), std::index_sequence_for<DigitList...>()))
+                  std::copy(buffer.begin(), buffer.end(), first);
+            }
+
+         private:
+            //! \returns True if the sorted elements are in the buffer afterwards
+            template<typename Iterator, size_t... Is>
+            static bool Passes(Iterator first, Mask_t* buffer, size_t count, size_t* histograms,
+               std::index_sequence<Is...>)
+            {
+               bool inBuffer = false;
+               using swallow = int[];
+               (void)swallow { 0, ((void)(inBuffer = Pass<DigitList>(first, buffer, count,
+                  histograms + Is * MaxBuckets, inBuffer)), 0)... };
+               return inBuffer;
+            }
+
+            template<typename Iterator, size_t... Is>
+            static void CountDigits(Iterator first, size_t count, size_t* histograms, std::index_sequence<Is...>)
+            {
+               for (size_t i = 0; i < count; ++i)
+               {
+                  const Mask_t& mask = first[i];
+                  using swallow = int[];
+                  (void)swallow { 0, ((void)++histograms[Is * MaxBuckets + Read<DigitList>(mask)], 0)... };
+               }
+            }
+
+            //! \brief Sorts by Digit from the input range into the buffer or back
+            //! \returns True if the sorted elements are in the buffer afterwards
+            template<typename Digit, typename Iterator>
+            static bool Pass(Iterator first, Mask_t* buffer, size_t count, size_t* histogram, bool inBuffer)
+            {
+               constexpr size_t buckets = size_t(1) << Digit::Bits;
+               if (std::find(histogram, histogram + buckets, count) != histogram + buckets)
+                  return inBuffer;
+
+               size_t offset = 0;
+               for (size_t bucket = 0; bucket < buckets; ++bucket)
+               {
+                  const auto size = histogram[bucket];
+                  histogram[bucket] = offset;
+                  offset += size;
+               }
+
+               if (inBuffer)
+                  Scatter<Digit>(buffer, first, count, histogram);
+               else
+                  Scatter<Digit>(first, buffer, count, histogram);
+               return !inBuffer;
+            }
+
+            template<typename Digit, typename From, typename To>
+            static void Scatter(From from, To to, size_t count, size_t* offsets)
+            {
+               for (size_t i = 0; i < count; ++i)
+               {
+                  const Mask_t& mask = from[i];
+                  to[offsets[Read<Digit>(mask)]++] = mask;
+               }
+            }
+         };
+
+         template<typename Mask_t, size_t... Indices>
+         using Sorter_t = Sorter<Mask_t,
+            typename Digits<typename KeyRanges<typename Mask_t::Numbers, Indices...>::type>::type>;
+
+         template<typename Iterator>
+         using Value_t = typename std::iterator_traits<Iterator>::value_type;
+
+         template<typename Iterator>
+         using EnableIfRandomAccess_t = std::enable_if_t<std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<Iterator>::iterator_category>::value>;
+
+      }
+
+   }
+
+   //! \brief Sorts a range of Bitmasks by the sections with the given indices with a radix sort. The first index is
+   //!        the most significant key, ties are broken by the following indices. The sort is stable.
+   //!
+   //! The passes of the radix sort are derived from the section sizes at compile time. Keys that lie directly on top of
+   //! each other in the bitmask, like SortBySections<3, 2>, are sorted as a single value
+   template<size_t... Indices, typename Iterator>
+   detail::radix::EnableIfRandomAccess_t<Iterator> SortBySections(Iterator first, Iterator last)
+   {
+      using Mask_t = detail::radix::Value_t<Iterator>;
+      static_assert(meta::Foldl_t<meta::And, std::true_type,
+         meta::Typelist<std::bool_constant<(Indices < Mask_t::Sections)>...>>::value, "Index out of bounds!");
+      detail::radix::Sorter_t<Mask_t, Indices...>::Sort(first, last);
+   }
+
+   //! \brief Sorts a range of NamedBitmasks by the given sections, see SortBySections for Bitmask
+   template<typename... Sections, typename Iterator>
+   detail::radix::EnableIfRandomAccess_t<Iterator> SortBySections(Iterator first, Iterator last)
+   {
+      using Mask_t = detail::radix::Value_t<Iterator>;
+      static_assert(meta::Foldl_t<meta::And, std::true_type,
+         meta::Typelist<std::bool_constant<meta::Contains<Sections, typename Mask_t::NamedSections>::value>...>>::value,
+         "Section not found in this Bitmask!");
+      detail::radix::Sorter_t<Mask_t, meta::IndexOf<Sections, typename Mask_t::NamedSections>::value...>::Sort(first,
+         last);
+   }
+
+}
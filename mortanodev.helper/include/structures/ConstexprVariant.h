@@ -0,0 +1,172 @@
+#pragma once
+#include "..\meta\Meta.h"
+#include "Bitmask.h"
+#include "Variant.h"
+
+#include <type_traits>
+#include <utility>
+
+namespace mdv {
+
+namespace detail {
+
+//! \brief Tag that selects the alternative with the given index when constructing a RecursiveUnion
+template <size_t Idx>
+using IndexTag = std::integral_constant<size_t, Idx>;
+
+//! \brief Union of all given types, defined recursively as the first type and a union of the remaining types.
+//!        In contrast to a char buffer with placement new, the active member of such a union can be initialized
+//!        and read in constant expressions
+template <typename... Args>
+union RecursiveUnion;
+
+template <>
+union RecursiveUnion<> {
+   constexpr RecursiveUnion() : _empty() {}
+
+   char _empty;
+};
+
+template <typename First, typename... Rest>
+union RecursiveUnion<First, Rest...> {
+   constexpr RecursiveUnion() : _empty() {}
+
+   template <typename... CtorArgs>
+   constexpr explicit RecursiveUnion(IndexTag<0>, CtorArgs&&... args) : _head(std::forward<CtorArgs>(args)...) {}
+
+   template <size_t Idx, typename... CtorArgs>
+   constexpr explicit RecursiveUnion(IndexTag<Idx>, CtorArgs&&... args)
+       : _tail(IndexTag<Idx - 1>(), std::forward<CtorArgs>(args)...) {}
+
+   char _empty;
+   First _head;
+   RecursiveUnion<Rest...> _tail;
+};
+
+//! \brief Access to the member of a RecursiveUnion at the given index
+template <size_t Idx>
+struct UnionAccess {
+   template <typename First, typename... Rest>
+   static constexpr const meta::At_t<Idx, meta::Typelist<First, Rest...>>& Get(
+       const RecursiveUnion<First, Rest...>& u) {
+      return UnionAccess<Idx - 1>::Get(u._tail);
+   }
+
+   template <typename First, typename... Rest>
+   static meta::At_t<Idx, meta::Typelist<First, Rest...>>& Get(RecursiveUnion<First, Rest...>& u) {
+      return UnionAccess<Idx - 1>::Get(u._tail);
+   }
+};
+
+template <>
+struct UnionAccess<0> {
+   template <typename First, typename... Rest>
+   static constexpr const First& Get(const RecursiveUnion<First, Rest...>& u) {
+      return u._head;
+   }
+
+   template <typename First, typename... Rest>
+   static First& Get(RecursiveUnion<First, Rest...>& u) {
+      return u._head;
+   }
+};
+}
+
+//! \brief Variant that can be created and read in constant expressions, so that tables of variants can be built
+//!        at compile time and need no initialization at startup. This requires all types to be trivially
+//!        copyable and trivially destructible, which makes the variant itself a trivially copyable literal type.
+//!        For all other types, use Variant
+template <typename... Args>
+class ConstexprVariant {
+public:
+   constexpr static size_t ArgCount = sizeof...(Args);
+
+   using ThisType = ConstexprVariant<Args...>;
+   using Types = meta::Typelist<Args...>;
+
+   static_assert(ArgCount > 0, "ConstexprVariant requires at least one type!");
+   static_assert(detail::AllTypes_t<detail::TriviallyCopyable, Args...>::value,
+                 "ConstexprVariant requires trivially copyable and destructible types!");
+
+   constexpr ConstexprVariant() : _storage(), _index(InvalidIdx) {}
+
+   template <typename T, typename Decayed_t = std::decay_t<T>>
+   constexpr explicit ConstexprVariant(T&& val,
+                                       std::enable_if_t<!std::is_same<ThisType, Decayed_t>::value &&
+                                                        !detail::IsInPlaceType<Decayed_t>::value>* = nullptr)
+       : _storage(detail::IndexTag<meta::IndexOf<Decayed_t, Types>::value>(), std::forward<T>(val)),
+         _index(meta::IndexOf<Decayed_t, Types>::value) {
+      static_assert(meta::Contains<Decayed_t, Types>::value, "This is no valid type for this variant!");
+   }
+
+   //! \brief Constructs an object of type T directly inside this variant
+   //! \param args Arguments that are passed to the constructor of T
+   template <typename T, typename... CtorArgs>
+   constexpr explicit ConstexprVariant(InPlaceType<T>, CtorArgs&&... args)
+       : _storage(detail::IndexTag<meta::IndexOf<T, Types>::value>(), std::forward<CtorArgs>(args)...),
+         _index(meta::IndexOf<T, Types>::value) {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+   }
+
+   constexpr bool HasValue() const { return _index != InvalidIdx; }
+
+   template <typename T>
+   constexpr bool Is() const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return meta::IndexOf<T, Types>::value == _index;
+   }
+
+   template <typename T>
+   constexpr const T& Get() const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return Is<T>() ? detail::UnionAccess<meta::IndexOf<T, Types>::value>::Get(_storage)
+                     : throw BadVariantAccess();
+   }
+
+   template <typename T>
+   T& Get() {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      if (MDV_UNLIKELY(!Is<T>()))
+         detail::ThrowBadVariantAccess();
+      return detail::UnionAccess<meta::IndexOf<T, Types>::value>::Get(_storage);
+   }
+
+   //! \brief Calls the visitor with the value that is currently stored. This can be evaluated at compile time if
+   //!        the call operators of the visitor are constexpr. The variant must have a value! Visiting an empty
+   //!        variant throws BadVariantAccess, so it is rejected during constant evaluation
+   template <typename Visitor>
+   constexpr decltype(auto) Visit(Visitor&& visitor) const {
+      MDV_ASSERT(HasValue());
+      return VisitFrom(IndexTag<0>(), std::forward<Visitor>(visitor));
+   }
+
+private:
+   template <size_t Idx>
+   using IndexTag = detail::IndexTag<Idx>;
+
+   //! \brief Same index type as Variant uses
+   using Index_t = detail::SizeToType_t<detail::BitsRequired(sizeof...(Args))>;
+
+   constexpr static Index_t InvalidIdx = static_cast<Index_t>(-1);
+
+   //! \brief Compares the stored index with each type index in turn. This is a chain of conditional operators,
+   //!        because C++11 constexpr functions (which is all that some compilers support) can't index tables
+   template <size_t Idx, typename Visitor>
+   constexpr decltype(auto) VisitFrom(IndexTag<Idx>, Visitor&& visitor) const {
+      return _index == Idx ? std::forward<Visitor>(visitor)(detail::UnionAccess<Idx>::Get(_storage))
+                           : VisitFrom(IndexTag<Idx + 1>(), std::forward<Visitor>(visitor));
+   }
+
+   //! \brief The last alternative is only read if it is active. Otherwise the variant is empty, and falling through
+   //!        to the last alternative would read an inactive union member
+   template <typename Visitor>
+   constexpr decltype(auto) VisitFrom(IndexTag<ArgCount - 1>, Visitor&& visitor) const {
+      return _index == ArgCount - 1
+                 ? std::forward<Visitor>(visitor)(detail::UnionAccess<ArgCount - 1>::Get(_storage))
+                 : throw BadVariantAccess();
+   }
+
+   detail::RecursiveUnion<Args...> _storage;
+   Index_t _index;
+};
+}
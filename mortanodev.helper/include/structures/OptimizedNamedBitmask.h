@@ -0,0 +1,265 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+#include "..\meta\Meta.h"
+#include "Bitmask.h"
+
+namespace mdv
+{
+
+   //! \brief Marks a section of an OptimizedNamedBitmask as hot. Hot sections are placed at the start of the
+   //!        bitmask, the first one at bit offset 0, where reading it is a single mask without a shift
+   template<typename Section>
+   struct Hot : std::integral_constant<size_t, Section::value>
+   {
+   };
+
+   namespace detail
+   {
+
+      namespace layout
+      {
+
+         template<typename T>
+         struct StripHot
+         {
+            using type = T;
+            constexpr static bool IsHot = false;
+         };
+
+         template<typename Section>
+         struct StripHot<Hot<Section>>
+         {
+            using type = Section;
+            constexpr static bool IsHot = true;
+         };
+
+         template<typename T>
+         using StripHot_t = typename StripHot<T>::type;
+
+         //! \brief Unused bits that are inserted so that the next section starts at a word boundary instead of
+         //!        straddling it. The offset makes each padding a distinct section
+         template<size_t Offset, size_t Bits>
+         struct Padding : std::integral_constant<size_t, Bits>
+         {
+         };
+
+         template<typename T>
+         struct IsPadding : std::false_type {};
+
+         template<size_t Offset, size_t Bits>
+         struct IsPadding<Padding<Offset, Bits>> : std::true_type {};
+
+         template<typename L, typename R>
+         struct LargerFirst : std::integral_constant<bool, (L::value > R::value)> {};
+
+         template<size_t Space, typename TList, size_t Index = 0>
+         struct FirstFit;
+
+         template<size_t Space, size_t Index>
+         struct FirstFit<Space, meta::Typelist<>, Index> : std::integral_constant<size_t, Index> {};
+
+         //! \brief Index of the first section that fits into Space bits, or the size of the list if none fits
+         template<size_t Space, typename First, typename... Rest, size_t Index>
+         struct FirstFit<Space, meta::Typelist<First, Rest...>, Index> :
+            std::integral_constant<size_t, First::value <= Space ?
+               Index :
+               FirstFit<Space, meta::Typelist<Rest...>, Index + 1>::value>
+         {
+         };
+
+         enum class Step
+         {
+            Done,
+            Fit,      //A section fits into the rest of the current word
+            Pad,      //Nothing fits, the rest of the word becomes padding
+            Straddle  //Nothing fits and there are not enough spare bits for padding
+         };
+
+         template<size_t Offset, size_t Slack, typename Remaining>
+         struct NextStep
+         {
+            constexpr static size_t Space = WordBits - Offset % WordBits;
+            constexpr static size_t Fit = FirstFit<Space, Remaining>::value;
+            constexpr static Step value = meta::Size<Remaining>::value == 0 ? Step::Done :
+               Fit < meta::Size<Remaining>::value ? Step::Fit :
+               Space <= Slack ? Step::Pad :
+               Step::Straddle;
+         };
+
+         template<size_t Offset, size_t Slack, typename Placed, typename Remaining,
+            Step Next = NextStep<Offset, Slack, Remaining>::value>
+         struct Place;
+
+         template<size_t Offset, size_t Slack, typename Placed, typename Remaining>
+         struct Place<Offset, Slack, Placed, Remaining, Step::Done>
+         {
+            using type = Placed;
+         };
+
+         //! \brief Places sections one after another, always the first remaining one that still fits into the current
+         //!        word. The sections are sorted by decreasing size, so the large ones go first and the small ones
+         //!        fill the gaps at the end of each word
+         template<size_t Offset, size_t Slack, typename Placed, typename Remaining>
+         struct Place<Offset, Slack, Placed, Remaining, Step::Fit>
+         {
+            constexpr static size_t Index = NextStep<Offset, Slack, Remaining>::Fit;
+            using Section_t = meta::At_t<Index, Remaining>;
+            using type = typename Place<Offset + Section_t::value, Slack,
+               meta::PushBack_t<Section_t, Placed>, meta::EraseAt_t<Index, Remaining>>::type;
+         };
+
+         template<size_t Offset, size_t Slack, typename Placed, typename Remaining>
+         struct Place<Offset, Slack, Placed, Remaining, Step::Pad>
+         {
+            constexpr static size_t Space = NextStep<Offset, Slack, Remaining>::Space;
+            using type = typename Place<Offset + Space, Slack - Space,
+               meta::PushBack_t<Padding<Offset, Space>, Placed>, Remaining>::type;
+         };
+
+         template<size_t Offset, size_t Slack, typename Placed, typename First, typename... Rest>
+         struct Place<Offset, Slack, Placed, meta::Typelist<First, Rest...>, Step::Straddle>
+         {
+            using type = typename Place<Offset + First::value, Slack,
+               meta::PushBack_t<First, Placed>, meta::Typelist<Rest...>>::type;
+         };
+
+         template<typename... Sections>
+         struct SplitHot;
+
+         template<>
+         struct SplitHot<>
+         {
+            using Hot_t = meta::Typelist<>;
+            using Cold_t = meta::Typelist<>;
+         };
+
+         template<typename First, typename... Rest>
+         struct SplitHot<First, Rest...>
+         {
+            using Hot_t = std::conditional_t<StripHot<First>::IsHot,
+               meta::PushFront_t<StripHot_t<First>, typename SplitHot<Rest...>::Hot_t>,
+               typename SplitHot<Rest...>::Hot_t>;
+            using Cold_t = std::conditional_t<StripHot<First>::IsHot,
+               typename SplitHot<Rest...>::Cold_t,
+               meta::PushFront_t<First, typename SplitHot<Rest...>::Cold_t>>;
+         };
+
+         //! \brief The order of the sections in an OptimizedNamedBitmask. The hot sections come first, in the order in
+         //!        which they were declared. The other sections follow by decreasing size, and in bitmasks of more than
+         //!        one word they are arranged so that as few of them as possible straddle two words. Padding is only
+         //!        added if it fits into the unused bits of the last word, so the size of the bitmask never changes
+         template<typename... Sections>
+         struct Layout
+         {
+            constexpr static size_t RequiredSize = meta::Sum<meta::Numberlist<Sections::value...>>::value;
+            constexpr static size_t Slack = RequiredSize <= WordBits ?
+               0 :
+               BitmaskStorage<RequiredSize>::WordCount * WordBits - RequiredSize;
+
+            using Hot_t = typename SplitHot<Sections...>::Hot_t;
+            using Cold_t = meta::Sort_t<LargerFirst, typename SplitHot<Sections...>::Cold_t>;
+            using HotBits_t = meta::NumberlistFromTypelist_t<Hot_t>;
+
+            using type = typename Place<meta::Sum<HotBits_t>::value, Slack, Hot_t, Cold_t>::type;
+         };
+
+         template<typename Sections>
+         struct AsNamedBitmask;
+
+         template<typename... Sections>
+         struct AsNamedBitmask<meta::Typelist<Sections...>>
+         {
+            using type = NamedBitmask<Sections...>;
+         };
+
+         //! \brief The constructor argument for a section of the layout, taken from the arguments in declaration
+         //!        order. Padding is always zero
+         template<typename Section, typename Declared, bool = IsPadding<Section>::value>
+         struct Argument
+         {
+            template<typename Tuple>
+            constexpr static SizeTypeToType_t<Section> Get(const Tuple& args)
+            {
+               return std::get<meta::IndexOf<Section, Declared>::value>(args);
+            }
+         };
+
+         template<typename Section, typename Declared>
+         struct Argument<Section, Declared, true>
+         {
+            template<typename Tuple>
+            constexpr static SizeTypeToType_t<Section> Get(const Tuple&)
+            {
+               return 0;
+            }
+         };
+
+      }
+
+   }
+
+   //! \brief NamedBitmask that reorders its sections at compile time to make accessing them cheaper. Sections
+   //!        wrapped in Hot<> are placed at the start of the bitmask, and in bitmasks of more than 64 bits the other
+   //!        sections are arranged so that they avoid straddling two words.
+   //!
+   //! The sections are accessed by name exactly like in NamedBitmask, and the constructor and GetAll use the order in
+   //! which the sections are declared here. Only the bits in memory are ordered differently, see Layout for the
+   //! resulting order
+   //!
+   //! Example: OptimizedNamedBitmask<Hot<Id>, Flags, Payload>
+   template<typename... NamedBits>
+   class OptimizedNamedBitmask :
+      public detail::layout::AsNamedBitmask<typename detail::layout::Layout<NamedBits...>::type>::type
+   {
+      using Base_t = typename detail::layout::AsNamedBitmask<typename detail::layout::Layout<NamedBits...>::type>::type;
+   public:
+      //! \brief The sections in declaration order, without the Hot tags
+      using DeclaredSections = meta::Typelist<detail::layout::StripHot_t<NamedBits>...>;
+      //! \brief The sections in the order in which they lie in memory, including padding
+      using Layout = typename detail::layout::Layout<NamedBits...>::type;
+
+      constexpr OptimizedNamedBitmask() :
+         Base_t()
+      {
+      }
+
+      //! \brief Initializes this bitmask with one value for each section, in declaration order
+      constexpr explicit OptimizedNamedBitmask(detail::SizeTypeToType_t<NamedBits>... args) :
+         OptimizedNamedBitmask(Layout(), std::make_tuple(args...))
+      {
+      }
+
+      //! \brief Get the values of all sections, in declaration order
+      decltype(auto) GetAll() const
+      {
+         return this->template GetMany<detail::layout::StripHot_t<NamedBits>...>();
+      }
+
+   private:
+      template<typename... Sections, typename Tuple>
+      constexpr OptimizedNamedBitmask(meta::Typelist<Sections...>, const Tuple& args) :
+         Base_t(detail::layout::Argument<Sections, DeclaredSections>::Get(args)...)
+      {
+      }
+   };
+
+}
+
+namespace std
+{
+
+   //! \brief Hash for OptimizedNamedBitmask, see the hash for NamedBitmask
+   template<typename... NamedBits>
+   struct hash<mdv::OptimizedNamedBitmask<NamedBits...>>
+   {
+      size_t operator()(const mdv::OptimizedNamedBitmask<NamedBits...>& mask) const
+      {
+         return mdv::detail::StorageWords<mdv::OptimizedNamedBitmask<NamedBits...>>::Hash(mask);
+      }
+   };
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "..\meta\Meta.h"
+
+namespace mdv
+{
+
+   namespace detail
+   {
+
+      namespace packed
+      {
+
+         template<typename L, typename R>
+         struct StricterAlignmentFirst : std::integral_constant<bool, (alignof(L) > alignof(R))> {};
+
+         //! \brief Storage of a single element, Position is its index in memory. Since the size of a type is a
+         //!        multiple of its alignment, elements ordered by decreasing alignment need no padding in between
+         template<size_t Position, typename T>
+         struct Element
+         {
+            constexpr Element() :
+               value()
+            {
+            }
+
+            constexpr explicit Element(const T& initial) :
+               value(initial)
+            {
+            }
+
+            T value;
+         };
+
+         template<typename Layout, typename Indices, typename Order>
+         struct Storage;
+
+         //! \brief All elements as base classes, in the order in which they lie in memory
+         template<typename... Layout, size_t... Positions, size_t... Order>
+         struct Storage<meta::Typelist<Layout...>, std::index_sequence<Positions...>, meta::Numberlist<Order...>> :
+            Element<Positions, Layout>...
+         {
+            constexpr Storage() = default;
+
+            //! \brief Initializes the elements from a tuple of arguments in declaration order. Order contains the
+            //!        declaration index of the element at each position in memory
+            template<typename Tuple>
+            constexpr explicit Storage(const Tuple& args) :
+               Element<Positions, Layout>(std::get<Order>(args))...
+            {
+            }
+         };
+
+      }
+
+   }
+
+   //! \brief Tuple that orders its members by decreasing alignment to avoid padding. sizeof(PackedTuple<char, double,
+   //!        char, int>) is 16 instead of the 24 bytes of a struct with the members in this order.
+   //!
+   //! The elements are accessed by their index in declaration order, or by their type if it occurs only once. Only
+   //! the order in memory differs from the order in which the types are declared, see Layout
+   //!
+   //! Example: PackedTuple<uint8_t, uint64_t, uint16_t> t{ 1, 2, 3 }; t.Get<2>() == 3; t.Get<uint64_t>() == 2;
+   template<typename... Args>
+   class PackedTuple
+   {
+   public:
+      //! \brief The types in declaration order
+      using Types = meta::Typelist<Args...>;
+      //! \brief Declaration index of the element at each position in memory
+      using Order = meta::SortPermutation_t<detail::packed::StricterAlignmentFirst, Types>;
+      //! \brief Position in memory of each element, in declaration order
+      using Positions = meta::InversePermutation_t<Order>;
+      //! \brief The types in the order in which they lie in memory
+      using Layout = meta::Sort_t<detail::packed::StricterAlignmentFirst, Types>;
+
+      //! \brief Value-initializes all elements
+      constexpr PackedTuple() :
+         _storage()
+      {
+      }
+
+      //! \brief Initializes the elements with the given values, in declaration order
+      constexpr explicit PackedTuple(const Args&... args) :
+         _storage(std::forward_as_tuple(args...))
+      {
+      }
+
+      //! \brief Access the element at the given index in declaration order
+      template<size_t Idx>
+      meta::At_t<Idx, Types>& Get()
+      {
+         return ElementAt<Idx>().value;
+      }
+
+      template<size_t Idx>
+      constexpr const meta::At_t<Idx, Types>& Get() const
+      {
+         return ElementAt<Idx>().value;
+      }
+
+      //! \brief Access the element of the given type. The type must occur exactly once
+      template<typename T>
+      T& Get()
+      {
+         return Get<UniqueIndex<T>()>();
+      }
+
+      template<typename T>
+      constexpr const T& Get() const
+      {
+         return Get<UniqueIndex<T>()>();
+      }
+
+      friend bool operator==(const PackedTuple& l, const PackedTuple& r)
+      {
+         return l.Equal(r, std::index_sequence_for<Args...>());
+      }
+
+      friend bool operator!=(const PackedTuple& l, const PackedTuple& r)
+      {
+         return !(l == r);
+      }
+
+   private:
+      using Storage_t = detail::packed::Storage<Layout, std::index_sequence_for<Args...>, Order>;
+
+      template<size_t Idx>
+      using Element_t = detail::packed::Element<meta::At<Idx, Positions>::value, meta::At_t<Idx, Types>>;
+
+      template<size_t Idx>
+      Element_t<Idx>& ElementAt()
+      {
+         return static_cast<Element_t<Idx>&>(_storage);
+      }
+
+      template<size_t Idx>
+      constexpr const Element_t<Idx>& ElementAt() const
+      {
+         return static_cast<const Element_t<Idx>&>(_storage);
+      }
+
+      template<typename T>
+      constexpr static size_t UniqueIndex()
+      {
+         static_assert(meta::Contains<T, Types>::value, "This is no valid type for this tuple!");
+         static_assert(meta::Sum<meta::Numberlist<std::is_same<T, Args>::value...>>::value < 2,
+            "The type occurs more than once in this tuple, access the element by index instead!");
+         return meta::IndexOf<T, Types>::value;
+      }
+
+      template<size_t... Is>
+      bool Equal(const PackedTuple& other, std::index_sequence<Is...>) const
+      {
+         bool equal = true;
+         using swallow = int[];
+         (void)swallow{ 0, (equal = equal && Get<Is>() == other.Get<Is>(), 0)... };
+         return equal;
+      }
+
+      Storage_t _storage;
+   };
+
+}
@@ -0,0 +1,286 @@
+#pragma once
+#include "..\meta\Meta.h"
+#include "..\error_handling\Assert.h"
+#include "..\util\VectorStorage.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdv {
+
+//! \brief Non-owning view of the contiguous elements of one column of an SoAVector. It stays valid until the
+//!        SoAVector is modified
+template <typename T>
+class ColumnSpan {
+public:
+   using value_type = std::remove_const_t<T>;
+   using iterator = T*;
+
+   ColumnSpan(T* data, size_t size) : _data(data), _size(size) {}
+
+   //! \brief First element of the column. Columns start at a multiple of 64 bytes
+   T* Data() const { return _data; }
+
+   size_t Size() const { return _size; }
+
+   bool Empty() const { return _size == 0; }
+
+   T& operator[](size_t index) const {
+      MDV_ASSERT(index < _size);
+      return _data[index];
+   }
+
+   T* begin() const { return _data; }
+   T* end() const { return _data + _size; }
+
+private:
+   T* _data;
+   size_t _size;
+};
+
+namespace detail {
+
+namespace soa {
+
+//! \brief Alignment of the first element of every column. This is a full cache line, which is also enough for
+//!        aligned AVX-512 loads
+constexpr size_t ColumnAlignment = 64;
+
+//! \brief Allocator for the columns. Allocates a little more memory than requested and stores the pointer to the
+//!        actual allocation right in front of the aligned block
+template <typename T>
+struct AlignedAllocator {
+   using value_type = T;
+
+   static_assert(alignof(T) <= ColumnAlignment, "The alignment of the type is too large for an SoAVector!");
+
+   AlignedAllocator() = default;
+
+   template <typename U>
+   AlignedAllocator(const AlignedAllocator<U>&) {}
+
+   T* allocate(size_t count) {
+      constexpr size_t Overhead = ColumnAlignment + sizeof(void*);
+      if (count > (std::numeric_limits<size_t>::max() - Overhead) / sizeof(T))
+         throw std::bad_alloc();
+
+      const auto raw = ::operator new(count * sizeof(T) + Overhead);
+      const auto aligned =
+          (reinterpret_cast<uintptr_t>(raw) + Overhead - 1) & ~static_cast<uintptr_t>(ColumnAlignment - 1);
+      reinterpret_cast<void**>(aligned)[-1] = raw;
+      return reinterpret_cast<T*>(aligned);
+   }
+
+   void deallocate(T* data, size_t) { ::operator delete(reinterpret_cast<void**>(data)[-1]); }
+
+   template <typename U>
+   bool operator==(const AlignedAllocator<U>&) const {
+      return true;
+   }
+
+   template <typename U>
+   bool operator!=(const AlignedAllocator<U>&) const {
+      return false;
+   }
+};
+
+//! \brief Storage of a column. bool fields are stored in a byte each, so that the column has a data pointer
+template <typename T>
+struct Column {
+   using type = std::vector<VectorStorage_t<T>, AlignedAllocator<VectorStorage_t<T>>>;
+};
+
+template <typename TList>
+struct AsTuple;
+
+template <typename... Args>
+struct AsTuple<meta::Typelist<Args...>> {
+   using type = std::tuple<Args...>;
+};
+
+}
+
+}
+
+template <typename Fields>
+class SoAVector;
+
+//! \brief Container of records with the given fields, stored as struct of arrays: Each field has a contiguous,
+//!        64-byte aligned column of its own. A loop that only reads a few fields of every record only touches the
+//!        memory of these columns, and the columns can be processed with SIMD instructions.
+//!
+//! Records are appended as a whole with PushBack or Emplace. operator[] returns a proxy for a single record, and
+//! Column returns all values of one field. Fields are accessed by their index, or by their type if it occurs only
+//! once.
+//!
+//! Example: SoAVector<meta::Typelist<uint32_t, float, double>> v; v.PushBack(1, 2.f, 3.0); v.Column<float>()[0];
+template <typename... Fields>
+class SoAVector<meta::Typelist<Fields...>> {
+public:
+   constexpr static size_t FieldCount = sizeof...(Fields);
+
+   using Types = meta::Typelist<Fields...>;
+
+   static_assert(FieldCount > 0, "SoAVector requires at least one field!");
+
+   //! \brief Proxy for the record at an index. It stays valid until the SoAVector is modified
+   template <bool Const>
+   class RowProxy {
+      using Owner_t = std::conditional_t<Const, const SoAVector, SoAVector>;
+
+   public:
+      RowProxy(Owner_t& owner, size_t index) : _owner(&owner), _index(index) {}
+
+      //! \brief A mutable row can be used wherever a const row is expected
+      RowProxy(const RowProxy<false>& row) : _owner(row._owner), _index(row._index) {}
+
+      size_t Index() const { return _index; }
+
+      //! \brief Access the field at the given index
+      template <size_t Idx>
+      decltype(auto) Get() const {
+         return _owner->template Column<Idx>()[_index];
+      }
+
+      //! \brief Access the field of the given type
+      template <typename T>
+      decltype(auto) Get() const {
+         return _owner->template Column<T>()[_index];
+      }
+
+      //! \brief Copy of all fields of the record
+      std::tuple<Fields...> Values() const { return ValuesOf(std::index_sequence_for<Fields...>()); }
+
+   private:
+      template <size_t... Is>
+      std::tuple<Fields...> ValuesOf(std::index_sequence<Is...>) const {
+         return std::tuple<Fields...>(Get<Is>()...);
+      }
+
+      template <bool>
+      friend class RowProxy;
+
+      Owner_t* _owner;
+      size_t _index;
+   };
+
+   using Row = RowProxy<false>;
+   using ConstRow = RowProxy<true>;
+
+   //! \brief Number of records
+   size_t Size() const { return std::get<0>(_columns).size(); }
+
+   bool Empty() const { return Size() == 0; }
+
+   //! \brief Appends a record with the given values, one for each field
+   void PushBack(const Fields&... values) { Emplace(values...); }
+
+   //! \brief Appends a record, each field is constructed in place from one of the given values
+   template <typename... Values>
+   void Emplace(Values&&... values) {
+      static_assert(sizeof...(Values) == FieldCount, "Emplace requires one value for each field!");
+      EmplaceRow(std::index_sequence_for<Fields...>(), std::forward<Values>(values)...);
+   }
+
+   //! \brief Removes the last record
+   void PopBack() {
+      MDV_ASSERT(!Empty());
+      ForEachColumn([](auto& column) { column.pop_back(); });
+   }
+
+   Row operator[](size_t index) {
+      MDV_ASSERT(index < Size());
+      return Row(*this, index);
+   }
+
+   ConstRow operator[](size_t index) const {
+      MDV_ASSERT(index < Size());
+      return ConstRow(*this, index);
+   }
+
+   //! \brief All values of the field at the given index
+   template <size_t Idx>
+   ColumnSpan<meta::At_t<Idx, Types>> Column() {
+      auto& column = std::get<Idx>(_columns);
+      return ColumnSpan<meta::At_t<Idx, Types>>(detail::VectorStorage<meta::At_t<Idx, Types>>::Data(column.data()),
+                                                column.size());
+   }
+
+   template <size_t Idx>
+   ColumnSpan<const meta::At_t<Idx, Types>> Column() const {
+      const auto& column = std::get<Idx>(_columns);
+      return ColumnSpan<const meta::At_t<Idx, Types>>(
+          detail::VectorStorage<meta::At_t<Idx, Types>>::Data(column.data()), column.size());
+   }
+
+   //! \brief All values of the field of the given type. The type must occur exactly once
+   template <typename T>
+   ColumnSpan<T> Column() {
+      return Column<UniqueIndex<T>()>();
+   }
+
+   template <typename T>
+   ColumnSpan<const T> Column() const {
+      return Column<UniqueIndex<T>()>();
+   }
+
+   //! \brief Reserves memory for the given number of records in every column
+   void Reserve(size_t count) {
+      ForEachColumn([count](auto& column) { column.reserve(count); });
+   }
+
+   //! \brief Adds or removes records at the end. New records are value-initialized
+   void Resize(size_t count) {
+      ForEachColumn([count](auto& column) { column.resize(count); });
+   }
+
+   void Clear() {
+      ForEachColumn([](auto& column) { column.clear(); });
+   }
+
+private:
+   using Columns_t = typename detail::soa::AsTuple<meta::Transform_t<detail::soa::Column, Types>>::type;
+
+   template <typename T>
+   constexpr static size_t UniqueIndex() {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid field type for this SoAVector!");
+      static_assert(meta::Sum<meta::Numberlist<std::is_same<T, Fields>::value...>>::value < 2,
+                    "The type occurs more than once in this SoAVector, access the field by index instead!");
+      return meta::IndexOf<T, Types>::value;
+   }
+
+   template <typename Func>
+   void ForEachColumn(Func&& func) {
+      ForEachColumnImpl(func, std::index_sequence_for<Fields...>());
+   }
+
+   template <typename Func, size_t... Is>
+   void ForEachColumnImpl(Func& func, std::index_sequence<Is...>) {
+      using swallow = int[];
+      (void)swallow{0, ((void)func(std::get<Is>(_columns)), 0)...};
+   }
+
+   template <size_t... Is, typename... Values>
+   void EmplaceRow(std::index_sequence<Is...>, Values&&... values) {
+      using swallow = int[];
+      // If a field can't be appended, the fields that were already appended are removed again so that all columns
+      // keep the same size
+      size_t appended = 0;
+      try {
+         (void)swallow{0, ((void)std::get<Is>(_columns).emplace_back(std::forward<Values>(values)), ++appended, 0)...};
+      } catch (...) {
+         (void)swallow{0, (Is < appended ? ((void)std::get<Is>(_columns).pop_back(), 0) : 0)...};
+         throw;
+      }
+   }
+
+   Columns_t _columns;
+};
+
+}
@@ -1,71 +1,160 @@
 #pragma once
 #include "..\meta\Meta.h"
 #include "..\error_handling\Assert.h"
+#include "..\util\Compiler.h"
+#include "Bitmask.h"
 
+#include <new>
+#include <stdexcept>
 #include <type_traits>
 
 namespace mdv {
 
+//! \brief Thrown when the value of a variant is accessed as a type that it does not store currently
+class BadVariantAccess : public std::logic_error {
+public:
+   BadVariantAccess()
+       : std::logic_error(
+             "Trying to get data of a type from a variant that does not store this type currently!") {}
+};
+
 namespace detail {
 
-//! \brief Helper structure that provides methods to construct an object of a
-//! type only known at
-//! runtime into a memory block. This selects the right type out of a typelist
-//! using a runtime index
-template <size_t Idx, typename... Args>
+//! \brief Throws BadVariantAccess. This is kept out of line so that the throw does not prevent inlining of the
+//!        accessors that call it
+MDV_NORETURN MDV_NOINLINE inline void ThrowBadVariantAccess() { throw BadVariantAccess(); }
+
+//! \brief Construction and destruction operations for a single type, operating on raw memory. These are the
+//!        entries of the dispatch tables inside ConstructHelper
+template <typename T>
+struct TypeOperations {
+   static void CopyConstruct(const void* src, void* dst) {
+      auto& srcObj = *reinterpret_cast<const T*>(src);
+      new (dst) T(srcObj);
+   }
+
+   static void MoveConstruct(void* src, void* dst) {
+      auto& srcObj = *reinterpret_cast<T*>(src);
+      new (dst) T(std::move(srcObj));
+   }
+
+   static void DefaultConstruct(void* dst) { new (dst) T(); }
+
+   //! \brief Copy assigns src to dst, which both hold a T, so that T can reuse the resources of dst
+   //! \returns False if T can neither be assigned nor replaced without the risk of losing dst. dst is untouched
+   //!          then and the caller has to destroy and copy construct it
+   static bool CopyAssign(const void* src, void* dst) {
+      return CopyAssign(src, dst, AssignKind<std::is_copy_assignable<T>>());
+   }
+
+   //! \brief Move assigns src to dst, which both hold a T
+   //! \returns False if dst was left untouched, see CopyAssign
+   static bool MoveAssign(void* src, void* dst) {
+      return MoveAssign(src, dst, AssignKind<std::is_move_assignable<T>>());
+   }
+
+   static void Destruct(void* src) {
+      auto& srcObj = *reinterpret_cast<T*>(src);
+      srcObj.~T();
+   }
+
+private:
+   //! \brief T is assigned, replaced with a nothrow move, or not handled at all
+   using Assign_t = std::integral_constant<int, 0>;
+   using NothrowReplace_t = std::integral_constant<int, 1>;
+   using Unhandled_t = std::integral_constant<int, 2>;
+
+   template <typename Assignable>
+   using AssignKind = std::integral_constant<int, Assignable::value ? 0
+                                                  : std::is_nothrow_move_constructible<T>::value ? 1 : 2>;
+
+   static bool CopyAssign(const void* src, void* dst, Assign_t) {
+      *reinterpret_cast<T*>(dst) = *reinterpret_cast<const T*>(src);
+      return true;
+   }
+
+   //! \brief Types without assignment are replaced. The copy is made first and moving it can't throw, so dst
+   //!        still holds its value if the copy throws
+   static bool CopyAssign(const void* src, void* dst, NothrowReplace_t) {
+      T copy(*reinterpret_cast<const T*>(src));
+      Destruct(dst);
+      new (dst) T(std::move(copy));
+      return true;
+   }
+
+   static bool CopyAssign(const void*, void*, Unhandled_t) { return false; }
+
+   static bool MoveAssign(void* src, void* dst, Assign_t) {
+      *reinterpret_cast<T*>(dst) = std::move(*reinterpret_cast<T*>(src));
+      return true;
+   }
+
+   static bool MoveAssign(void* src, void* dst, NothrowReplace_t) {
+      Destruct(dst);
+      new (dst) T(std::move(*reinterpret_cast<T*>(src)));
+      return true;
+   }
+
+   static bool MoveAssign(void*, void*, Unhandled_t) { return false; }
+};
+
+//! \brief Helper structure that provides methods to construct an object of a type only known at runtime into a
+//!        memory block. The type is selected out of the typelist by indexing a table of function pointers that
+//!        is generated at compile time, so each operation costs one indirect call independent of the number
+//!        of types
+template <typename... Args>
 struct ConstructHelper {
-   using TList = meta::Typelist<Args...>;
-   using CurrentType_t = meta::At_t<Idx, TList>;
+   using CopyConstruct_t = void (*)(const void*, void*);
+   using MoveConstruct_t = void (*)(void*, void*);
+   using DefaultConstruct_t = void (*)(void*);
+   using CopyAssign_t = bool (*)(const void*, void*);
+   using MoveAssign_t = bool (*)(void*, void*);
+   using Destruct_t = void (*)(void*);
 
    //! \brief Copy construct from src into dst using the type at the given index
    static void CopyConstruct(const void* src, void* dst, size_t typeIndex) {
-      if (typeIndex == Idx) {
-         auto& srcObj = *reinterpret_cast<const CurrentType_t*>(src);
-         new (dst) CurrentType_t(srcObj);
-      } else {
-         ConstructHelper<Idx - 1, Args...>::CopyConstruct(src, dst, typeIndex);
-      }
+      // The tables are function-local so that they (and thus the copy/move constructors of all types) are only
+      // instantiated if the corresponding operation is actually used
+      constexpr static CopyConstruct_t Table[] = {&TypeOperations<Args>::CopyConstruct...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      Table[typeIndex](src, dst);
    }
 
    //! \brief Move construct from src into dst using the type at the given index
    static void MoveConstruct(void* src, void* dst, size_t typeIndex) {
-      if (typeIndex == Idx) {
-         auto& srcObj = *reinterpret_cast<CurrentType_t*>(src);
-         new (dst) CurrentType_t(std::move(srcObj));
-      } else {
-         ConstructHelper<Idx - 1, Args...>::MoveConstruct(src, dst, typeIndex);
-      }
+      constexpr static MoveConstruct_t Table[] = {&TypeOperations<Args>::MoveConstruct...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      Table[typeIndex](src, dst);
    }
 
-   //! \brief Destruct the object in mem that has the type with the given index
-   static void Destruct(void* src, size_t typeIndex) {
-      if (typeIndex == Idx) {
-         auto srcObj = *reinterpret_cast<CurrentType_t*>(src);
-         srcObj.~CurrentType_t();
-      } else {
-         ConstructHelper<Idx - 1, Args...>::Destruct(src, typeIndex);
-      }
+   //! \brief Default construct into dst using the type at the given index
+   static void DefaultConstruct(void* dst, size_t typeIndex) {
+      constexpr static DefaultConstruct_t Table[] = {&TypeOperations<Args>::DefaultConstruct...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      Table[typeIndex](dst);
    }
-};
 
-template <typename First, typename... Rest>
-struct ConstructHelper<0, First, Rest...> {
-   static void CopyConstruct(const void* src, void* dst, size_t typeIndex) {
-      MDV_ASSERT(typeIndex == 0);
-      auto& srcObj = *reinterpret_cast<const First*>(src);
-      new (dst) First(srcObj);
+   //! \brief Copy assign src to dst, which both hold the type at the given index
+   //! \returns False if the type can't be assigned safely and dst was left untouched
+   static bool CopyAssign(const void* src, void* dst, size_t typeIndex) {
+      constexpr static CopyAssign_t Table[] = {&TypeOperations<Args>::CopyAssign...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      return Table[typeIndex](src, dst);
    }
 
-   static void MoveConstruct(void* src, void* dst, size_t typeIndex) {
-      MDV_ASSERT(typeIndex == 0);
-      auto& srcObj = *reinterpret_cast<First*>(src);
-      new (dst) First(std::move(srcObj));
+   //! \brief Move assign src to dst, which both hold the type at the given index
+   //! \returns False if the type can't be assigned safely and dst was left untouched
+   static bool MoveAssign(void* src, void* dst, size_t typeIndex) {
+      constexpr static MoveAssign_t Table[] = {&TypeOperations<Args>::MoveAssign...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      return Table[typeIndex](src, dst);
    }
 
+   //! \brief Destruct the object in mem that has the type with the given index
    static void Destruct(void* src, size_t typeIndex) {
-      MDV_ASSERT(typeIndex == 0);
-      auto& srcObj = *reinterpret_cast<First*>(src);
-      srcObj.~First();
+      constexpr static Destruct_t Table[] = {&TypeOperations<Args>::Destruct...};
+      MDV_ASSERT(typeIndex < sizeof...(Args));
+      Table[typeIndex](src);
    }
 };
 
@@ -75,6 +164,12 @@ struct BiggerType {
    using type = std::conditional_t<sizeof(L) >= sizeof(R), L, R>;
 };
 
+//! \brief Metafunction to compare two types by their alignment (alignof)
+template <typename L, typename R>
+struct StricterAlignment {
+   using type = std::conditional_t<alignof(L) >= alignof(R), L, R>;
+};
+
 //! \brief is_copy_constructible using bool_constant instead of a real value
 template <typename T>
 struct CopyConstructible {
@@ -86,126 +181,301 @@ template <typename T>
 struct MoveConstructible {
    using type = std::bool_constant<std::is_move_constructible<T>::value>;
 };
-}
 
+//! \brief is_nothrow_move_constructible using bool_constant instead of a real value
+template <typename T>
+struct NothrowMoveConstructible {
+   using type = std::bool_constant<std::is_nothrow_move_constructible<T>::value>;
+};
+
+//! \brief Is the type trivially copyable and trivially destructible? Objects of such types can be copied with a
+//!        plain memcpy and don't need any destruction
+template <typename T>
+struct TriviallyCopyable {
+   using type = std::bool_constant<std::is_trivially_copyable<T>::value &&
+                                   std::is_trivially_destructible<T>::value>;
+};
+
+// Little explanation what goes on down there: To obtain these results, we fold the complete argument list using
+// logical AND. So if all values of the argument list are true, the result will be true, otherwise it will be false,
+// hence this is a 'AllTypes...' operation. Since our types are types and not expressions that are combinable by
+// using logical AND, we transform them into bool_constants!
+
+//! \brief Folds the given trait over all types using logical AND
+template <template <typename> class Trait, typename... Args>
+using AllTypes_t = meta::Foldl_t<meta::And,
+                                 std::bool_constant<true>,
+                                 meta::Transform_t<Trait, meta::Typelist<Args...>>>;
+
+//! \brief Storage of a variant: A memory block that is large enough and suitably aligned for all types, together
+//!        with the index of the type that is currently stored
 template <typename... Args>
-class Variant {
-public:
-   constexpr static size_t ArgCount = sizeof...(Args);
+class VariantStorage {
+protected:
+   //! \brief Smallest type that can store all type indices plus the invalid index, which is all bits set
+   using Index_t = detail::SizeToType_t<detail::BitsRequired(sizeof...(Args))>;
 
-   using ThisType = Variant<Args...>;
-   using Types = meta::Typelist<Args...>;
-   using ConstructHelper_t = detail::ConstructHelper<ArgCount - 1, Args...>;
+   constexpr static Index_t InvalidIdx = static_cast<Index_t>(-1);
+   constexpr static size_t MaxSize =
+       meta::Sizeof<meta::MaxOf_t<detail::BiggerType, meta::Typelist<Args...>>>::value;
+   constexpr static size_t MaxAlign = alignof(meta::MaxOf_t<detail::StricterAlignment, meta::Typelist<Args...>>);
 
-   // Little explanation what goes on down there: To obtain these results, we fold the complete
-   // argument list
-   // using logical AND. So if all values of the argument list are true, the result will be true,
-   // otherwise it
-   // will be false, hence this is a 'AllTypesSupport...' operation. Since our types are types and
-   // not expressions
-   // that are combinable by using logical AND, we transform them into bool_constants! 
+   VariantStorage() : _index(InvalidIdx) {}
 
-   //! \brief Do all types of this variant support copy construction?
-   using AllTypesSupportCopy =
-       meta::Foldl_t<meta::And,
-                     std::bool_constant<true>,
-                     meta::Transform_t<detail::CopyConstructible, Types>>;
+   alignas(MaxAlign) char _data[MaxSize];
+   Index_t _index;
+};
 
-   //! \brief Do all types of this variant support move construction?
-   using AllTypesSupportMove =
-       meta::Foldl_t<meta::And,
-                     std::bool_constant<true>,
-                     meta::Transform_t<detail::MoveConstructible, Types>>;
+template <bool AllTrivial, typename... Args>
+class VariantBase;
 
-   Variant() : _index(InvalidIdx) {}
+//! \brief Variant base for types that need their copy/move constructors and destructors to be called. These
+//!        are dispatched on the type index at runtime
+template <typename... Args>
+class VariantBase<false, Args...> : public VariantStorage<Args...> {
+protected:
+   using ConstructHelper_t = ConstructHelper<Args...>;
+   using VariantStorage<Args...>::InvalidIdx;
+   using VariantStorage<Args...>::_data;
+   using VariantStorage<Args...>::_index;
 
-   template<typename U = AllTypesSupportCopy>
-   Variant(const ThisType& other, std::enable_if_t<U::value>* = nullptr) {      
+   VariantBase() = default;
+
+   VariantBase(const VariantBase& other) {
       if (other._index != InvalidIdx) {
          ConstructHelper_t::CopyConstruct(other._data, _data, other._index);
       }
       _index = other._index;
    }
 
-   template<typename U = AllTypesSupportMove>
-   Variant(ThisType&& other, std::enable_if_t<U::value>* = nullptr) {
-      if (other._index == InvalidIdx) {
-         _index = InvalidIdx;
-         return;
+   VariantBase(VariantBase&& other) noexcept(AllTypes_t<NothrowMoveConstructible, Args...>::value) {
+      if (other._index != InvalidIdx) {
+         ConstructHelper_t::MoveConstruct(other._data, _data, other._index);
       }
-      ConstructHelper_t::MoveConstruct(other._data, _data, other._index);
       _index = other._index;
-      // We are NOT deleting the other objects value (if it has one). Variant should behave as if it
-      // is the
-      // contained value, so even if we move from it, it still stores a valid instance (if it did so
-      // before).
+      // We are NOT deleting the other objects value (if it has one). Variant should behave as if it is the
+      // contained value, so even if we move from it, it still stores a valid instance (if it did so before).
       // The state of that instance is the usual state of objects after being moved from
    }
 
-   template <typename T, typename Decayed_t = std::decay_t<T>>
-   explicit Variant(T&& val,
-                    std::enable_if_t<!std::is_same<ThisType, std::decay_t<T>>::value>* = nullptr) {
-      static_assert(meta::Contains<Decayed_t, Types>::value,
-                    "This is no valid type for this variant!");
-      new (_data) Decayed_t(std::forward<T>(val));
-      _index = meta::IndexOf<Decayed_t, Types>::value;
-   }
+   ~VariantBase() { DestroyValue(); }
 
-   ~Variant() {
-      if (_index != InvalidIdx) {
-         ConstructHelper_t::Destruct(_data, _index);
+   //! \brief If both variants hold the same type, its assignment operator is used, so that the stored value can
+   //!        reuse its resources (e.g. the buffer of a string). Otherwise the value is replaced
+   VariantBase& operator=(const VariantBase& other) {
+      if (this == &other) {
+         return *this;
       }
-   }
-
-   template<typename U = AllTypesSupportCopy>
-   std::enable_if_t<U::value, Variant&> operator=(const ThisType& other) {      
-      auto thisValid = _index != InvalidIdx;
-      auto otherValid = other._index != InvalidIdx;
-      if (thisValid) {
-         ConstructHelper_t::Destruct(_data, _index);
+      if (_index == other._index && _index != InvalidIdx &&
+          ConstructHelper_t::CopyAssign(other._data, _data, _index)) {
+         return *this;
       }
-      if (otherValid) {
+      DestroyValue();
+      _index = InvalidIdx;
+      if (other._index != InvalidIdx) {
          ConstructHelper_t::CopyConstruct(other._data, _data, other._index);
-         _index = other._index;
-      } else {
-         _index = InvalidIdx;
       }
+      _index = other._index;
       return *this;
    }
 
-   template<typename U = AllTypesSupportMove>
-   std::enable_if_t<U::value, Variant&> operator=(ThisType&& other) {      
-      auto thisValid = _index != InvalidIdx;
-      auto otherValid = other._index != InvalidIdx;
-      if (thisValid) {
-         ConstructHelper_t::Destruct(_data, _index);
+   VariantBase& operator=(VariantBase&& other) {
+      if (this == &other) {
+         return *this;
       }
-      if (otherValid) {
+      if (_index == other._index && _index != InvalidIdx &&
+          ConstructHelper_t::MoveAssign(other._data, _data, _index)) {
+         return *this;
+      }
+      DestroyValue();
+      _index = InvalidIdx;
+      if (other._index != InvalidIdx) {
          ConstructHelper_t::MoveConstruct(other._data, _data, other._index);
-         _index = other._index;
-         // See comment in move constructor!
-      } else {
-         _index = InvalidIdx;
       }
+      // See comment in move constructor!
+      _index = other._index;
       return *this;
    }
 
+   //! \brief Destroys the stored value, if there is one. Does not reset the index
+   void DestroyValue() {
+      if (_index != InvalidIdx) {
+         ConstructHelper_t::Destruct(_data, _index);
+      }
+   }
+};
+
+//! \brief Variant base for types that are all trivially copyable and destructible. Copy, move and destruction
+//!        don't dispatch at all, they are a plain copy of the storage and the index, which makes the variant
+//!        itself trivially copyable
+template <typename... Args>
+class VariantBase<true, Args...> : public VariantStorage<Args...> {
+protected:
+   VariantBase() = default;
+
+   void DestroyValue() {}
+};
+
+//! \brief Deletes the copy and/or move operations of a variant if not all types support them. If moving is not
+//!        supported, the defaulted move operations of the variant are deleted and thus ignored by overload
+//!        resolution, so moving falls back to copying
+template <bool Copy, bool Move>
+struct EnableCopyMove {};
+
+template <>
+struct EnableCopyMove<false, true> {
+   EnableCopyMove() = default;
+   EnableCopyMove(const EnableCopyMove&) = delete;
+   EnableCopyMove(EnableCopyMove&&) = default;
+   EnableCopyMove& operator=(const EnableCopyMove&) = delete;
+   EnableCopyMove& operator=(EnableCopyMove&&) = default;
+};
+
+template <>
+struct EnableCopyMove<true, false> {
+   EnableCopyMove() = default;
+   EnableCopyMove(const EnableCopyMove&) = default;
+   EnableCopyMove(EnableCopyMove&&) = delete;
+   EnableCopyMove& operator=(const EnableCopyMove&) = default;
+   EnableCopyMove& operator=(EnableCopyMove&&) = delete;
+};
+
+template <>
+struct EnableCopyMove<false, false> {
+   EnableCopyMove() = default;
+   EnableCopyMove(const EnableCopyMove&) = delete;
+   EnableCopyMove(EnableCopyMove&&) = delete;
+   EnableCopyMove& operator=(const EnableCopyMove&) = delete;
+   EnableCopyMove& operator=(EnableCopyMove&&) = delete;
+};
+
+struct VariantAccess;
+
+//! \brief Are all of the given variants holding a value?
+inline bool AllHaveValues() { return true; }
+
+template <typename First, typename... Rest>
+bool AllHaveValues(const First& first, const Rest&... rest) {
+   return first.HasValue() && AllHaveValues(rest...);
+}
+}
+
+//! \brief Combines a set of function objects into one function object that has all their call operators
+template <typename... Funcs>
+struct Overloaded;
+
+template <typename Func>
+struct Overloaded<Func> : Func {
+   using Func::operator();
+
+   explicit Overloaded(Func func) : Func(std::move(func)) {}
+};
+
+template <typename First, typename... Rest>
+struct Overloaded<First, Rest...> : First, Overloaded<Rest...> {
+   using First::operator();
+   using Overloaded<Rest...>::operator();
+
+   explicit Overloaded(First first, Rest... rest)
+       : First(std::move(first)), Overloaded<Rest...>(std::move(rest)...) {}
+};
+
+//! \brief Creates an Overloaded function object from the given function objects
+template <typename... Funcs>
+Overloaded<std::decay_t<Funcs>...> MakeOverloaded(Funcs&&... funcs) {
+   return Overloaded<std::decay_t<Funcs>...>(std::forward<Funcs>(funcs)...);
+}
+
+template <typename Visitor, typename... Variants>
+decltype(auto) Visit(Visitor&& visitor, Variants&&... variants);
+
+//! \brief Tag type that selects the in-place constructor of Variant for the type T
+template <typename T>
+struct InPlaceType {};
+
+namespace detail {
+template <typename T>
+struct IsInPlaceType : std::false_type {};
+
+template <typename T>
+struct IsInPlaceType<InPlaceType<T>> : std::true_type {};
+}
+
+template <typename... Args>
+class Variant : private detail::VariantBase<detail::AllTypes_t<detail::TriviallyCopyable, Args...>::value, Args...>,
+                private detail::EnableCopyMove<detail::AllTypes_t<detail::CopyConstructible, Args...>::value,
+                                               detail::AllTypes_t<detail::MoveConstructible, Args...>::value> {
+public:
+   constexpr static size_t ArgCount = sizeof...(Args);
+
+   using ThisType = Variant<Args...>;
+   using Types = meta::Typelist<Args...>;
+   using ConstructHelper_t = detail::ConstructHelper<Args...>;
+
+   //! \brief Do all types of this variant support copy construction?
+   using AllTypesSupportCopy = detail::AllTypes_t<detail::CopyConstructible, Args...>;
+
+   //! \brief Do all types of this variant support move construction?
+   using AllTypesSupportMove = detail::AllTypes_t<detail::MoveConstructible, Args...>;
+
+   //! \brief Are all types of this variant trivially copyable and destructible? If so, the variant itself is
+   //!        trivially copyable
+   using AllTypesTrivial = detail::AllTypes_t<detail::TriviallyCopyable, Args...>;
+
+   Variant() = default;
+
+   template <typename T, typename Decayed_t = std::decay_t<T>>
+   explicit Variant(T&& val,
+                    std::enable_if_t<!std::is_same<ThisType, Decayed_t>::value &&
+                                     !detail::IsInPlaceType<Decayed_t>::value>* = nullptr) {
+      static_assert(meta::Contains<Decayed_t, Types>::value,
+                    "This is no valid type for this variant!");
+      new (_data) Decayed_t(std::forward<T>(val));
+      _index = meta::IndexOf<Decayed_t, Types>::value;
+   }
+
+   //! \brief Constructs an object of type T directly inside this variant, without creating a temporary
+   //! \param args Arguments that are passed to the constructor of T
+   template <typename T, typename... CtorArgs>
+   explicit Variant(InPlaceType<T>, CtorArgs&&... args) {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      new (_data) T(std::forward<CtorArgs>(args)...);
+      _index = meta::IndexOf<T, Types>::value;
+   }
+
+   //! \brief Assigns the value to the stored value if that has the same type, otherwise replaces the stored value.
+   //!        If the constructor throws, the variant is left empty
    template <typename T, typename Decayed_t = std::decay_t<T>>
    std::enable_if_t<!std::is_same<ThisType, Decayed_t>::value, Variant&> operator=(T&& val) {
       static_assert(meta::Contains<Decayed_t, Types>::value,
                     "This is no valid type for this variant!");
-      if (_index != InvalidIdx) {
-         ConstructHelper_t::Destruct(_data, _index);
+      if (_index == meta::IndexOf<Decayed_t, Types>::value &&
+          AssignValue(std::forward<T>(val), std::is_assignable<Decayed_t&, T&&>())) {
+         return *this;
       }
+      this->DestroyValue();
+      _index = InvalidIdx;
       new (_data) Decayed_t(std::forward<T>(val));
       _index = meta::IndexOf<Decayed_t, Types>::value;
       return *this;
    }
 
+   //! \brief Destroys the current value and constructs an object of type T directly inside this variant, without
+   //!        creating a temporary. If the constructor of T throws, the variant is left empty
+   //! \param args Arguments that are passed to the constructor of T
+   //! \returns Reference to the new object
+   template <typename T, typename... CtorArgs>
+   T& Emplace(CtorArgs&&... args) {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      this->DestroyValue();
+      _index = InvalidIdx;
+      auto obj = new (_data) T(std::forward<CtorArgs>(args)...);
+      _index = meta::IndexOf<T, Types>::value;
+      return *obj;
+   }
+
    void Clear() {
-      if (_index == InvalidIdx)
-         return;
-      detail::ConstructHelper<ArgCount - 1, Args...>::Destruct(_data, _index);
+      this->DestroyValue();
       _index = InvalidIdx;
    }
 
@@ -217,31 +487,118 @@ public:
       return meta::IndexOf<T, Types>::value == _index;
    }
 
+   //! \brief Calls the matching function out of the given set of functions (typically lambdas) with the value that
+   //!        is currently stored in this variant. Overload resolution selects the function, so each type must be
+   //!        handled by exactly one function. The variant must have a value!
+   template <typename... Funcs>
+   decltype(auto) Match(Funcs&&... funcs) {
+      return Visit(MakeOverloaded(std::forward<Funcs>(funcs)...), *this);
+   }
+
+   template <typename... Funcs>
+   decltype(auto) Match(Funcs&&... funcs) const {
+      return Visit(MakeOverloaded(std::forward<Funcs>(funcs)...), *this);
+   }
+
+   //! \brief Access the value as type T
+   //! \throws BadVariantAccess if the variant does not store a value of type T
    template <typename T>
    T& Get() {
       static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
-      if (!Is<T>())
-         throw std::exception(
-             "Trying to get data of a type from a variant that does not store "
-             "this type currently!");
+      if (MDV_UNLIKELY(!Is<T>()))
+         detail::ThrowBadVariantAccess();
       return *reinterpret_cast<T*>(_data);
    }
 
    template <typename T>
    const T& Get() const {
       static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
-      if (!Is<T>())
-         throw std::exception(
-             "Trying to get data of a type from a variant that does not store "
-             "this type currently!");
+      if (MDV_UNLIKELY(!Is<T>()))
+         detail::ThrowBadVariantAccess();
+      return *reinterpret_cast<const T*>(_data);
+   }
+
+   //! \brief Access the value as type T without any checks. Only debug builds assert that the variant stores a
+   //!        value of type T
+   template <typename T>
+   T& UncheckedGet() {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      MDV_ASSERT(Is<T>());
+      return *reinterpret_cast<T*>(_data);
+   }
+
+   template <typename T>
+   const T& UncheckedGet() const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      MDV_ASSERT(Is<T>());
       return *reinterpret_cast<const T*>(_data);
    }
 
+   //! \brief Pointer to the value if the variant stores a value of type T, nullptr otherwise
+   template <typename T>
+   T* GetIf() noexcept {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return Is<T>() ? reinterpret_cast<T*>(_data) : nullptr;
+   }
+
+   template <typename T>
+   const T* GetIf() const noexcept {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return Is<T>() ? reinterpret_cast<const T*>(_data) : nullptr;
+   }
+
+   //! \brief Like GetIf, but for call sites that expect the variant to store a T almost always. The check is
+   //!        annotated as likely, so the compiler lays out the code for the common case
+   template <typename T>
+   T* GetIfLikely() noexcept {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return MDV_LIKELY(Is<T>()) ? reinterpret_cast<T*>(_data) : nullptr;
+   }
+
+   template <typename T>
+   const T* GetIfLikely() const noexcept {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      return MDV_LIKELY(Is<T>()) ? reinterpret_cast<const T*>(_data) : nullptr;
+   }
+
+   //! \brief Copies the value into 'out' if the variant stores a value of type T
+   //! \returns True if the value was copied
+   template <typename T>
+   bool TryGet(T& out) const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this variant!");
+      if (!Is<T>())
+         return false;
+      out = *reinterpret_cast<const T*>(_data);
+      return true;
+   }
+
 private:
-   constexpr static size_t InvalidIdx = static_cast<size_t>(-1);
-   constexpr static size_t MaxSize = meta::Sizeof<meta::MaxOf_t<detail::BiggerType, Types>>::value;
-   char _data[MaxSize];
-   size_t _index;
+   friend struct detail::VariantAccess;
+
+   using Base_t = detail::VariantBase<AllTypesTrivial::value, Args...>;
+   using Base_t::InvalidIdx;
+   using Base_t::_data;
+   using Base_t::_index;
+
+   template <typename T>
+   bool AssignValue(T&& val, std::true_type) {
+      *reinterpret_cast<std::decay_t<T>*>(_data) = std::forward<T>(val);
+      return true;
+   }
+
+   template <typename T>
+   bool AssignValue(T&&, std::false_type) {
+      return false;
+   }
+
+   //! \brief Destroys the current value and default constructs the type at the given index. If the constructor
+   //!        throws, the variant is left empty
+   void EmplaceDefault(size_t typeIndex) {
+      this->DestroyValue();
+      _index = InvalidIdx;
+      ConstructHelper_t::DefaultConstruct(_data, typeIndex);
+      _index = static_cast<decltype(_index)>(typeIndex);
+   }
 };
 
 template <>
@@ -268,4 +625,113 @@ public:
       return false;
    }
 };
+namespace detail {
+
+//! \brief Grants the visitation machinery access to the internals of Variant
+struct VariantAccess {
+   template <typename... Args>
+   static size_t Index(const Variant<Args...>& variant) {
+      return variant._index;
+   }
+
+   //! \brief Default constructs the type at the given runtime index inside the variant
+   template <typename... Args>
+   static void EmplaceDefault(Variant<Args...>& variant, size_t typeIndex) {
+      variant.EmplaceDefault(typeIndex);
+   }
+
+   //! \brief Returns the value at the given type index, keeping the value category of the variant
+   template <size_t Idx, typename... Args>
+   static meta::At_t<Idx, meta::Typelist<Args...>>& Get(Variant<Args...>& variant) {
+      return *reinterpret_cast<meta::At_t<Idx, meta::Typelist<Args...>>*>(variant._data);
+   }
+
+   template <size_t Idx, typename... Args>
+   static const meta::At_t<Idx, meta::Typelist<Args...>>& Get(const Variant<Args...>& variant) {
+      return *reinterpret_cast<const meta::At_t<Idx, meta::Typelist<Args...>>*>(variant._data);
+   }
+
+   template <size_t Idx, typename... Args>
+   static meta::At_t<Idx, meta::Typelist<Args...>>&& Get(Variant<Args...>&& variant) {
+      return std::move(*reinterpret_cast<meta::At_t<Idx, meta::Typelist<Args...>>*>(variant._data));
+   }
+};
+
+//! \brief Product of all given numbers
+constexpr size_t Product() { return 1; }
+
+template <typename... Rest>
+constexpr size_t Product(size_t first, Rest... rest) {
+   return first * Product(rest...);
+}
+
+//! \brief Product of all counts after the given position. This is the stride of the position inside the
+//!        flattened visitation table
+constexpr size_t Stride(size_t) { return 1; }
+
+template <typename... Rest>
+constexpr size_t Stride(size_t position, size_t /*first*/, Rest... rest) {
+   return position == 0 ? Product(rest...) : Stride(position - 1, rest...);
+}
+
+template <typename Visitor, typename Positions, typename... Variants>
+struct VisitDispatcher;
+
+//! \brief Dispatches a visitor on any number of variants. All combinations of the alternatives of the variants
+//!        are flattened into one table of function pointers (row-major, the first variant has the largest
+//!        stride), so a visitation is one index computation and one indirect call
+template <typename Visitor, size_t... Positions, typename... Variants>
+struct VisitDispatcher<Visitor, std::index_sequence<Positions...>, Variants...> {
+   using Counts = meta::Numberlist<std::decay_t<Variants>::ArgCount...>;
+
+   //! \brief Type index of the variant at Position for the given index into the flattened table
+   template <size_t Flat, size_t Position>
+   using TypeIndex = std::integral_constant<
+       size_t,
+       (Flat / Stride(Position, std::decay_t<Variants>::ArgCount...)) % meta::At<Position, Counts>::value>;
+
+   //! \brief The visitor has to return the same type (or at least something convertible to it) for all
+   //!        combinations, we use the type for the first alternative of each variant
+   using Return_t = decltype(std::declval<Visitor>()(VariantAccess::Get<0>(std::declval<Variants>())...));
+   using Func_t = Return_t (*)(Visitor&&, Variants&&...);
+
+   template <size_t Flat>
+   static Return_t Invoke(Visitor&& visitor, Variants&&... variants) {
+      return std::forward<Visitor>(visitor)(
+          VariantAccess::Get<TypeIndex<Flat, Positions>::value>(std::forward<Variants>(variants))...);
+   }
+
+   template <size_t... Flat>
+   static Return_t Dispatch(std::index_sequence<Flat...>, Visitor&& visitor, Variants&&... variants) {
+      constexpr static Func_t Table[] = {&Invoke<Flat>...};
+
+      size_t flatIndex = 0;
+      using swallow = int[];
+      (void)swallow{0,
+                    ((void)(flatIndex = flatIndex * std::decay_t<Variants>::ArgCount +
+                                        VariantAccess::Index(variants)),
+                     0)...};
+      MDV_ASSERT(flatIndex < sizeof...(Flat));
+
+      return Table[flatIndex](std::forward<Visitor>(visitor), std::forward<Variants>(variants)...);
+   }
+};
+}
+
+//! \brief Calls the visitor with the values that are currently stored in the given variants. The matching call
+//!        is selected with a single lookup into a table that is generated at compile time, so there are no
+//!        type checks at runtime. All variants must have a value!
+template <typename Visitor, typename... Variants>
+decltype(auto) Visit(Visitor&& visitor, Variants&&... variants) {
+   static_assert(sizeof...(Variants) > 0, "Visit requires at least one variant!");
+   using Dispatcher_t = detail::VisitDispatcher<Visitor,
+                                                std::index_sequence_for<Variants...>,
+                                                Variants...>;
+
+   MDV_ASSERT(detail::AllHaveValues(variants...));
+   return Dispatcher_t::Dispatch(
+       std::make_index_sequence<detail::Product(std::decay_t<Variants>::ArgCount...)>(),
+       std::forward<Visitor>(visitor),
+       std::forward<Variants>(variants)...);
+}
 }
\ No newline at end of file
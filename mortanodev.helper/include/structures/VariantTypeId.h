@@ -0,0 +1,47 @@
+#pragma once
+#include "..\meta\TypeRegistry.h"
+#include "..\error_handling\Assert.h"
+#include "Variant.h"
+
+#include <stdint.h>
+
+namespace mdv {
+
+//! \brief Serialization support for Variant through the type IDs of TypeRegistry. This is kept out of Variant.h,
+//!        so that only the users of type IDs pay for the registry and the registered names. All types of the
+//!        variant need a registered name, see MDV_TYPE_NAME
+
+//! \brief The TypeRegistry for the types of the given variant
+template <typename Variant_t>
+using VariantTypeRegistry_t = TypeRegistry<typename Variant_t::Types>;
+
+//! \brief Index of the type with the given type ID in the types of the variant, or
+//!        VariantTypeRegistry_t<Variant_t>::NotFound. This is a lookup in a perfect hash table, not a linear search
+template <typename Variant_t>
+size_t IndexOfTypeId(uint64_t typeId) {
+   return VariantTypeRegistry_t<Variant_t>::IndexOf(typeId);
+}
+
+//! \brief Type ID of the stored value, e.g. to write it as the type tag when serializing. The variant must have a
+//!        value!
+template <typename... Args>
+uint64_t ActiveTypeId(const Variant<Args...>& variant) {
+   MDV_ASSERT(variant.HasValue());
+   return VariantTypeRegistry_t<Variant<Args...>>::IdAt(detail::VariantAccess::Index(variant));
+}
+
+//! \brief Destroys the current value and default constructs the type with the given type ID inside the variant.
+//!        This is the counterpart to ActiveTypeId when deserializing: read the type tag, emplace the type and then
+//!        read the value into it. If no type has this ID or the constructor throws, the variant is left empty
+//! \returns True if the type ID belongs to one of the types of the variant
+template <typename... Args>
+bool EmplaceTypeId(Variant<Args...>& variant, uint64_t typeId) {
+   const auto typeIndex = IndexOfTypeId<Variant<Args...>>(typeId);
+   if (typeIndex == VariantTypeRegistry_t<Variant<Args...>>::NotFound) {
+      variant.Clear();
+      return false;
+   }
+   detail::VariantAccess::EmplaceDefault(variant, typeIndex);
+   return true;
+}
+}
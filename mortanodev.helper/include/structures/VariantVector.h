@@ -0,0 +1,301 @@
+#pragma once
+#include "..\meta\Meta.h"
+#include "..\error_handling\Assert.h"
+#include "..\util\VectorStorage.h"
+#include "Bitmask.h"
+#include "BitmaskArrayColumns.h"
+#include "Variant.h"
+
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdv {
+
+//! \brief Container for a large number of values of which each has one of the types Args. In contrast to
+//!        std::vector<Variant<Args...>>, each element only takes the size of its actual type: All values of the
+//!        same type are stored in a contiguous pool of their own, and the type of each element is stored in a
+//!        densely packed discriminator array that uses only as many bits per element as required for the type
+//!        index. Iterating over all values of a single type only touches the pool of that type.
+//!
+//! Elements can only be appended. The order of the elements is kept for random access, iterating over all elements
+//! walks the pools one after another and thus does not preserve the order. bool values are stored in a byte each,
+//! so that references to them can be handed out
+template <typename... Args>
+class VariantVector {
+public:
+   constexpr static size_t ArgCount = sizeof...(Args);
+
+   using ThisType = VariantVector<Args...>;
+   using Types = meta::Typelist<Args...>;
+   using Variant_t = Variant<Args...>;
+
+   static_assert(ArgCount > 0, "VariantVector requires at least one type!");
+
+   VariantVector() : _size(0) {}
+
+   //! \brief Number of elements
+   size_t Size() const { return _size; }
+
+   bool Empty() const { return _size == 0; }
+
+   //! \brief Number of elements of type T
+   template <typename T>
+   size_t Count() const {
+      return Pool<T>().size();
+   }
+
+   //! \brief Index of the type of the element at the given index
+   size_t TypeIndexAt(size_t index) const {
+      MDV_ASSERT(index < _size);
+      const auto word = _discriminators[index / PerWord];
+      return static_cast<size_t>((word >> ((index % PerWord) * DiscriminatorBits)) & DiscriminatorMask);
+   }
+
+   //! \brief Is the element at the given index of type T?
+   template <typename T>
+   bool Is(size_t index) const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this VariantVector!");
+      return TypeIndexAt(index) == meta::IndexOf<T, Types>::value;
+   }
+
+   //! \brief Appends a value at the end
+   template <typename T, typename Decayed_t = std::decay_t<T>>
+   std::enable_if_t<!std::is_same<Decayed_t, Variant_t>::value> PushBack(T&& value) {
+      static_assert(meta::Contains<Decayed_t, Types>::value, "This is no valid type for this VariantVector!");
+      auto& pool = Pool<Decayed_t>();
+      pool.push_back(std::forward<T>(value));
+      AppendDiscriminator(pool, meta::IndexOf<Decayed_t, Types>::value);
+   }
+
+   //! \brief Appends the value of the given variant at the end. The variant must have a value!
+   void PushBack(const Variant_t& variant) {
+      mdv::Visit([this](const auto& value) { PushBack(value); }, variant);
+   }
+
+   //! \brief Constructs a value of type T in place at the end
+   //! \returns Reference to the new value
+   template <typename T, typename... CtorArgs>
+   T& Emplace(CtorArgs&&... args) {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this VariantVector!");
+      auto& pool = Pool<T>();
+      pool.emplace_back(std::forward<CtorArgs>(args)...);
+      AppendDiscriminator(pool, meta::IndexOf<T, Types>::value);
+      return ValueAt<T>(pool, pool.size() - 1);
+   }
+
+   //! \brief Access the element at the given index, which has to be of type T
+   template <typename T>
+   T& Get(size_t index) {
+      if (MDV_UNLIKELY(!Is<T>(index)))
+         detail::ThrowBadVariantAccess();
+      return ValueAt<T>(Pool<T>(), SlotOf(index, meta::IndexOf<T, Types>::value));
+   }
+
+   template <typename T>
+   const T& Get(size_t index) const {
+      if (MDV_UNLIKELY(!Is<T>(index)))
+         detail::ThrowBadVariantAccess();
+      return ValueAt<T>(Pool<T>(), SlotOf(index, meta::IndexOf<T, Types>::value));
+   }
+
+   //! \brief Calls the visitor with the element at the given index
+   template <typename Visitor>
+   decltype(auto) Visit(size_t index, Visitor&& visitor) {
+      return VisitAt(*this, index, std::forward<Visitor>(visitor));
+   }
+
+   template <typename Visitor>
+   decltype(auto) Visit(size_t index, Visitor&& visitor) const {
+      return VisitAt(*this, index, std::forward<Visitor>(visitor));
+   }
+
+   //! \brief Calls func for every value of type T. This only touches the contiguous pool of type T
+   template <typename T, typename Func>
+   void ForEach(Func&& func) {
+      auto& pool = Pool<T>();
+      for (size_t slot = 0; slot < pool.size(); ++slot) {
+         func(ValueAt<T>(pool, slot));
+      }
+   }
+
+   template <typename T, typename Func>
+   void ForEach(Func&& func) const {
+      const auto& pool = Pool<T>();
+      for (size_t slot = 0; slot < pool.size(); ++slot) {
+         func(ValueAt<T>(pool, slot));
+      }
+   }
+
+   //! \brief Calls func for every element, walking all pools one after another. func has to accept all types
+   template <typename Func>
+   void ForEachAll(Func&& func) {
+      using swallow = int[];
+      (void)swallow{0, ((void)ForEach<Args>(func), 0)...};
+   }
+
+   template <typename Func>
+   void ForEachAll(Func&& func) const {
+      using swallow = int[];
+      (void)swallow{0, ((void)ForEach<Args>(func), 0)...};
+   }
+
+   //! \brief The contiguous values of type T, Count<T>() many. The pointer stays valid until a value of type T is
+   //!        added. The pool can't be modified from outside, as that would break the discriminators
+   template <typename T>
+   const T* PoolData() const {
+      return detail::VectorStorage<T>::Data(Pool<T>().data());
+   }
+
+   //! \brief Bytes taken by the values, the discriminators and the per-block counts for random access, without
+   //!        unused capacity
+   size_t MemoryFootprint() const {
+      size_t bytes = _discriminators.size() * sizeof(uint64_t) + _blockCounts.size() * sizeof(size_t);
+      using swallow = int[];
+      (void)swallow{0, ((void)(bytes += Pool<Args>().size() * sizeof(detail::VectorStorage_t<Args>)), 0)...};
+      return bytes;
+   }
+
+   //! \brief Reserves memory for the given number of elements of type T
+   template <typename T>
+   void Reserve(size_t count) {
+      Pool<T>().reserve(count);
+   }
+
+   void Clear() {
+      using swallow = int[];
+      (void)swallow{0, ((void)Pool<Args>().clear(), 0)...};
+      _discriminators.clear();
+      _blockCounts.clear();
+      _size = 0;
+   }
+
+private:
+   //! \brief Discriminators are packed into 64-bit words. No discriminator crosses a word boundary, so reading one
+   //!        is a single shift and mask
+   constexpr static size_t DiscriminatorBits = ArgCount > 1 ? detail::BitsRequired(ArgCount - 1) : 1;
+   constexpr static size_t PerWord = 64 / DiscriminatorBits;
+   constexpr static uint64_t DiscriminatorMask = detail::Mask<DiscriminatorBits>::value;
+
+   //! \brief For random access, the number of elements of each type before every block of BlockSize elements is
+   //!        stored. The position of an element inside its pool is this count plus the elements of the same type
+   //!        between the start of the block and the element. A block consists of whole discriminator words, about
+   //!        64 elements, so that the elements before the element are counted a word at a time
+   constexpr static size_t WordsPerBlock = DiscriminatorBits;
+   constexpr static size_t BlockSize = PerWord * WordsPerBlock;
+
+   //! \brief Lowest and highest bit of every discriminator in a word
+   constexpr static uint64_t FieldOnes = detail::columns::Repeat(1, DiscriminatorBits, PerWord);
+   constexpr static uint64_t FieldHighBits = FieldOnes << (DiscriminatorBits - 1);
+   constexpr static uint64_t FieldLowBits = (FieldOnes * DiscriminatorMask) & ~FieldHighBits;
+
+   //! \brief The contiguous pool holding all values of type T
+   template <typename T>
+   std::vector<detail::VectorStorage_t<T>>& Pool() {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this VariantVector!");
+      return std::get<meta::IndexOf<T, Types>::value>(_pools);
+   }
+
+   template <typename T>
+   const std::vector<detail::VectorStorage_t<T>>& Pool() const {
+      static_assert(meta::Contains<T, Types>::value, "This is no valid type for this VariantVector!");
+      return std::get<meta::IndexOf<T, Types>::value>(_pools);
+   }
+
+   //! \brief Appends the discriminator of the element that was just added to the given pool. If this throws, the
+   //!        element is removed from the pool again, so that the pools and the discriminators stay in sync
+   template <typename Pool_t>
+   void AppendDiscriminator(Pool_t& pool, size_t typeIndex) {
+      const auto blockCountsSize = _blockCounts.size();
+      try {
+         if (_size % BlockSize == 0) {
+            using swallow = int[];
+            (void)swallow{0, ((void)_blockCounts.push_back(Pool<Args>().size()), 0)...};
+         }
+         if (_size % PerWord == 0) {
+            _discriminators.push_back(0);
+         }
+      } catch (...) {
+         _blockCounts.resize(blockCountsSize);
+         pool.pop_back();
+         throw;
+      }
+      if (_size % BlockSize == 0) {
+         // The element was already added to its pool
+         --_blockCounts[_blockCounts.size() - ArgCount + typeIndex];
+      }
+      _discriminators.back() |= static_cast<uint64_t>(typeIndex) << ((_size % PerWord) * DiscriminatorBits);
+      ++_size;
+   }
+
+   template <typename T>
+   static T& ValueAt(std::vector<detail::VectorStorage_t<T>>& pool, size_t slot) {
+      return detail::VectorStorage<T>::Data(pool.data())[slot];
+   }
+
+   template <typename T>
+   static const T& ValueAt(const std::vector<detail::VectorStorage_t<T>>& pool, size_t slot) {
+      return detail::VectorStorage<T>::Data(pool.data())[slot];
+   }
+
+   //! \brief Position of the element at the given index inside the pool of its type. The elements of the same type
+   //!        in front of it are counted with at most WordsPerBlock popcounts, so this takes constant time
+   size_t SlotOf(size_t index, size_t typeIndex) const {
+      const auto block = index / BlockSize;
+      const auto lastWord = index / PerWord;
+      const auto pattern = FieldOnes * typeIndex;
+      auto slot = _blockCounts[block * ArgCount + typeIndex];
+      for (auto word = block * WordsPerBlock; word < lastWord; ++word) {
+         slot += detail::columns::PopCount(MatchingFields(_discriminators[word] ^ pattern));
+      }
+      // Only the discriminators in front of the element count in its own word
+      const auto before = (uint64_t(1) << ((index % PerWord) * DiscriminatorBits)) - 1;
+      return slot + detail::columns::PopCount(MatchingFields(_discriminators[lastWord] ^ pattern) & before);
+   }
+
+   //! \brief Sets the highest bit of every discriminator that is zero, see ZeroFields for BitmaskArray
+   static uint64_t MatchingFields(uint64_t word) {
+      const auto nonZero = (((word & FieldLowBits) + FieldLowBits) | word) & FieldHighBits;
+      return ~nonZero & FieldHighBits;
+   }
+
+   template <typename Self, typename Visitor>
+   static decltype(auto) VisitAt(Self& self, size_t index, Visitor&& visitor) {
+      using Dispatcher_t = VisitDispatcher<Self, Visitor, std::index_sequence_for<Args...>>;
+      const auto typeIndex = self.TypeIndexAt(index);
+      return Dispatcher_t::Dispatch(self, typeIndex, self.SlotOf(index, typeIndex), std::forward<Visitor>(visitor));
+   }
+
+   template <typename Self, typename Visitor, typename Indices>
+   struct VisitDispatcher;
+
+   //! \brief Dispatches a visitor on the type index with a table of function pointers, just like Visit does
+   //!        for Variant
+   template <typename Self, typename Visitor, size_t... Indices>
+   struct VisitDispatcher<Self, Visitor, std::index_sequence<Indices...>> {
+      template <size_t Idx>
+      using Value_t = std::conditional_t<std::is_const<Self>::value, const meta::At_t<Idx, Types>,
+                                         meta::At_t<Idx, Types>>;
+
+      using Return_t = decltype(std::declval<Visitor>()(std::declval<Value_t<0>&>()));
+      using Func_t = Return_t (*)(Self&, size_t, Visitor&&);
+
+      template <size_t Idx>
+      static Return_t Invoke(Self& self, size_t slot, Visitor&& visitor) {
+         return std::forward<Visitor>(visitor)(ValueAt<meta::At_t<Idx, Types>>(std::get<Idx>(self._pools), slot));
+      }
+
+      static Return_t Dispatch(Self& self, size_t typeIndex, size_t slot, Visitor&& visitor) {
+         constexpr static Func_t Table[] = {&Invoke<Indices>...};
+         return Table[typeIndex](self, slot, std::forward<Visitor>(visitor));
+      }
+   };
+
+   std::tuple<std::vector<detail::VectorStorage_t<Args>>...> _pools;
+   std::vector<uint64_t> _discriminators;
+   std::vector<size_t> _blockCounts;
+   size_t _size;
+};
+}
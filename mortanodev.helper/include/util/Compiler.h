@@ -0,0 +1,43 @@
+#pragma once
+
+//! \brief Compiler specific hints. All of them expand to nothing (or the plain expression) on compilers that don't
+//!        support them
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MDV_LIKELY(cond) __builtin_expect(!!(cond), 1)
+#define MDV_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#define MDV_NOINLINE __attribute__((noinline))
+#define MDV_NORETURN __attribute__((noreturn))
+#elif defined(_MSC_VER)
+#define MDV_LIKELY(cond) (cond)
+#define MDV_UNLIKELY(cond) (cond)
+#define MDV_NOINLINE __declspec(noinline)
+#define MDV_NORETURN __declspec(noreturn)
+#else
+#define MDV_LIKELY(cond) (cond)
+#define MDV_UNLIKELY(cond) (cond)
+#define MDV_NOINLINE
+#define MDV_NORETURN
+#endif
+
+//! \brief Target architecture. SIMD code paths are only compiled for x86 and x64
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MDV_X86
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MDV_X64
+#endif
+
+//! \brief Enables instruction set extensions for a single function, so that it can use the corresponding intrinsics
+//!        without compiling the whole translation unit for that instruction set. Such functions may only be called
+//!        after checking the CPU features at runtime. MSVC allows all intrinsics everywhere and needs no attribute
+#if defined(__GNUC__) || defined(__clang__)
+#define MDV_TARGET_SSE2 __attribute__((target("sse2")))
+#define MDV_TARGET_AVX2 __attribute__((target("avx2")))
+#define MDV_TARGET_BMI2 __attribute__((target("bmi2")))
+#else
+#define MDV_TARGET_SSE2
+#define MDV_TARGET_AVX2
+#define MDV_TARGET_BMI2
+#endif
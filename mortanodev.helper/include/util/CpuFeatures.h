@@ -0,0 +1,61 @@
+#pragma once
+#include "Compiler.h"
+
+#if defined(MDV_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mdv
+{
+
+   //! \brief Instruction set extensions that are supported by the CPU (and the operating system) at runtime
+   struct CpuFeatures
+   {
+      bool sse2;
+      bool avx2;
+      bool bmi2;
+   };
+
+   namespace detail
+   {
+
+      inline CpuFeatures DetectCpuFeatures()
+      {
+         CpuFeatures features = { false, false, false };
+#if defined(MDV_X86) && defined(_MSC_VER)
+         int info[4];
+         __cpuid(info, 0);
+         const auto maxLeaf = info[0];
+
+         __cpuid(info, 1);
+         features.sse2 = (info[3] & (1 << 26)) != 0;
+         //AVX registers are only usable if the operating system saves them on context switches
+         const auto osxsave = (info[2] & (1 << 27)) != 0;
+         const auto avx = (info[2] & (1 << 28)) != 0;
+         const auto ymmEnabled = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+
+         if (maxLeaf >= 7)
+         {
+            __cpuidex(info, 7, 0);
+            features.avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+            features.bmi2 = (info[1] & (1 << 8)) != 0;
+         }
+#elif defined(MDV_X86) && (defined(__GNUC__) || defined(__clang__))
+         __builtin_cpu_init();
+         features.sse2 = __builtin_cpu_supports("sse2") != 0;
+         features.avx2 = __builtin_cpu_supports("avx2") != 0;
+         features.bmi2 = __builtin_cpu_supports("bmi2") != 0;
+#endif
+         return features;
+      }
+
+   }
+
+   //! \brief The features of the CPU this program runs on. They are detected once on first use
+   inline const CpuFeatures& GetCpuFeatures()
+   {
+      static const CpuFeatures features = detail::DetectCpuFeatures();
+      return features;
+   }
+
+}
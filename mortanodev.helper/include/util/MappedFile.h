@@ -0,0 +1,161 @@
+#pragma once
+#include <cerrno>
+#include <stddef.h>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "Compiler.h"
+
+#if defined(_WIN32)
+// Keep the min/max macros and the rarely used parts of windows.h out of every file that includes this header
+#ifndef NOMINMAX
+#define NOMINMAX
+#define MDV_MAPPEDFILE_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define MDV_MAPPEDFILE_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef MDV_MAPPEDFILE_NOMINMAX
+#undef NOMINMAX
+#undef MDV_MAPPEDFILE_NOMINMAX
+#endif
+#ifdef MDV_MAPPEDFILE_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef MDV_MAPPEDFILE_LEAN_AND_MEAN
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mdv
+{
+
+   //! \brief Read-only memory mapping of a whole file. The pages are loaded lazily by the operating system when they
+   //!        are first accessed, so opening even a huge file is cheap
+   class MappedFile
+   {
+   public:
+      //! \brief Maps the file at the given path
+      //! \throws std::system_error if the file can't be opened or mapped
+      explicit MappedFile(const std::string& path) :
+         _data(nullptr),
+         _size(0)
+      {
+#if defined(_WIN32)
+         const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+         if (file == INVALID_HANDLE_VALUE)
+            ThrowError(GetLastError(), "Could not open " + path);
+
+         LARGE_INTEGER size;
+         if (!GetFileSizeEx(file, &size))
+         {
+            const auto error = GetLastError();
+            CloseHandle(file);
+            ThrowError(error, "Could not get the size of " + path);
+         }
+         _size = static_cast<size_t>(size.QuadPart);
+
+         //Empty files can't be mapped, they are represented by a null pointer
+         if (_size != 0)
+         {
+            //The mapping keeps the file open, and the view keeps the mapping alive
+            const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const auto mappingError = GetLastError();
+            CloseHandle(file);
+            if (!mapping)
+               ThrowError(mappingError, "Could not map " + path);
+            _data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            const auto viewError = GetLastError();
+            CloseHandle(mapping);
+            if (!_data)
+               ThrowError(viewError, "Could not map " + path);
+         }
+         else
+         {
+            CloseHandle(file);
+         }
+#else
+         const auto file = open(path.c_str(), O_RDONLY);
+         if (file < 0)
+            ThrowError(errno, "Could not open " + path);
+
+         struct stat status;
+         if (fstat(file, &status) != 0)
+         {
+            const auto error = errno;
+            close(file);
+            ThrowError(error, "Could not get the size of " + path);
+         }
+         _size = static_cast<size_t>(status.st_size);
+
+         if (_size != 0)
+         {
+            //The mapping stays valid after the file is closed
+            const auto data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, file, 0);
+            const auto error = errno;
+            close(file);
+            if (data == MAP_FAILED)
+               ThrowError(error, "Could not map " + path);
+            _data = data;
+         }
+         else
+         {
+            close(file);
+         }
+#endif
+      }
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      MappedFile(MappedFile&& other) noexcept :
+         _data(other._data),
+         _size(other._size)
+      {
+         other._data = nullptr;
+         other._size = 0;
+      }
+
+      MappedFile& operator=(MappedFile&& other) noexcept
+      {
+         std::swap(_data, other._data);
+         std::swap(_size, other._size);
+         return *this;
+      }
+
+      ~MappedFile()
+      {
+         if (!_data)
+            return;
+#if defined(_WIN32)
+         UnmapViewOfFile(_data);
+#else
+         munmap(_data, _size);
+#endif
+      }
+
+      //! \brief The contents of the file. The mapping starts at a page boundary
+      const void* Data() const { return _data; }
+
+      //! \brief Size of the file in bytes
+      size_t Size() const { return _size; }
+
+   private:
+      template<typename Error_t>
+      MDV_NORETURN static void ThrowError(Error_t error, const std::string& message)
+      {
+         throw std::system_error(static_cast<int>(error), std::system_category(), message);
+      }
+
+      void* _data;
+      size_t _size;
+   };
+
+}
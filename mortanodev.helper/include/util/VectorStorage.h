@@ -0,0 +1,47 @@
+#pragma once
+
+#include <type_traits>
+
+namespace mdv
+{
+   namespace detail
+   {
+
+      //! \brief A bool that is stored in a byte of its own. std::vector<bool> packs its elements into bits, so there
+      //!        are no references or pointers to them, which the containers need
+      struct BoolStorage
+      {
+         bool value;
+
+         BoolStorage() = default;
+         BoolStorage(bool val) : value(val) {}
+      };
+
+      static_assert(sizeof(BoolStorage) == sizeof(bool) && std::is_standard_layout<BoolStorage>::value,
+         "BoolStorage must have the layout of a bool!");
+
+      //! \brief Element type under which a container stores values of type T in a std::vector, and the conversion
+      //!        of a pointer to the stored elements into a pointer to the values
+      template<typename T>
+      struct VectorStorage
+      {
+         using type = T;
+
+         static T* Data(T* data) { return data; }
+         static const T* Data(const T* data) { return data; }
+      };
+
+      template<>
+      struct VectorStorage<bool>
+      {
+         using type = BoolStorage;
+
+         static bool* Data(BoolStorage* data) { return reinterpret_cast<bool*>(data); }
+         static const bool* Data(const BoolStorage* data) { return reinterpret_cast<const bool*>(data); }
+      };
+
+      template<typename T>
+      using VectorStorage_t = typename VectorStorage<T>::type;
+
+   }
+}